@@ -22,7 +22,9 @@
 #include "fdbclient/BlobGranuleFiles.h"
 #include "fdbclient/FDBTypes.h"
 #include "flow/ProtocolVersion.h"
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
 #define FDB_USE_LATEST_API_VERSION
 #define FDB_INCLUDE_LEGACY_TYPES
 
@@ -231,6 +233,136 @@ extern "C" DLLEXPORT fdb_error_t fdb_future_set_callback(FDBFuture* f,
 	CATCH_AND_RETURN(TSAVB(f)->callOrSetAsCallback(cb, ignore, 0););
 }
 
+namespace {
+
+// Collects the futures registered with an FDBCompletionQueue as they become ready. The network thread only appends to
+// the list of completions under a short lock, and application threads take them off in batches, so neither side pays
+// for a thread hop or an allocation per future once the queue has warmed up.
+class CompletionQueue : public ThreadSafeReferenceCounted<CompletionQueue> {
+public:
+	// The callback of one registered future. Each registration holds a reference to the queue, and callbacks are
+	// reused for later registrations once they have fired.
+	class Registration final : public ThreadCallback {
+	public:
+		bool canFire(int notMadeActive) const override { return true; }
+		void fire(const Void& unused, int& userParam) override { queue->complete(this, true); }
+		void error(const Error&, int& userParam) override { queue->complete(this, true); }
+		// Called if the future is destroyed without ever becoming ready
+		void destroy() override { queue->complete(this, false); }
+
+	private:
+		friend class CompletionQueue;
+		CompletionQueue* queue;
+		FDBCompletion completion;
+		Registration* nextFree;
+	};
+
+	~CompletionQueue() {
+		while (freeList) {
+			Registration* r = freeList;
+			freeList = r->nextFree;
+			delete r;
+		}
+	}
+
+	Registration* registration(FDBFuture* f, uint64_t tag) {
+		Registration* r;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			r = freeList;
+			if (r) {
+				freeList = r->nextFree;
+			}
+		}
+		if (!r) {
+			r = new Registration();
+		}
+		r->queue = this;
+		r->completion.future = f;
+		r->completion.tag = tag;
+		addref();
+		return r;
+	}
+
+	// Takes up to max completions, waiting up to timeout seconds (forever if negative) for the first one
+	int wait(FDBCompletion* out, int max, double timeout) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (next == completed.size() && timeout != 0) {
+			auto isReady = [this]() { return next < completed.size(); };
+			++waiters;
+			if (timeout < 0) {
+				ready.wait(lock, isReady);
+			} else {
+				ready.wait_for(lock, std::chrono::duration<double>(timeout), isReady);
+			}
+			--waiters;
+		}
+
+		int count = std::min<size_t>(max, completed.size() - next);
+		std::copy(completed.begin() + next, completed.begin() + next + count, out);
+		next += count;
+		if (next == completed.size()) {
+			completed.clear();
+			next = 0;
+		}
+		return count;
+	}
+
+private:
+	void complete(Registration* r, bool fired) {
+		bool notify = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (fired) {
+				completed.push_back(r->completion);
+				notify = waiters > 0;
+			}
+			r->nextFree = freeList;
+			freeList = r;
+		}
+		if (notify) {
+			ready.notify_one();
+		}
+		delref();
+	}
+
+	std::mutex mutex;
+	std::condition_variable ready;
+	std::vector<FDBCompletion> completed;
+	size_t next = 0; // The first completion in completed which has not been taken yet
+	int waiters = 0;
+	Registration* freeList = nullptr;
+};
+
+} // namespace
+
+#define COMPLETION_QUEUE(q) ((CompletionQueue*)(q))
+
+extern "C" DLLEXPORT fdb_error_t fdb_create_completion_queue(FDBCompletionQueue** out_queue) {
+	CATCH_AND_RETURN(*out_queue = (FDBCompletionQueue*)new CompletionQueue(););
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_completion_queue_register(FDBCompletionQueue* q, FDBFuture* f, uint64_t tag) {
+	CompletionQueue::Registration* r = COMPLETION_QUEUE(q)->registration(f, tag);
+	int ignore;
+	CATCH_AND_RETURN(TSAVB(f)->callOrSetAsCallback(r, ignore, 0););
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_completion_queue_wait(FDBCompletionQueue* q,
+                                                           FDBCompletion* out_completions,
+                                                           int max_completions,
+                                                           double timeout,
+                                                           int* out_count) {
+	if (timeout != 0 && g_network && g_network->isOnMainThread()) {
+		return error_code_blocked_from_network_thread;
+	}
+	CATCH_AND_RETURN(*out_count = COMPLETION_QUEUE(q)->wait(out_completions, std::max(max_completions, 0), timeout););
+}
+
+extern "C" DLLEXPORT void fdb_completion_queue_destroy(FDBCompletionQueue* q) {
+	CATCH_AND_DIE(COMPLETION_QUEUE(q)->delref(););
+}
+
 fdb_error_t fdb_future_get_error_impl(FDBFuture* f) {
 	return TSAVB(f)->getErrorCode();
 }
@@ -302,6 +434,55 @@ fdb_error_t fdb_future_get_keyvalue_array_v13(FDBFuture* f, FDBKeyValue const**
 	                 *out_count = rrr.size(););
 }
 
+namespace {
+
+// Lays out kvs in buffer as described for fdb_future_copy_keyvalue_array() if it fits, returning the size of the layout
+int copyKeyValueArray(RangeResultRef const& kvs, uint8_t* buffer, int bufferLength) {
+	int offsetsLength = sizeof(uint32_t) * (2 * kvs.size() + 1);
+	int64_t length = offsetsLength;
+	for (auto const& kv : kvs) {
+		length += kv.key.size() + kv.value.size();
+	}
+	if (length > std::numeric_limits<int>::max()) {
+		throw client_invalid_operation();
+	}
+	if (buffer == nullptr || bufferLength < length) {
+		return length;
+	}
+
+	// The buffer comes from the application and may not be aligned for uint32_t
+	uint8_t* data = buffer + offsetsLength;
+	uint32_t offset = 0;
+	auto appendOffset = [&buffer, &offset]() {
+		memcpy(buffer, &offset, sizeof(offset));
+		buffer += sizeof(offset);
+	};
+	for (auto const& kv : kvs) {
+		appendOffset();
+		memcpy(data + offset, kv.key.begin(), kv.key.size());
+		offset += kv.key.size();
+		appendOffset();
+		memcpy(data + offset, kv.value.begin(), kv.value.size());
+		offset += kv.value.size();
+	}
+	appendOffset();
+	return length;
+}
+
+} // namespace
+
+extern "C" DLLEXPORT fdb_error_t fdb_future_copy_keyvalue_array(FDBFuture* f,
+                                                                uint8_t* buffer,
+                                                                int buffer_length,
+                                                                int* out_length,
+                                                                int* out_count,
+                                                                fdb_bool_t* out_more) {
+	CATCH_AND_RETURN(Standalone<RangeResultRef> rrr = TSAV(Standalone<RangeResultRef>, f)->get();
+	                 *out_length = copyKeyValueArray(rrr, buffer, buffer_length);
+	                 *out_count = rrr.size();
+	                 *out_more = rrr.more;);
+}
+
 extern "C" DLLEXPORT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                      FDBMappedKeyValue const** out_kvm,
                                                                      int* out_count,
@@ -1133,6 +1314,153 @@ FDBFuture* fdb_transaction_get_range_v13(FDBTransaction* tr,
 	    limit);
 }
 
+namespace {
+
+// The reads of an FDBRangeIterator. Once the first batch has been requested this is only used by the continuation of
+// each batch, and those run one after another, so it needs no locking.
+struct RangeIteratorReads : ThreadSafeReferenceCounted<RangeIteratorReads> {
+	Reference<ITransaction> tr;
+	KeySelector begin;
+	KeySelector end;
+	int limit; // Rows left to read, or 0 if unlimited
+	int targetBytes;
+	FDBStreamingMode mode;
+	int iteration = 1;
+	bool snapshot;
+	bool reverse;
+
+	ThreadFuture<RangeResult> read() {
+		int batchLimit = limit;
+		int batchBytes = targetBytes;
+		fdb_bool_t batchReverse = reverse;
+		FDBFuture* error = validate_and_update_parameters(batchLimit, batchBytes, mode, iteration, batchReverse);
+		if (error != nullptr) {
+			return ThreadFuture<RangeResult>(TSAV(RangeResult, error));
+		}
+		return tr->getRange(begin, end, GetRangeLimits(batchLimit, batchBytes), snapshot, batchReverse);
+	}
+
+	// Moves past a batch that has arrived, returning false if there is nothing left to read
+	bool advance(RangeResult const& batch) {
+		if (!batch.more || batch.empty()) {
+			return false;
+		}
+		if (limit > 0) {
+			limit -= batch.size();
+			if (limit <= 0) {
+				return false;
+			}
+		}
+		if (reverse) {
+			end = firstGreaterOrEqual(batch.back().key);
+		} else {
+			begin = firstGreaterThan(batch.back().key);
+		}
+		++iteration;
+		return true;
+	}
+};
+
+struct RangeIterator {
+	Reference<RangeIteratorReads> reads;
+	ThreadFuture<RangeResult> nextBatch;
+};
+
+} // namespace
+
+#define RANGE_ITERATOR(it) ((RangeIterator*)it)
+
+extern "C" DLLEXPORT FDBRangeIterator* fdb_transaction_get_range_iterator(FDBTransaction* tr,
+                                                                          uint8_t const* begin_key_name,
+                                                                          int begin_key_name_length,
+                                                                          fdb_bool_t begin_or_equal,
+                                                                          int begin_offset,
+                                                                          uint8_t const* end_key_name,
+                                                                          int end_key_name_length,
+                                                                          fdb_bool_t end_or_equal,
+                                                                          int end_offset,
+                                                                          int limit,
+                                                                          int target_bytes,
+                                                                          FDBStreamingMode mode,
+                                                                          fdb_bool_t snapshot,
+                                                                          fdb_bool_t reverse) {
+	auto reads = makeReference<RangeIteratorReads>();
+	reads->tr = Reference<ITransaction>::addRef(TXN(tr));
+	reads->begin = KeySelectorRef(KeyRef(begin_key_name, begin_key_name_length), begin_or_equal, begin_offset);
+	reads->end = KeySelectorRef(KeyRef(end_key_name, end_key_name_length), end_or_equal, end_offset);
+	reads->limit = std::max(limit, 0);
+	reads->targetBytes = target_bytes;
+	reads->mode = mode;
+	reads->snapshot = snapshot;
+	reads->reverse = reverse;
+
+	RangeIterator* it = new RangeIterator();
+	it->nextBatch = reads->read();
+	it->reads = std::move(reads);
+	return (FDBRangeIterator*)it;
+}
+
+extern "C" DLLEXPORT FDBFuture* fdb_range_iterator_next(FDBRangeIterator* it) {
+	RangeIterator* iterator = RANGE_ITERATOR(it);
+	ThreadFuture<RangeResult> batch = iterator->nextBatch;
+	Reference<RangeIteratorReads> reads = iterator->reads;
+
+	// Chain the read of the following batch onto this one, so that it starts as soon as this one arrives
+	iterator->nextBatch = flatMapThreadFuture<RangeResult, RangeResult>(
+	    batch, [reads](ErrorOr<RangeResult> result) -> ErrorOr<ThreadFuture<RangeResult>> {
+		    if (result.isError()) {
+			    return result.getError();
+		    }
+		    if (!reads->advance(result.get())) {
+			    return ThreadFuture<RangeResult>(RangeResult());
+		    }
+		    return reads->read();
+	    });
+
+	return (FDBFuture*)batch.extractPtr();
+}
+
+extern "C" DLLEXPORT void fdb_range_iterator_destroy(FDBRangeIterator* it) {
+	CATCH_AND_DIE(RangeIterator* iterator = RANGE_ITERATOR(it); iterator->nextBatch.cancel(); delete iterator;);
+}
+
+namespace {
+
+struct ReadSnapshot {
+	// The transaction that obtained the version. It is kept so that fdb_read_snapshot_get_version() can hand out
+	// futures which the caller may destroy (and so cancel) without affecting the snapshot.
+	Reference<ITransaction> tr;
+	ThreadFuture<Version> version;
+};
+
+} // namespace
+
+#define READ_SNAPSHOT(s) ((ReadSnapshot*)s)
+
+extern "C" DLLEXPORT fdb_error_t fdb_database_create_read_snapshot(FDBDatabase* d, FDBReadSnapshot** out_snapshot) {
+	CATCH_AND_RETURN(Reference<ITransaction> tr = DB(d)->createTransaction();
+	                 ReadSnapshot* snapshot = new ReadSnapshot();
+	                 snapshot->version = tr->getReadVersion();
+	                 snapshot->tr = std::move(tr);
+	                 *out_snapshot = (FDBReadSnapshot*)snapshot;);
+}
+
+extern "C" DLLEXPORT FDBFuture* fdb_read_snapshot_get_version(FDBReadSnapshot* snapshot) {
+	return (FDBFuture*)(READ_SNAPSHOT(snapshot)->tr->getReadVersion().extractPtr());
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_transaction_set_read_snapshot(FDBTransaction* tr, FDBReadSnapshot* snapshot) {
+	CATCH_AND_RETURN(ThreadFuture<Version> version = READ_SNAPSHOT(snapshot)->version;
+	                 if (!version.isReady()) throw future_not_set();
+	                 if (version.isError()) throw version.getError();
+	                 TXN(tr)->setVersion(version.get());
+	                 TXN(tr)->setOption(FDBTransactionOptions::RETAIN_READ_VERSION););
+}
+
+extern "C" DLLEXPORT void fdb_read_snapshot_destroy(FDBReadSnapshot* snapshot) {
+	CATCH_AND_DIE(ReadSnapshot* s = READ_SNAPSHOT(snapshot); s->version.cancel(); delete s;);
+}
+
 extern "C" DLLEXPORT void fdb_transaction_set(FDBTransaction* tr,
                                               uint8_t const* key_name,
                                               int key_name_length,
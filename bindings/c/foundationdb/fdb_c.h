@@ -295,6 +295,29 @@ DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_set_callback(FDBFuture* f,
                                                                  FDBCallback callback,
                                                                  void* callback_parameter);
 
+/* A queue of ready futures which application threads drain in batches, as an alternative to a callback per future
+   called on the network thread. A registered future must not be destroyed until it has been taken off the queue. */
+typedef struct completion {
+	FDBFuture* future;
+	uint64_t tag;
+} FDBCompletion;
+
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_create_completion_queue(FDBCompletionQueue** out_queue);
+
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_completion_queue_register(FDBCompletionQueue* queue,
+                                                                       FDBFuture* f,
+                                                                       uint64_t tag);
+
+/* Takes up to max_completions ready futures off the queue, waiting up to timeout seconds for the first one if none are
+   ready. A negative timeout waits indefinitely and a zero timeout never waits. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_completion_queue_wait(FDBCompletionQueue* queue,
+                                                                   FDBCompletion* out_completions,
+                                                                   int max_completions,
+                                                                   double timeout,
+                                                                   int* out_count);
+
+DLLEXPORT void fdb_completion_queue_destroy(FDBCompletionQueue* queue);
+
 #if FDB_API_VERSION >= 23
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_error(FDBFuture* f);
 #endif
@@ -321,6 +344,18 @@ DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_array(FDBFuture
                                                                        fdb_bool_t* out_more);
 #endif
 
+/* Copies the key-value pairs of a range read into buffer as one contiguous block that bindings can wrap without
+   copying each key and value. The block holds 2 * count + 1 native-endian uint32_t offsets followed by the key and
+   value bytes: key i is bytes [offsets[2i], offsets[2i+1]) and value i is bytes [offsets[2i+1], offsets[2i+2]) of the
+   data after the offsets. *out_length is always set to the size of the block, and nothing is copied if buffer is NULL
+   or buffer_length is smaller than that. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_copy_keyvalue_array(FDBFuture* f,
+                                                                        uint8_t* buffer,
+                                                                        int buffer_length,
+                                                                        int* out_length,
+                                                                        int* out_count,
+                                                                        fdb_bool_t* out_more);
+
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                              FDBMappedKeyValue const** out_kv,
                                                                              int* out_count,
@@ -595,6 +630,48 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_mapped_range(FDBTran
                                                                          fdb_bool_t snapshot,
                                                                          fdb_bool_t reverse);
 
+/* Reads a range in batches, issuing the read of each batch as soon as the previous one has arrived so that it is
+   usually ready by the time the application has consumed the previous one. limit, target_bytes and mode apply as in
+   fdb_transaction_get_range(), with FDB_STREAMING_MODE_ITERATOR advancing its iteration on each batch. */
+DLLEXPORT WARN_UNUSED_RESULT FDBRangeIterator* fdb_transaction_get_range_iterator(FDBTransaction* tr,
+                                                                                  uint8_t const* begin_key_name,
+                                                                                  int begin_key_name_length,
+                                                                                  fdb_bool_t begin_or_equal,
+                                                                                  int begin_offset,
+                                                                                  uint8_t const* end_key_name,
+                                                                                  int end_key_name_length,
+                                                                                  fdb_bool_t end_or_equal,
+                                                                                  int end_offset,
+                                                                                  int limit,
+                                                                                  int target_bytes,
+                                                                                  FDBStreamingMode mode,
+                                                                                  fdb_bool_t snapshot,
+                                                                                  fdb_bool_t reverse);
+
+/* Returns a future for the next batch of the iterator, read with fdb_future_get_keyvalue_array() or
+   fdb_future_copy_keyvalue_array(). The last batch has more set to 0. After an error the iterator must be destroyed. */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_range_iterator_next(FDBRangeIterator* it);
+
+/* Cancels the read of any batch that has not arrived yet. */
+DLLEXPORT void fdb_range_iterator_destroy(FDBRangeIterator* it);
+
+/* Obtains a read version once so that it can be shared by many read-only transactions, skipping the per-transaction
+   read version request. Transactions using the snapshot ask storage servers to retain the history needed to read at
+   its version for a bounded time, which may extend the snapshot's lifetime beyond the 5 second MVCC window. Reads
+   fail with transaction_too_old once the snapshot has aged past the bounds configured on the storage servers. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_database_create_read_snapshot(FDBDatabase* d,
+                                                                           FDBReadSnapshot** out_snapshot);
+
+/* Returns a future for the version of the snapshot, read with fdb_future_get_int64(). */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_read_snapshot_get_version(FDBReadSnapshot* snapshot);
+
+/* Makes the transaction read at the version of the snapshot. Fails with future_not_set if the future returned by
+   fdb_read_snapshot_get_version() is not ready yet, or with its error if obtaining the version failed. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_transaction_set_read_snapshot(FDBTransaction* tr,
+                                                                           FDBReadSnapshot* snapshot);
+
+DLLEXPORT void fdb_read_snapshot_destroy(FDBReadSnapshot* snapshot);
+
 DLLEXPORT void fdb_transaction_set(FDBTransaction* tr,
                                    uint8_t const* key_name,
                                    int key_name_length,
@@ -37,6 +37,9 @@ typedef struct FDB_cluster FDBCluster;
 typedef struct FDB_database FDBDatabase;
 typedef struct FDB_tenant FDBTenant;
 typedef struct FDB_transaction FDBTransaction;
+typedef struct FDB_range_iterator FDBRangeIterator;
+typedef struct FDB_completion_queue FDBCompletionQueue;
+typedef struct FDB_read_snapshot FDBReadSnapshot;
 
 typedef int fdb_error_t;
 typedef int fdb_bool_t;
@@ -26,8 +26,10 @@
 #define FDB_USE_LATEST_API_VERSION
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -285,6 +287,26 @@ struct KeyValueRefArray {
 		return Error(err);
 	}
 };
+// Copies a range read result into a thread-local buffer as one contiguous block of offsets followed by data.
+// The block stays valid until the next extraction on the same thread.
+struct KeyValueBlock {
+	using Type = std::tuple<BytesRef, int, bool>;
+	static Error extract(native::FDBFuture* f, Type& out) noexcept {
+		thread_local ByteString buffer;
+		auto& [out_block, out_count, out_more] = out;
+		auto out_more_native = native::fdb_bool_t{};
+		auto length = 0;
+		auto err = native::fdb_future_copy_keyvalue_array(
+		    f, buffer.data(), static_cast<int>(buffer.size()), &length, &out_count, &out_more_native);
+		if (!err && length > static_cast<int>(buffer.size())) {
+			buffer.resize(length);
+			err = native::fdb_future_copy_keyvalue_array(f, buffer.data(), length, &length, &out_count, &out_more_native);
+		}
+		out_block = BytesRef(buffer.data(), length);
+		out_more = (out_more_native != 0);
+		return Error(err);
+	}
+};
 struct KeyRangeRef : native::FDBKeyRange {
 	fdb::KeyRef beginKey() const noexcept { return fdb::KeyRef(native::FDBKeyRange::begin_key, begin_key_length); }
 	fdb::KeyRef endKey() const noexcept { return fdb::KeyRef(native::FDBKeyRange::end_key, end_key_length); }
@@ -482,6 +504,7 @@ class Future {
 protected:
 	friend class Transaction;
 	friend class Database;
+	friend class CompletionQueue;
 	friend std::hash<Future>;
 	std::shared_ptr<native::FDBFuture> f;
 
@@ -598,6 +621,53 @@ public:
 	}
 };
 
+// Runs the completion handlers of futures on the threads which call run(), instead of on the network thread.
+class CompletionQueue {
+	using Handler = std::function<void()>;
+	std::shared_ptr<native::FDBCompletionQueue> q;
+
+public:
+	CompletionQueue() {
+		native::FDBCompletionQueue* queue = nullptr;
+		if (auto err = Error(native::fdb_create_completion_queue(&queue))) {
+			throwError("ERROR: create_completion_queue: ", err);
+		}
+		q = std::shared_ptr<native::FDBCompletionQueue>(queue, &native::fdb_completion_queue_destroy);
+	}
+
+	// set user-defined completion handler of signature void(Future), to be called from run() once f is ready
+	template <class UserFunc>
+	void then(Future f, UserFunc&& fn) {
+		auto handler = new Handler([f, fn = std::forward<UserFunc>(fn)]() { fn(f); });
+		auto tag = reinterpret_cast<uintptr_t>(handler);
+		if (auto err = Error(native::fdb_completion_queue_register(q.get(), f.nativeHandle(), tag))) {
+			delete handler;
+			throwError("ERROR: completion_queue_register: ", err);
+		}
+	}
+
+	// run the handlers of up to max_handlers ready futures, waiting up to timeout seconds for one if none are ready.
+	// returns the number of handlers run.
+	int run(int max_handlers, double timeout) {
+		native::FDBCompletion completions[64];
+		auto count = 0;
+		if (auto err = Error(native::fdb_completion_queue_wait(
+		        q.get(), completions, std::min(max_handlers, 64), timeout, &count))) {
+			throwError("ERROR: completion_queue_wait: ", err);
+		}
+		for (auto i = 0; i < count; i++) {
+			auto handler = reinterpret_cast<Handler*>(static_cast<uintptr_t>(completions[i].tag));
+			try {
+				(*handler)();
+			} catch (const std::exception& e) {
+				fmt::print(stderr, "ERROR: Exception thrown in user callback: {}", e.what());
+			}
+			delete handler;
+		}
+		return count;
+	}
+};
+
 struct KeySelector {
 	const uint8_t* key;
 	int keyLength;
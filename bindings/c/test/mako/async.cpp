@@ -46,13 +46,13 @@ void ResumableStateForPopulate::runOneTick() {
 		stats.incrOpCount(OP_INSERT);
 		if (i == key_end || (i - key_begin + 1) % num_commit_every == 0) {
 			watch_commit.start();
-			tx.commit().then([this, state = shared_from_this(), i](Future f) {
+			onReady(completion_queue, tx.commit(), [this, state = shared_from_this(), i](Future f) {
 				if (auto err = f.error()) {
 					logr.printWithLogLevel(err.retryable() ? VERBOSE_WARN : VERBOSE_NONE,
 					                       "ERROR",
 					                       "commit for populate returned '{}'",
 					                       err.what());
-					tx.onError(err).then([this, state = shared_from_this()](Future f) {
+					onReady(completion_queue, tx.onError(err), [this, state = shared_from_this()](Future f) {
 						const auto f_rc = handleForOnError(tx, f, "ON_ERROR_FOR_POPULATE");
 						if (f_rc == FutureRC::ABORT) {
 							signalEnd();
@@ -121,7 +121,7 @@ repeat_immediate_steps:
 			goto repeat_immediate_steps;
 	} else {
 		// step is blocking. register a continuation and return
-		f.then([this, state = shared_from_this()](Future f) {
+		onReady(completion_queue, f, [this, state = shared_from_this()](Future f) {
 			if (auto postStepFn = opTable[iter.op].postStepFunction(iter.step))
 				postStepFn(f, tx, args, key1, key2, val);
 			if (iter.stepKind() != StepKind::ON_ERROR) {
@@ -133,7 +133,7 @@ repeat_immediate_steps:
 					                       iter.step,
 					                       err.what());
 					updateErrorStats(err, iter.op);
-					tx.onError(err).then([this, state = shared_from_this()](Future f) {
+					onReady(completion_queue, tx.onError(err), [this, state = shared_from_this()](Future f) {
 						const auto rc = handleForOnError(
 						    tx, f, fmt::format("{}:{}", iter.opName(), iter.step), args.isAnyTimeoutEnabled());
 						onIterationEnd(rc);
@@ -191,7 +191,7 @@ void ResumableStateForRunWorkload::onTransactionSuccess() {
 	if (needs_commit || args.commit_get) {
 		// task completed, need to commit before finish
 		watch_commit.start();
-		tx.commit().then([this, state = shared_from_this()](Future f) {
+		onReady(completion_queue, tx.commit(), [this, state = shared_from_this()](Future f) {
 			if (auto err = f.error()) {
 				// commit had errors
 				logr.printWithLogLevel(isExpectedError(err) ? VERBOSE_WARN : VERBOSE_NONE,
@@ -199,7 +199,7 @@ void ResumableStateForRunWorkload::onTransactionSuccess() {
 				                       "Post-iteration commit returned error: {}",
 				                       err.what());
 				updateErrorStats(err, OP_COMMIT);
-				tx.onError(err).then([this, state = shared_from_this()](Future f) {
+				onReady(completion_queue, tx.onError(err), [this, state = shared_from_this()](Future f) {
 					const auto rc = handleForOnError(tx, f, "ON_ERROR", args.isAnyTimeoutEnabled());
 					onIterationEnd(rc);
 				});
@@ -33,6 +33,15 @@
 
 namespace mako {
 
+// Calls fn(f) once f is ready, from the threads draining completion_queue if there is one or on the network thread
+template <class UserFunc>
+void onReady(fdb::CompletionQueue* completion_queue, fdb::Future f, UserFunc&& fn) {
+	if (completion_queue)
+		completion_queue->then(f, std::forward<UserFunc>(fn));
+	else
+		f.then(std::forward<UserFunc>(fn));
+}
+
 // as we don't have coroutines yet, we need to store in heap the complete state of execution,
 // such that we can resume exactly where we were from last database op.
 struct ResumableStateForPopulate : std::enable_shared_from_this<ResumableStateForPopulate> {
@@ -43,6 +52,7 @@ struct ResumableStateForPopulate : std::enable_shared_from_this<ResumableStateFo
 	Arguments const& args;
 	WorkflowStatistics& stats;
 	std::atomic<int>& stopcount;
+	fdb::CompletionQueue* completion_queue;
 	int key_begin;
 	int key_end;
 	int key_checkpoint;
@@ -59,10 +69,11 @@ struct ResumableStateForPopulate : std::enable_shared_from_this<ResumableStateFo
 	                          Arguments const& args,
 	                          WorkflowStatistics& stats,
 	                          std::atomic<int>& stopcount,
+	                          fdb::CompletionQueue* completion_queue,
 	                          int key_begin,
 	                          int key_end)
 	  : logr(logr), db(db), tx(tx), io_context(io_context), args(args), stats(stats), stopcount(stopcount),
-	    key_begin(key_begin), key_end(key_end), key_checkpoint(key_begin) {
+	    completion_queue(completion_queue), key_begin(key_begin), key_end(key_end), key_checkpoint(key_begin) {
 		keystr.resize(args.key_length);
 		valstr.resize(args.value_length);
 	}
@@ -82,6 +93,7 @@ struct ResumableStateForRunWorkload : std::enable_shared_from_this<ResumableStat
 	WorkflowStatistics& stats;
 	int64_t total_xacts;
 	std::atomic<int>& stopcount;
+	fdb::CompletionQueue* completion_queue;
 	std::atomic<int> const& signal;
 	int max_iters;
 	OpIterator iter;
@@ -101,11 +113,13 @@ struct ResumableStateForRunWorkload : std::enable_shared_from_this<ResumableStat
 	                             Arguments const& args,
 	                             WorkflowStatistics& stats,
 	                             std::atomic<int>& stopcount,
+	                             fdb::CompletionQueue* completion_queue,
 	                             std::atomic<int> const& signal,
 	                             int max_iters,
 	                             OpIterator iter)
 	  : logr(logr), db(db), tx(tx), io_context(io_context), args(args), stats(stats), total_xacts(0),
-	    stopcount(stopcount), signal(signal), max_iters(max_iters), iter(iter), needs_commit(false) {
+	    stopcount(stopcount), completion_queue(completion_queue), signal(signal), max_iters(max_iters), iter(iter),
+	    needs_commit(false) {
 		key1.resize(args.key_length);
 		key2.resize(args.key_length);
 		val.resize(args.value_length);
@@ -564,6 +564,7 @@ void runAsyncWorkload(Arguments const& args,
                       int process_idx,
                       shared_memory::Access shm,
                       boost::asio::io_context& io_context,
+                      fdb::CompletionQueue* completion_queue,
                       std::vector<Database>& databases) {
 	auto dump_samples = [&args, pid_main, process_idx](auto&& states) {
 		auto overwrite = true; /* overwrite or append */
@@ -587,6 +588,7 @@ void runAsyncWorkload(Arguments const& args,
 			                                                args,
 			                                                shm.workerStatsSlot(process_idx, i),
 			                                                stopcount,
+			                                                completion_queue,
 			                                                key_begin,
 			                                                key_end);
 			state->watch_tx.start();
@@ -620,6 +622,7 @@ void runAsyncWorkload(Arguments const& args,
 			                                                   args,
 			                                                   shm.workerStatsSlot(process_idx, i),
 			                                                   stopcount,
+			                                                   completion_queue,
 			                                                   shm.headerConst().signal,
 			                                                   max_iters,
 			                                                   getOpBegin(args));
@@ -800,14 +803,26 @@ int workerProcessMain(Arguments const& args, int process_idx, shared_memory::Acc
 		auto ctx = boost::asio::io_context{};
 		using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
 		auto wg = WorkGuard(ctx.get_executor());
+		// with --completion_queue, worker threads alternate between posted ticks and ready futures
+		auto completion_queue = std::optional<fdb::CompletionQueue>{};
+		if (args.completion_queue)
+			completion_queue.emplace();
+		auto workload_done = std::atomic<bool>{ false };
 		auto worker_threads = std::vector<std::thread>(args.num_threads);
 		for (auto i = 0; i < args.num_threads; i++) {
-			worker_threads[i] = std::thread([&ctx, &args, process_idx, i, shm]() {
+			worker_threads[i] = std::thread([&ctx, &args, &completion_queue, &workload_done, process_idx, i, shm]() {
 				shm.threadStatsSlot(process_idx, i).startThreadTimer();
 
 				logr = Logger(WorkerProcess{}, args.verbose, process_idx);
 				logr.debug("Async-mode worker thread {} started", i + 1);
-				ctx.run();
+				if (completion_queue) {
+					while (!workload_done.load()) {
+						ctx.poll();
+						completion_queue->run(64, 0.001);
+					}
+				} else {
+					ctx.run();
+				}
 				logr.debug("Async-mode worker thread {} finished", i + 1);
 
 				shm.threadStatsSlot(process_idx, i).endThreadTimer();
@@ -819,7 +834,9 @@ int workerProcessMain(Arguments const& args, int process_idx, shared_memory::Acc
 		}
 
 		shm.header().readycount.fetch_add(args.num_threads);
-		runAsyncWorkload(args, pid_main, process_idx, shm, ctx, databases);
+		runAsyncWorkload(
+		    args, pid_main, process_idx, shm, ctx, completion_queue ? &*completion_queue : nullptr, databases);
+		workload_done.store(true);
 		wg.reset();
 		for (auto& thread : worker_threads)
 			thread.join();
@@ -839,6 +856,7 @@ Arguments::Arguments() {
 	num_processes = 1;
 	num_threads = 1;
 	async_xacts = 0;
+	completion_queue = false;
 	mode = MODE_INVALID;
 	rows = 100000;
 	load_factor = 1.0;
@@ -877,6 +895,7 @@ Arguments::Arguments() {
 	client_threads_per_version = 0;
 	disable_client_bypass = false;
 	disable_ryw = 0;
+	range_copy = false;
 	json_output_path[0] = '\0';
 	stats_export_path[0] = '\0';
 	bg_materialize_files = false;
@@ -1141,6 +1160,7 @@ void usage() {
 	printf("%-24s %s\n", "-p, --procs=PROCS", "Specify number of worker processes");
 	printf("%-24s %s\n", "-t, --threads=THREADS", "Specify number of worker threads");
 	printf("%-24s %s\n", "    --async_xacts", "Specify number of concurrent transactions to be run in async mode");
+	printf("%-24s %s\n", "    --completion_queue", "Run async mode continuations from a completion queue");
 	printf("%-24s %s\n", "-r, --rows=ROWS", "Specify number of records");
 	printf("%-24s %s\n", "-l, --load_factor=LOAD_FACTOR", "Specify load factor");
 	printf("%-24s %s\n", "-s, --seconds=SECONDS", "Specify the test duration in seconds\n");
@@ -1176,6 +1196,7 @@ void usage() {
 	printf("%-24s %s\n", "    --flatbuffers", "Use flatbuffers");
 	printf("%-24s %s\n", "    --streaming", "Streaming mode: all (default), iterator, small, medium, large, serial");
 	printf("%-24s %s\n", "    --disable_ryw", "Disable snapshot read-your-writes");
+	printf("%-24s %s\n", "    --range_copy", "Copy range read results out as one contiguous block");
 	printf(
 	    "%-24s %s\n", "    --disable_client_bypass", "Disable client-bypass forcing mako to use multi-version client");
 	printf("%-24s %s\n", "    --json_report=PATH", "Output stats to the specified json file (Default: mako.json)");
@@ -1223,6 +1244,7 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "procs", required_argument, NULL, 'p' },
 			{ "threads", required_argument, NULL, 't' },
 			{ "async_xacts", required_argument, NULL, ARG_ASYNC },
+			{ "completion_queue", no_argument, NULL, ARG_COMPLETION_QUEUE },
 			{ "rows", required_argument, NULL, 'r' },
 			{ "load_factor", required_argument, NULL, 'l' },
 			{ "seconds", required_argument, NULL, 's' },
@@ -1272,6 +1294,7 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "version", no_argument, NULL, ARG_VERSION },
 			{ "disable_client_bypass", no_argument, NULL, ARG_DISABLE_CLIENT_BYPASS },
 			{ "disable_ryw", no_argument, NULL, ARG_DISABLE_RYW },
+			{ "range_copy", no_argument, NULL, ARG_RANGE_COPY },
 			{ "enable_token_based_authorization", no_argument, NULL, ARG_ENABLE_TOKEN_BASED_AUTHORIZATION },
 			{ NULL, 0, NULL, 0 }
 		};
@@ -1366,6 +1389,9 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		case ARG_ASYNC:
 			args.async_xacts = atoi(optarg);
 			break;
+		case ARG_COMPLETION_QUEUE:
+			args.completion_queue = true;
+			break;
 		case ARG_KEYLEN:
 			args.key_length = atoi(optarg);
 			break;
@@ -1486,6 +1512,9 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		case ARG_DISABLE_RYW:
 			args.disable_ryw = 1;
 			break;
+		case ARG_RANGE_COPY:
+			args.range_copy = true;
+			break;
 		case ARG_JSON_REPORT:
 			SET_OPT_ARG_IF_PRESENT();
 			if (!optarg) {
@@ -1609,6 +1638,10 @@ int Arguments::validate() {
 		logr.error("--threads ({}) must be <= --async_xacts", num_threads);
 		return -1;
 	}
+	if (completion_queue && async_xacts == 0) {
+		logr.error("--completion_queue requires --async_xacts");
+		return -1;
+	}
 	if (key_length < 4 /* "mako" */ + row_digits) {
 		logr.error("--keylen must be larger than {} to store \"mako\" prefix "
 		           "and maximum row number",
@@ -2351,6 +2384,7 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "\"num_processes\": %d,", args.num_processes);
 		fmt::fprintf(fp, "\"num_threads\": %d,", args.num_threads);
 		fmt::fprintf(fp, "\"async_xacts\": %d,", args.async_xacts);
+		fmt::fprintf(fp, "\"completion_queue\": %d,", args.completion_queue);
 		fmt::fprintf(fp, "\"mode\": %d,", args.mode);
 		fmt::fprintf(fp, "\"rows\": %d,", args.rows);
 		fmt::fprintf(fp, "\"load_factor\": %lf,", args.load_factor);
@@ -2380,6 +2414,7 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "\"txntagging_prefix\": \"%s\",", args.txntagging_prefix);
 		fmt::fprintf(fp, "\"streaming_mode\": %d,", static_cast<int>(args.streaming_mode));
 		fmt::fprintf(fp, "\"disable_ryw\": %d,", args.disable_ryw);
+		fmt::fprintf(fp, "\"range_copy\": %d,", args.range_copy);
 		fmt::fprintf(fp, "\"transaction_timeout_db\": %d,", args.transaction_timeout_db);
 		fmt::fprintf(fp, "\"transaction_timeout_tx\": %d,", args.transaction_timeout_tx);
 		fmt::fprintf(fp, "\"json_output_path\": \"%s\"", args.json_output_path);
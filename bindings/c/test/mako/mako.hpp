@@ -58,6 +58,7 @@ enum ArgKind {
 	ARG_TENANT_BATCH_SIZE,
 	ARG_TPS,
 	ARG_ASYNC,
+	ARG_COMPLETION_QUEUE,
 	ARG_COMMITGET,
 	ARG_SAMPLING,
 	ARG_VERSION,
@@ -77,6 +78,7 @@ enum ArgKind {
 	ARG_TXNTAGGINGPREFIX,
 	ARG_STREAMING_MODE,
 	ARG_DISABLE_RYW,
+	ARG_RANGE_COPY,
 	ARG_CLIENT_THREADS_PER_VERSION,
 	ARG_DISABLE_CLIENT_BYPASS,
 	ARG_JSON_REPORT,
@@ -159,6 +161,7 @@ struct Arguments {
 	int num_processes;
 	int num_threads;
 	int async_xacts;
+	bool completion_queue;
 	int mode;
 	int rows; /* is 2 billion enough? */
 	double load_factor;
@@ -196,6 +199,7 @@ struct Arguments {
 	int64_t client_threads_per_version;
 	bool disable_client_bypass;
 	int disable_ryw;
+	bool range_copy;
 	char json_output_path[PATH_MAX];
 	bool bg_materialize_files;
 	char bg_file_path[PATH_MAX];
@@ -70,9 +70,13 @@ const std::array<Operation, MAX_OP> opTable{
 	                          args.txnspec.ops[OP_GETRANGE][OP_REVERSE])
 	                .eraseType();
 	        },
-	        [](Future& f, Transaction&, Arguments const&, ByteString&, ByteString&, ByteString& val) {
+	        [](Future& f, Transaction&, Arguments const& args, ByteString&, ByteString&, ByteString& val) {
 	            if (f && !f.error()) {
-		            f.get<future_var::KeyValueRefArray>();
+		            if (args.range_copy) {
+			            f.get<future_var::KeyValueBlock>();
+		            } else {
+			            f.get<future_var::KeyValueRefArray>();
+		            }
 	            }
 	        } } },
 	    1,
@@ -105,9 +109,13 @@ const std::array<Operation, MAX_OP> opTable{
 	                          args.txnspec.ops[OP_GETRANGE][OP_REVERSE])
 	                .eraseType();
 	        },
-	        [](Future& f, Transaction&, Arguments const&, ByteString&, ByteString&, ByteString& val) {
+	        [](Future& f, Transaction&, Arguments const& args, ByteString&, ByteString&, ByteString& val) {
 	            if (f && !f.error()) {
-		            f.get<future_var::KeyValueRefArray>();
+		            if (args.range_copy) {
+			            f.get<future_var::KeyValueBlock>();
+		            } else {
+			            f.get<future_var::KeyValueRefArray>();
+		            }
 	            }
 	        } } },
 	    1,
@@ -255,6 +255,47 @@ int interleavedSetsGets(FDBTransaction* tr, struct ResultSet* rs) {
 	return 10000 / (end - start);
 }
 
+int blindSetsGetRange(FDBTransaction* tr, struct ResultSet* rs) {
+	int count;
+	const FDBKeyValue* kvs;
+	int more;
+	int i;
+
+	uint8_t* v = (uint8_t*)"bar";
+
+	double start = getTime();
+	for (i = 0; i < numKeys; ++i) {
+		fdb_transaction_set(tr, keys[rand() % numKeys], keySize, v, 3);
+	}
+
+	FDBFuture* f = fdb_transaction_get_range(tr,
+	                                         FDB_KEYSEL_LAST_LESS_OR_EQUAL(keys[0], keySize),
+	                                         FDB_KEYSEL_LAST_LESS_OR_EQUAL(keys[numKeys], keySize),
+	                                         numKeys,
+	                                         0,
+	                                         0,
+	                                         1,
+	                                         0,
+	                                         0);
+
+	if (getError(fdb_future_block_until_ready(f), "BlindSetsGetRange (block for get range)", rs))
+		return -1;
+	if (getError(fdb_future_get_keyvalue_array(f, &kvs, &count, &more), "BlindSetsGetRange (get range results)", rs))
+		return -1;
+
+	fdb_future_destroy(f);
+	double end = getTime();
+
+	if (count != numKeys) {
+		fprintf(stderr, "Bad count %d (expected %d)\n", count, numKeys);
+		addError(rs, "BlindSetsGetRange bad count");
+		return -1;
+	}
+
+	insertData(tr);
+	return numKeys / (end - start);
+}
+
 void runTests(struct ResultSet* rs) {
 	FDBDatabase* db = openDatabase(rs, &netThread);
 
@@ -276,6 +317,7 @@ void runTests(struct ResultSet* rs) {
 	runTest(&singleClearGetRange, tr, rs, "C: get range cached values with clears throughput");
 	runTest(&clearRangeGetRange, tr, rs, "C: get range cached values with clear ranges throughput");
 	runTest(&interleavedSetsGets, tr, rs, "C: interleaved sets and gets on a single key throughput");
+	runTest(&blindSetsGetRange, tr, rs, "C: unordered sets followed by a get range throughput");
 
 	fdb_transaction_destroy(tr);
 	fdb_database_destroy(db);
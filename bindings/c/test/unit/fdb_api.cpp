@@ -42,6 +42,10 @@ bool Future::is_ready() {
 	return fdb_future_set_callback(future_, callback, callback_parameter);
 }
 
+[[nodiscard]] fdb_error_t Future::register_with(FDBCompletionQueue* queue, uint64_t tag) {
+	return fdb_completion_queue_register(queue, future_, tag);
+}
+
 [[nodiscard]] fdb_error_t Future::get_error() {
 	return fdb_future_get_error(future_);
 }
@@ -102,6 +106,14 @@ void Future::cancel() {
 	return fdb_future_get_keyvalue_array(future_, out_kv, out_count, out_more);
 }
 
+[[nodiscard]] fdb_error_t KeyValueArrayFuture::copy(uint8_t* buffer,
+                                                    int buffer_length,
+                                                    int* out_length,
+                                                    int* out_count,
+                                                    fdb_bool_t* out_more) {
+	return fdb_future_copy_keyvalue_array(future_, buffer, buffer_length, out_length, out_count, out_more);
+}
+
 // MappedKeyValueArrayFuture
 
 [[nodiscard]] fdb_error_t MappedKeyValueArrayFuture::get(const FDBMappedKeyValue** out_kv,
@@ -121,6 +133,33 @@ Result::~Result() {
 	return fdb_result_get_keyvalue_array(result_, out_kv, out_count, out_more);
 }
 
+// RangeIterator
+
+RangeIterator::~RangeIterator() {
+	fdb_range_iterator_destroy(it_);
+}
+
+KeyValueArrayFuture RangeIterator::next() {
+	return KeyValueArrayFuture(fdb_range_iterator_next(it_));
+}
+
+// ReadSnapshot
+
+ReadSnapshot::ReadSnapshot(FDBDatabase* db) {
+	if (fdb_error_t err = fdb_database_create_read_snapshot(db, &snapshot_)) {
+		std::cerr << fdb_get_error(err) << std::endl;
+		std::abort();
+	}
+}
+
+ReadSnapshot::~ReadSnapshot() {
+	fdb_read_snapshot_destroy(snapshot_);
+}
+
+Int64Future ReadSnapshot::get_version() {
+	return Int64Future(fdb_read_snapshot_get_version(snapshot_));
+}
+
 // Database
 Int64Future Database::reboot_worker(FDBDatabase* db,
                                     const uint8_t* address,
@@ -229,6 +268,10 @@ void Transaction::set_read_version(int64_t version) {
 	fdb_transaction_set_read_version(tr_, version);
 }
 
+fdb_error_t Transaction::set_read_snapshot(ReadSnapshot& snapshot) {
+	return fdb_transaction_set_read_snapshot(tr_, snapshot.snapshot_);
+}
+
 Int64Future Transaction::get_read_version() {
 	return Int64Future(fdb_transaction_get_read_version(tr_));
 }
@@ -296,6 +339,35 @@ KeyValueArrayFuture Transaction::get_range(const uint8_t* begin_key_name,
 	                                                     reverse));
 }
 
+RangeIterator Transaction::get_range_iterator(const uint8_t* begin_key_name,
+                                              int begin_key_name_length,
+                                              fdb_bool_t begin_or_equal,
+                                              int begin_offset,
+                                              const uint8_t* end_key_name,
+                                              int end_key_name_length,
+                                              fdb_bool_t end_or_equal,
+                                              int end_offset,
+                                              int limit,
+                                              int target_bytes,
+                                              FDBStreamingMode mode,
+                                              fdb_bool_t snapshot,
+                                              fdb_bool_t reverse) {
+	return RangeIterator(fdb_transaction_get_range_iterator(tr_,
+	                                                        begin_key_name,
+	                                                        begin_key_name_length,
+	                                                        begin_or_equal,
+	                                                        begin_offset,
+	                                                        end_key_name,
+	                                                        end_key_name_length,
+	                                                        end_or_equal,
+	                                                        end_offset,
+	                                                        limit,
+	                                                        target_bytes,
+	                                                        mode,
+	                                                        snapshot,
+	                                                        reverse));
+}
+
 MappedKeyValueArrayFuture Transaction::get_mapped_range(const uint8_t* begin_key_name,
                                                         int begin_key_name_length,
                                                         fdb_bool_t begin_or_equal,
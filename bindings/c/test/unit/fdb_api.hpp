@@ -59,6 +59,8 @@ public:
 	fdb_error_t block_until_ready();
 	// Wrapper around fdb_future_set_callback.
 	fdb_error_t set_callback(FDBCallback callback, void* callback_parameter);
+	// Wrapper around fdb_completion_queue_register.
+	fdb_error_t register_with(FDBCompletionQueue* queue, uint64_t tag);
 	// Wrapper around fdb_future_get_error.
 	fdb_error_t get_error();
 	// Wrapper around fdb_future_release_memory.
@@ -86,6 +88,7 @@ public:
 private:
 	friend class Transaction;
 	friend class Database;
+	friend class ReadSnapshot;
 	Int64Future(FDBFuture* f) : Future(f) {}
 };
 
@@ -144,8 +147,12 @@ public:
 	// fdb_future_get_keyvalue_array.
 	fdb_error_t get(const FDBKeyValue** out_kv, int* out_count, fdb_bool_t* out_more);
 
+	// Wrapper around fdb_future_copy_keyvalue_array.
+	fdb_error_t copy(uint8_t* buffer, int buffer_length, int* out_length, int* out_count, fdb_bool_t* out_more);
+
 private:
 	friend class Transaction;
+	friend class RangeIterator;
 	KeyValueArrayFuture(FDBFuture* f) : Future(f) {}
 };
 
@@ -214,6 +221,41 @@ private:
 	KeyValueArrayResult(FDBResult* r) : Result(r) {}
 };
 
+// Wrapper around FDBRangeIterator. Cleans up the iterator when this instance
+// goes out of scope.
+class RangeIterator final {
+public:
+	~RangeIterator();
+	RangeIterator(const RangeIterator&) = delete;
+	RangeIterator& operator=(const RangeIterator&) = delete;
+
+	// Returns a future which will be set to the next batch of the range.
+	KeyValueArrayFuture next();
+
+private:
+	friend class Transaction;
+	RangeIterator(FDBRangeIterator* it) : it_(it) {}
+	FDBRangeIterator* it_;
+};
+
+// Wrapper around FDBReadSnapshot. Cleans up the snapshot when this instance
+// goes out of scope.
+class ReadSnapshot final {
+public:
+	// Given an FDBDatabase, starts obtaining the version of a new snapshot.
+	ReadSnapshot(FDBDatabase* db);
+	~ReadSnapshot();
+	ReadSnapshot(const ReadSnapshot&) = delete;
+	ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+
+	// Returns a future which will be set to the version of the snapshot.
+	Int64Future get_version();
+
+private:
+	friend class Transaction;
+	FDBReadSnapshot* snapshot_;
+};
+
 // Wrapper around FDBDatabase, providing database-level API
 class Database final {
 public:
@@ -282,6 +324,9 @@ public:
 	// Wrapper around fdb_transaction_set_read_version.
 	void set_read_version(int64_t version);
 
+	// Wrapper around fdb_transaction_set_read_snapshot.
+	fdb_error_t set_read_snapshot(ReadSnapshot& snapshot);
+
 	// Returns a future which will be set to the transaction read version.
 	Int64Future get_read_version();
 
@@ -328,6 +373,21 @@ public:
 	                              fdb_bool_t snapshot,
 	                              fdb_bool_t reverse);
 
+	// Returns an iterator over the range which reads ahead one batch.
+	RangeIterator get_range_iterator(const uint8_t* begin_key_name,
+	                                 int begin_key_name_length,
+	                                 fdb_bool_t begin_or_equal,
+	                                 int begin_offset,
+	                                 const uint8_t* end_key_name,
+	                                 int end_key_name_length,
+	                                 fdb_bool_t end_or_equal,
+	                                 int end_offset,
+	                                 int limit,
+	                                 int target_bytes,
+	                                 FDBStreamingMode mode,
+	                                 fdb_bool_t snapshot,
+	                                 fdb_bool_t reverse);
+
 	// WARNING: This feature is considered experimental at this time. It is only allowed when using snapshot isolation
 	// AND disabling read-your-writes. Returns a future which will be set to an FDBKeyValue array.
 	MappedKeyValueArrayFuture get_mapped_range(const uint8_t* begin_key_name,
@@ -379,6 +379,56 @@ TEST_CASE("fdb_future_set_callback") {
 	}
 }
 
+TEST_CASE("fdb_completion_queue") {
+	FDBCompletionQueue* queue;
+	fdb_check(fdb_create_completion_queue(&queue));
+
+	FDBCompletion completions[4];
+	int count;
+	fdb_check(fdb_completion_queue_wait(queue, completions, 4, 0, &count));
+	CHECK(count == 0);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::ValueFuture f1 = tr.get("foo", /*snapshot*/ true);
+		fdb::ValueFuture f2 = tr.get("bar", /*snapshot*/ true);
+		fdb_check(f1.register_with(queue, 1));
+		fdb_check(f2.register_with(queue, 2));
+
+		// Both futures must be taken off the queue before they are destroyed
+		uint64_t tags = 0;
+		int received = 0;
+		while (received < 2) {
+			fdb_check(fdb_completion_queue_wait(queue, completions, 4, -1, &count));
+			for (int i = 0; i < count; ++i) {
+				tags |= completions[i].tag;
+			}
+			received += count;
+		}
+		CHECK(received == 2);
+		CHECK(tags == 3);
+
+		// A future which is already ready is queued as soon as it is registered
+		fdb_check(f1.register_with(queue, 4));
+		fdb_check(fdb_completion_queue_wait(queue, completions, 4, 0, &count));
+		CHECK(count == 1);
+		CHECK(completions[0].tag == 4);
+
+		fdb_error_t err = f1.get_error();
+		if (!err) {
+			err = f2.get_error();
+		}
+		if (err) {
+			fdb::EmptyFuture f3 = tr.on_error(err);
+			fdb_check(wait_future(f3));
+			continue;
+		}
+		break;
+	}
+
+	fdb_completion_queue_destroy(queue);
+}
+
 TEST_CASE("fdb_future_cancel after future completion") {
 	fdb::Transaction tr(db);
 	while (1) {
@@ -1290,6 +1340,119 @@ TEST_CASE("fdb_transaction_get_range FDB_STREAMING_MODE_EXACT") {
 	}
 }
 
+TEST_CASE("fdb_future_copy_keyvalue_array") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "22" }, { "c", "" }, { "d", "4" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 =
+		    tr.get_range(FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("a").c_str(), key("a").size()),
+		                 FDB_KEYSEL_LAST_LESS_OR_EQUAL((const uint8_t*)key("d").c_str(), key("d").size()) + 1,
+		                 /* limit */ 0,
+		                 /* target_bytes */ 0,
+		                 /* FDBStreamingMode */ FDB_STREAMING_MODE_WANT_ALL,
+		                 /* iteration */ 0,
+		                 /* snapshot */ false,
+		                 /* reverse */ 0);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		int length;
+		int count;
+		fdb_bool_t more;
+		fdb_check(f1.copy(nullptr, 0, &length, &count, &more));
+		CHECK(count == 4);
+
+		// One byte short of the required size copies nothing
+		std::vector<uint8_t> buffer(length + 1, 0xff);
+		int copied_length;
+		fdb_check(f1.copy(buffer.data() + 1, length - 1, &copied_length, &count, &more));
+		CHECK(copied_length == length);
+		CHECK(buffer[1] == 0xff);
+
+		// Copy to an unaligned address
+		fdb_check(f1.copy(buffer.data() + 1, length, &copied_length, &count, &more));
+		CHECK(copied_length == length);
+
+		const uint8_t* block = buffer.data() + 1;
+		const uint8_t* kv_data = block + sizeof(uint32_t) * (2 * count + 1);
+		auto offset = [block](int i) {
+			uint32_t o;
+			memcpy(&o, block + sizeof(uint32_t) * i, sizeof(o));
+			return o;
+		};
+		CHECK(offset(0) == 0);
+		auto it = data.begin();
+		for (int i = 0; i < count; ++i, ++it) {
+			std::string k((const char*)kv_data + offset(2 * i), offset(2 * i + 1) - offset(2 * i));
+			std::string v((const char*)kv_data + offset(2 * i + 1), offset(2 * i + 2) - offset(2 * i + 1));
+			CHECK(k == it->first);
+			CHECK(v == it->second);
+		}
+		CHECK(kv_data + offset(2 * count) == block + length);
+		break;
+	}
+}
+
+TEST_CASE("fdb_transaction_get_range_iterator") {
+	std::map<std::string, std::string> data =
+	    create_data({ { "a", "1" }, { "b", "2" }, { "c", "3" }, { "d", "4" }, { "e", "5" } });
+	insert_data(db, data);
+
+	for (fdb_bool_t reverse : { 0, 1 }) {
+		fdb::Transaction tr(db);
+		while (1) {
+			// A target size of one byte returns a single row per batch
+			fdb::RangeIterator it = tr.get_range_iterator(
+			    FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("a").c_str(), key("a").size()),
+			    FDB_KEYSEL_LAST_LESS_OR_EQUAL((const uint8_t*)key("e").c_str(), key("e").size()) + 1,
+			    /* limit */ 4,
+			    /* target_bytes */ 1,
+			    /* FDBStreamingMode */ FDB_STREAMING_MODE_ITERATOR,
+			    /* snapshot */ false,
+			    reverse);
+
+			std::vector<std::pair<std::string, std::string>> results;
+			fdb_error_t err = 0;
+			fdb_bool_t more = 1;
+			while (more) {
+				fdb::KeyValueArrayFuture f1 = it.next();
+				err = wait_future(f1);
+				if (err) {
+					break;
+				}
+				const FDBKeyValue* out_kv;
+				int out_count;
+				fdb_check(f1.get(&out_kv, &out_count, &more));
+				for (int i = 0; i < out_count; ++i) {
+					results.emplace_back(std::string((const char*)out_kv[i].key, out_kv[i].key_length),
+					                     std::string((const char*)out_kv[i].value, out_kv[i].value_length));
+				}
+			}
+
+			if (err) {
+				fdb::EmptyFuture f2 = tr.on_error(err);
+				fdb_check(wait_future(f2));
+				continue;
+			}
+
+			std::vector<std::pair<std::string, std::string>> expected(data.begin(), data.end());
+			if (reverse) {
+				std::reverse(expected.begin(), expected.end());
+			}
+			expected.resize(4);
+			CHECK(results == expected);
+			break;
+		}
+	}
+}
+
 TEST_CASE("fdb_transaction_clear") {
 	insert_data(db, create_data({ { "foo", "bar" } }));
 
@@ -2115,6 +2278,47 @@ TEST_CASE("fdb_transaction_cancel") {
 	CHECK(wait_future(f2) != 1025); // transaction_cancelled
 }
 
+TEST_CASE("fdb_database_create_read_snapshot") {
+	insert_data(db, { { key("foo"), "a" } });
+
+	fdb::ReadSnapshot snapshot(db);
+	fdb::Int64Future f1 = snapshot.get_version();
+	fdb_check(wait_future(f1));
+	int64_t snapshot_version;
+	fdb_check(f1.get(&snapshot_version));
+
+	insert_data(db, { { key("foo"), "b" } });
+
+	// Every transaction using the snapshot reads at its version, without asking for a read version of its own
+	for (int i = 0; i < 2; ++i) {
+		fdb::Transaction tr(db);
+		while (1) {
+			fdb_check(tr.set_read_snapshot(snapshot));
+			fdb::ValueFuture f2 = tr.get(key("foo"), /* snapshot */ false);
+			fdb_error_t err = wait_future(f2);
+			if (err) {
+				fdb::EmptyFuture f3 = tr.on_error(err);
+				fdb_check(wait_future(f3));
+				continue;
+			}
+
+			fdb::Int64Future f4 = tr.get_read_version();
+			fdb_check(wait_future(f4));
+			int64_t read_version;
+			fdb_check(f4.get(&read_version));
+			CHECK(read_version == snapshot_version);
+
+			int out_present;
+			char* val;
+			int vallen;
+			fdb_check(f2.get(&out_present, (const uint8_t**)&val, &vallen));
+			CHECK(out_present);
+			CHECK(std::string(val, vallen) == "a");
+			break;
+		}
+	}
+}
+
 TEST_CASE("fdb_transaction_add_conflict_range") {
 	bool success = false;
 
@@ -484,6 +484,13 @@ func (o TransactionOptions) SetReadAheadDisable() error {
 	return o.setOpt(52, nil)
 }
 
+// Set the number of shards a range read in this transaction may read concurrently ahead of the application. After a range read returns a partial result, the client splits the rest of the range at shard boundaries and reads up to this many shards in the background, bounded in total bytes by the RANGE_READ_AHEAD_BYTES client knob. The following range reads of the same range, each starting where the previous result left off, are served from the rows read ahead. Rows read ahead but never requested are discarded. Valid parameter values are ``[0, 100]``; 0 disables reading ahead. Defaults to 0.
+//
+// Parameter: number of batches
+func (o TransactionOptions) SetRangeReadAhead(param int64) error {
+	return o.setOpt(53, int64ToBytes(param))
+}
+
 // Storage server should cache disk blocks needed for subsequent read requests in this transaction.  This is the default behavior.
 func (o TransactionOptions) SetReadServerSideCacheEnable() error {
 	return o.setOpt(507, nil)
@@ -22,6 +22,7 @@
 
 #include "fdbcli/fdbcli.actor.h"
 
+#include "fdbclient/ClientWorkerInterface.h"
 #include "fdbclient/GlobalConfig.actor.h"
 #include "fdbclient/FDBOptions.g.h"
 #include "fdbclient/IClientApi.h"
@@ -124,6 +125,40 @@ ACTOR Future<bool> profileCommandActor(Database db,
 			                   .removePrefix("\xff\xff/worker_interfaces/"_sr);
 			printf("%s\n", printable(ip_port).c_str());
 		}
+	} else if (tokencmp(tokens[1], "actors")) {
+		if (tokens.size() < 3 || tokens.size() > 4 || (tokens.size() == 4 && !tokencmp(tokens[3], "reset"))) {
+			fprintf(stderr, "ERROR: Usage: profile actors <ADDRESS> [reset]\n");
+			return false;
+		}
+		state std::map<Key, std::pair<Value, ClientLeaderRegInterface>> address_interface;
+		wait(getWorkerInterfaces(tr, &address_interface, false));
+		auto it = address_interface.find(tokens[2]);
+		if (it == address_interface.end()) {
+			fprintf(stderr,
+			        "ERROR: No process found at %s; use `profile list` to list the processes.\n",
+			        printable(tokens[2]).c_str());
+			return false;
+		}
+		ClientWorkerInterface workerInterf =
+		    BinaryReader::fromStringRef<ClientWorkerInterface>(it->second.first, IncludeVersion());
+		ErrorOr<ActorProfileReply> reply =
+		    wait(workerInterf.actorProfile.getReplyUnlessFailedFor(ActorProfileRequest(tokens.size() == 4), 2, 0));
+		if (reply.isError()) {
+			fprintf(stderr, "ERROR: %s did not reply: %s\n", printable(tokens[2]).c_str(), reply.getError().what());
+			return false;
+		}
+		if (reply.get().hz <= 0) {
+			fprintf(stderr, "WARNING: The actor sampler is disabled on %s.\n", printable(tokens[2]).c_str());
+		}
+		fprintf(stderr,
+		        "%" PRId64 " samples over %.1f seconds at %d Hz, %" PRId64 " dropped.\n",
+		        reply.get().samples,
+		        reply.get().duration,
+		        reply.get().hz,
+		        reply.get().dropped);
+		for (const auto& [stack, count] : reply.get().stacks) {
+			printf("%s %" PRId64 "\n", stack.c_str(), count);
+		}
 	} else {
 		fprintf(stderr, "ERROR: Unknown type: %s\n", printable(tokens[1]).c_str());
 		result = false;
@@ -132,8 +167,11 @@ ACTOR Future<bool> profileCommandActor(Database db,
 }
 
 CommandFactory profileFactory("profile",
-                              CommandHelp("profile <client|list> <action> <ARGS>",
+                              CommandHelp("profile <client|list|actors> <action> <ARGS>",
                                           "namespace for all the profiling-related commands.",
                                           "Different types support different actions.  Run `profile` to get a list of "
-                                          "types, and iteratively explore the help.\n"));
+                                          "types, and iteratively explore the help.\n\n"
+                                          "`profile actors <ADDRESS> [reset]' prints the actor stacks sampled on the "
+                                          "process at ADDRESS, one `<stack> <count>' line per stack, which flame "
+                                          "graph tools can render.\n"));
 } // namespace fdb_cli
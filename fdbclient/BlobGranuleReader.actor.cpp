@@ -29,6 +29,7 @@
 #include "fdbclient/BlobWorkerCommon.h"
 #include "fdbclient/BlobWorkerInterface.h"
 #include "fdbclient/FDBTypes.h"
+#include "flow/ComputePool.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> bstoreProvider, BlobFilePointerRef f) {
@@ -103,9 +104,26 @@ ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
 			arena.dependsOn(data.arena());
 		}
 
-		// TODO do something useful with stats?
-		GranuleMaterializeStats stats;
-		return materializeBlobGranule(chunk, keyRange, beginVersion, readVersion, snapshotData, deltaData, stats);
+		// Materializing is pure CPU work, so do it on the compute pool. The chunk and range belong to the caller and
+		// may be freed if this actor is cancelled, so the task gets its own copies in an arena it holds.
+		Arena taskArena;
+		taskArena.dependsOn(arena);
+		BlobGranuleChunkRef chunkCopy(taskArena, chunk);
+		KeyRangeRef keyRangeCopy(taskArena, keyRange);
+		RangeResult result = wait(runOnComputePool(
+		    [taskArena,
+		     chunkCopy,
+		     keyRangeCopy,
+		     beginVersion = beginVersion,
+		     readVersion = readVersion,
+		     snapshotData = snapshotData,
+		     deltaData = deltaData]() {
+			    // TODO do something useful with stats?
+			    GranuleMaterializeStats stats;
+			    return materializeBlobGranule(
+			        chunkCopy, keyRangeCopy, beginVersion, readVersion, snapshotData, deltaData, stats);
+		    }));
+		return result;
 
 	} catch (Error& e) {
 		throw e;
@@ -69,6 +69,10 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( BACKOFF_GROWTH_RATE,                     2.0 );
 	init( RESOURCE_CONSTRAINED_MAX_BACKOFF,       30.0 );
 	init( PROXY_COMMIT_OVERHEAD_BYTES,              23 ); //The size of serializing 7 tags (3 primary, 3 remote, 1 log router) + 2 for the tag length
+	init( COMMIT_COALESCE_MUTATIONS,              true ); if( randomize && BUGGIFY ) COMMIT_COALESCE_MUTATIONS = false;
+	init( COMMIT_COMPRESS_MUTATIONS,             false ); if( randomize && BUGGIFY ) COMMIT_COMPRESS_MUTATIONS = true;
+	init( COMMIT_COMPRESS_MUTATIONS_MIN_BYTES,     1e4 ); if( randomize && BUGGIFY ) COMMIT_COMPRESS_MUTATIONS_MIN_BYTES = 0;
+	init( COMMIT_ZSTD_MUTATIONS_MIN_BYTES,         1e5 ); if( randomize && BUGGIFY ) COMMIT_ZSTD_MUTATIONS_MIN_BYTES = deterministicRandom()->randomInt(0, 1000);
 	init( SHARD_STAT_SMOOTH_AMOUNT,                5.0 );
 	init( INIT_MID_SHARD_BYTES,               10000000 ); if( randomize && BUGGIFY ) INIT_MID_SHARD_BYTES = 40000; else if(randomize && BUGGIFY_WITH_PROB(0.75)) INIT_MID_SHARD_BYTES = 200000; // The same value as SERVER_KNOBS->MIN_SHARD_BYTES
 
@@ -77,6 +81,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( SYSTEM_KEY_SIZE_LIMIT,                   3e4 );
 	init( VALUE_SIZE_LIMIT,                        1e5 );
 	init( SPLIT_KEY_SIZE_LIMIT,                    KEY_SIZE_LIMIT/2 );  if( randomize && BUGGIFY ) SPLIT_KEY_SIZE_LIMIT = KEY_SIZE_LIMIT - 31;//serverKeysPrefixFor(UID()).size() - 1;
+	init( RYW_BUFFER_BLIND_SETS,                  true ); if( randomize && BUGGIFY ) RYW_BUFFER_BLIND_SETS = false;
 	init( METADATA_VERSION_CACHE_SIZE,            1000 );
 	init( CHANGE_FEED_LOCATION_LIMIT,            10000 );
 	init( CHANGE_FEED_CACHE_SIZE,               100000 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_SIZE = 1;
@@ -97,6 +102,9 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( LOCATION_CACHE_EVICTION_SIZE_SIM,         10 ); if( randomize && BUGGIFY ) LOCATION_CACHE_EVICTION_SIZE_SIM = 3;
 	init( LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD,     60 );
 	init( LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL,    60 );
+	init( SHARD_MAP_WATCH_ENABLED,                   false ); if( randomize && BUGGIFY ) SHARD_MAP_WATCH_ENABLED = true;
+	init( SHARD_MAP_WATCH_MAX_RANGES,                  100 ); if( randomize && BUGGIFY ) SHARD_MAP_WATCH_MAX_RANGES = 1;
+	init( SHARD_MAP_WATCH_MIN_INTERVAL,                1.0 ); if( randomize && BUGGIFY ) SHARD_MAP_WATCH_MIN_INTERVAL = 0.1;
 
 	init( GET_RANGE_SHARD_LIMIT,                     2 );
 	init( WARM_RANGE_SHARD_LIMIT,                  100 );
@@ -110,6 +118,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( TAG_ENCODE_KEY_SERVERS,                false ); if( randomize && BUGGIFY ) TAG_ENCODE_KEY_SERVERS = true;
 	init( RANGESTREAM_FRAGMENT_SIZE,               1e6 );
 	init( RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT,     20 );
+	init( RANGE_READ_AHEAD_BATCHES,                  0 ); if( randomize && BUGGIFY ) RANGE_READ_AHEAD_BATCHES = deterministicRandom()->randomInt(1, 4);
+	init( RANGE_READ_AHEAD_BYTES,                  5e6 ); if( randomize && BUGGIFY ) RANGE_READ_AHEAD_BYTES = 1;
 	init( QUARANTINE_TSS_ON_MISMATCH,             true ); if( randomize && BUGGIFY ) QUARANTINE_TSS_ON_MISMATCH = false; // if true, a tss mismatch will put the offending tss in quarantine. If false, it will just be killed
 	init( CHANGE_FEED_EMPTY_BATCH_TIME,          0.005 );
 
@@ -123,6 +133,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( NO_RECENT_UPDATES_DURATION,             20.0 ); if( randomize && BUGGIFY ) NO_RECENT_UPDATES_DURATION = 0.1;
 	init( FAST_WATCH_TIMEOUT,                     20.0 ); if( randomize && BUGGIFY ) FAST_WATCH_TIMEOUT = 1.0;
 	init( WATCH_TIMEOUT,                          30.0 ); if( randomize && BUGGIFY ) WATCH_TIMEOUT = 20.0;
+	init( WATCH_BATCH_MIN_KEYS,                     64 ); if( randomize && BUGGIFY ) WATCH_BATCH_MIN_KEYS = deterministicRandom()->randomInt(1, 4);
+	init( WATCH_BATCH_MAX_KEYS,                    1e4 ); if( randomize && BUGGIFY ) WATCH_BATCH_MAX_KEYS = deterministicRandom()->randomInt(1, 10);
 
 	// Core
 	init( CORE_VERSIONSPERSECOND,		           1e6 );
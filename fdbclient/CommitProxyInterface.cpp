@@ -1,6 +1,7 @@
 #include "fdbclient/CommitProxyInterface.h"
 #include "fdbclient/CoordinationInterface.h"
 #include "fdbclient/GetEncryptCipherKeys_impl.actor.h"
+#include "flow/UnitTest.h"
 
 // Instantiate ClientDBInfo related templates
 template class ReplyPromise<struct ClientDBInfo>;
@@ -12,4 +13,199 @@ template struct NetNotifiedQueue<OpenDatabaseCoordRequest, true>;
 
 // Instantiate GetKeyServerLocationsReply related templates
 template class ReplyPromise<GetKeyServerLocationsReply>;
-template struct NetSAV<GetKeyServerLocationsReply>;
\ No newline at end of file
+template struct NetSAV<GetKeyServerLocationsReply>;
+namespace {
+
+uint8_t* writeVarint(uint8_t* out, uint32_t value) {
+	while (value >= 0x80) {
+		*out++ = uint8_t(value) | 0x80;
+		value >>= 7;
+	}
+	*out++ = uint8_t(value);
+	return out;
+}
+
+uint8_t* writeSuffix(uint8_t* out, StringRef str, int prefixLength) {
+	out = writeVarint(out, prefixLength);
+	out = writeVarint(out, str.size() - prefixLength);
+	memcpy(out, str.begin() + prefixLength, str.size() - prefixLength);
+	return out + str.size() - prefixLength;
+}
+
+struct EncodedMutationReader {
+	const uint8_t* pos;
+	const uint8_t* end;
+
+	uint8_t byte() {
+		if (pos == end) {
+			throw serialization_failed();
+		}
+		return *pos++;
+	}
+
+	const uint8_t* bytes(size_t size) {
+		if (end - pos < size) {
+			throw serialization_failed();
+		}
+		pos += size;
+		return pos - size;
+	}
+
+	uint32_t varint() {
+		uint32_t value = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			uint8_t b = byte();
+			value |= uint32_t(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return value;
+			}
+		}
+		throw serialization_failed();
+	}
+
+	// Reads a string written by writeSuffix() relative to prefix. Strings sharing no prefix point into the encoding.
+	StringRef suffixOf(StringRef prefix, Arena& arena) {
+		uint32_t prefixLength = varint();
+		uint32_t suffixLength = varint();
+		if (prefixLength > prefix.size()) {
+			throw serialization_failed();
+		}
+		StringRef suffix(bytes(suffixLength), suffixLength);
+		if (prefixLength == 0) {
+			return suffix;
+		}
+		return prefix.substr(0, prefixLength).withSuffix(suffix, arena);
+	}
+};
+
+} // namespace
+
+CompressedMutationsRef::CompressedMutationsRef(Arena& arena,
+                                               VectorRef<MutationRef> const& mutations,
+                                               CompressionFilter filter)
+  : filter(filter), count(mutations.size()), checksummed(CLIENT_KNOBS->ENABLE_MUTATION_CHECKSUM) {
+	// Each mutation is its type followed by param1 relative to the previous param1 and param2 relative to param1, with
+	// each length taking at most 5 bytes
+	size_t maxSize = 0;
+	for (auto const& m : mutations) {
+		maxSize += 25 + m.param1.size() + m.param2.size();
+	}
+
+	Arena encodingArena;
+	uint8_t* encoding = new (filter == CompressionFilter::NONE ? arena : encodingArena) uint8_t[maxSize];
+	uint8_t* out = encoding;
+	StringRef previous;
+	for (auto const& m : mutations) {
+		*out++ = m.type;
+		out = writeSuffix(out, m.param1, commonPrefixLength(m.param1, previous));
+		out = writeSuffix(out, m.param2, commonPrefixLength(m.param2, m.param1));
+		if (checksummed) {
+			MutationRef withChecksum(m);
+			withChecksum.populateChecksum();
+			uint32_t checksum = withChecksum.checksum.get();
+			memcpy(out, &checksum, sizeof(checksum));
+			out += sizeof(checksum);
+		}
+		previous = m.param1;
+	}
+
+	data = StringRef(encoding, out - encoding);
+	if (filter != CompressionFilter::NONE) {
+		data = CompressionUtils::compress(filter, data, arena);
+	}
+}
+
+VectorRef<MutationRef> CompressedMutationsRef::decode(Arena& arena) const {
+	StringRef encoding = filter == CompressionFilter::NONE ? data : CompressionUtils::decompress(filter, data, arena);
+	// Every mutation takes at least five bytes
+	if (count < 0 || count > encoding.size() / 5) {
+		throw serialization_failed();
+	}
+
+	VectorRef<MutationRef> mutations;
+	mutations.reserve(arena, count);
+	EncodedMutationReader reader{ encoding.begin(), encoding.end() };
+	StringRef previous;
+	for (int i = 0; i < count; i++) {
+		MutationRef m;
+		m.type = reader.byte();
+		m.param1 = reader.suffixOf(previous, arena);
+		m.param2 = reader.suffixOf(m.param1, arena);
+		if (checksummed) {
+			uint32_t checksum;
+			memcpy(&checksum, reader.bytes(sizeof(checksum)), sizeof(checksum));
+			m.checksum = checksum;
+			if (!m.validateChecksum()) {
+				TraceEvent(SevError, "MutationRefCorruptionDetected")
+				    .setMaxFieldLength(-1)
+				    .setMaxEventLength(-1)
+				    .detail("Mutation", m.toString());
+				m.corrupted = true;
+			}
+		}
+		mutations.push_back(arena, m);
+		previous = m.param1;
+	}
+	if (reader.pos != reader.end) {
+		throw serialization_failed();
+	}
+	return mutations;
+}
+
+void CommitTransactionRequest::compressMutations(CompressionFilter filter) {
+	compressedMutations = CompressedMutationsRef(arena, transaction.mutations, filter);
+	transaction.mutations = VectorRef<MutationRef>();
+}
+
+void CommitTransactionRequest::decompressMutations() {
+	if (compressedMutations.present()) {
+		transaction.mutations = compressedMutations.get().decode(arena);
+		compressedMutations.reset();
+	}
+}
+
+TEST_CASE("/fdbclient/CommitProxyInterface/compressMutations") {
+	Arena arena;
+	VectorRef<MutationRef> mutations;
+	for (int i = 0; i < 1000; i++) {
+		int type = deterministicRandom()->randomInt(0, 3);
+		Key key = "compressMutations/test/"_sr.withSuffix(
+		    deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 20)));
+		if (type == 0) {
+			mutations.push_back_deep(arena, MutationRef(MutationRef::ClearRange, key, keyAfter(key)));
+		} else if (type == 1) {
+			mutations.push_back_deep(arena, MutationRef(MutationRef::AddValue, key, "\x01\x00\x00\x00"_sr));
+		} else {
+			mutations.push_back_deep(
+			    arena, MutationRef(MutationRef::SetValue, key, deterministicRandom()->randomAlphaNumeric(100)));
+		}
+	}
+
+	for (CompressionFilter filter : CompressionUtils::supportedFilters) {
+		CommitTransactionRequest req;
+		req.transaction.mutations = mutations;
+		req.compressMutations(filter);
+		ASSERT(req.transaction.mutations.empty());
+		ASSERT_LT(req.compressedMutations.get().data.size(), mutations.expectedSize());
+
+		req.decompressMutations();
+		ASSERT(!req.compressedMutations.present());
+		ASSERT_EQ(req.transaction.mutations.size(), mutations.size());
+		for (int i = 0; i < mutations.size(); i++) {
+			ASSERT(req.transaction.mutations[i].type == mutations[i].type);
+			ASSERT(req.transaction.mutations[i].param1 == mutations[i].param1);
+			ASSERT(req.transaction.mutations[i].param2 == mutations[i].param2);
+		}
+	}
+
+	CompressedMutationsRef truncated(arena, mutations, CompressionFilter::NONE);
+	truncated.data = truncated.data.substr(0, truncated.data.size() / 2);
+	try {
+		truncated.decode(arena);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_serialization_failed);
+	}
+
+	return Void();
+}
@@ -19,6 +19,7 @@
  */
 
 #include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/FlatKeyRangeMap.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/CommitTransaction.h"
 #include "fdbclient/FDBTypes.h"
@@ -417,4 +418,82 @@ TEST_CASE("/keyrangemap/decoderange/unaligned") {
 	ASSERT(decodedRanges.back().value == keyD);
 
 	return Void();
-}
\ No newline at end of file
+}
+
+namespace {
+
+Key randomFlatMapKey() {
+	// A small alphabet so that inserted ranges often share boundaries
+	int length = deterministicRandom()->randomInt(1, 4);
+	std::string key;
+	for (int i = 0; i < length; ++i) {
+		key += (char)('a' + deterministicRandom()->randomInt(0, 4));
+	}
+	return Key(key);
+}
+
+template <class FlatMap>
+void checkFlatMap(const FlatMap& flat, CoalescedKeyRangeMap<int>& expected) {
+	auto i = flat.begin();
+	int count = 0;
+	for (auto r : expected.ranges()) {
+		ASSERT(i != flat.end());
+		ASSERT(i.range() == r.range());
+		ASSERT_EQ(i.value(), r.value());
+		++i;
+		++count;
+	}
+	ASSERT(i == flat.end());
+	ASSERT_EQ(flat.size(), count);
+	ASSERT(flat.lastItem().end() == flat.mapEnd);
+}
+
+} // namespace
+
+TEST_CASE("/keyrangemap/flat/random") {
+	// A small leaf capacity so that leaves are split and emptied often
+	FlatKeyRangeMap<int, 4> flat(0, "\xff"_sr);
+	CoalescedKeyRangeMap<int> expected(0, "\xff"_sr);
+
+	for (int i = 0; i < 10000; ++i) {
+		Key a = randomFlatMapKey();
+		Key b = randomFlatMapKey();
+		KeyRange keys = a < b ? KeyRangeRef(a, b) : KeyRangeRef(b, a);
+		int value = deterministicRandom()->randomInt(0, 4);
+
+		if (deterministicRandom()->random01() < 0.01) {
+			flat.clear(value);
+			expected.insert(KeyRangeRef(""_sr, "\xff"_sr), value);
+		} else {
+			flat.insert(keys, value);
+			expected.insert(keys, value);
+		}
+
+		Key key = randomFlatMapKey();
+		ASSERT(flat.rangeContaining(key).range() == expected.rangeContaining(key).range());
+		ASSERT_EQ(flat.rangeContaining(key).value(), expected.rangeContaining(key).value());
+		ASSERT(flat.rangeContainingKeyBefore(key).range() == expected.rangeContainingKeyBefore(key).range());
+
+		auto intersecting = expected.intersectingRanges(keys);
+		ASSERT(flat.intersectingRange(keys) == KeyRangeRef(intersecting.begin().begin(), intersecting.end().begin()));
+
+		int contained = 0;
+		flat.forEachContainedRange(keys, [&](auto r) {
+			ASSERT(keys.contains(r.range()));
+			++contained;
+		});
+		int expectedContained = 0;
+		for (auto r : expected.containedRanges(keys)) {
+			(void)r;
+			++expectedContained;
+		}
+		ASSERT_EQ(contained, expectedContained);
+
+		if (i % 100 == 0) {
+			checkFlatMap(flat, expected);
+		}
+	}
+	checkFlatMap(flat, expected);
+
+	return Void();
+}
@@ -21,6 +21,7 @@
 #include "fdbclient/NativeAPI.actor.h"
 
 #include <algorithm>
+#include <numeric>
 #include <cstdio>
 #include <iterator>
 #include <limits>
@@ -1033,8 +1034,7 @@ void updateLocationCacheWithCaches(DatabaseContext* self,
                                    const std::map<UID, StorageServerInterface>& removed,
                                    const std::map<UID, StorageServerInterface>& added) {
 	// TODO: this needs to be more clever in the future
-	auto ranges = self->locationCache.ranges();
-	for (auto iter = ranges.begin(); iter != ranges.end(); ++iter) {
+	for (auto iter = self->locationCache.begin(); iter != self->locationCache.end(); ++iter) {
 		if (iter->value() && iter->value()->hasCaches) {
 			auto& val = iter->value();
 			std::vector<Reference<ReferencedInterface<StorageServerInterface>>> interfaces;
@@ -1099,17 +1099,11 @@ ACTOR Future<Void> updateCachedRanges(DatabaseContext* self, std::map<UID, Stora
 						currCached = false;
 						end = kv.key.substr(storageCacheKeys.begin.size());
 						KeyRangeRef cachedRange{ begin, end };
-						auto ranges = self->locationCache.containedRanges(cachedRange);
-						KeyRef containedRangesBegin, containedRangesEnd, prevKey;
-						if (!ranges.empty()) {
-							containedRangesBegin = ranges.begin().range().begin;
-						}
-						for (auto iter = ranges.begin(); iter != ranges.end(); ++iter) {
-							containedRangesEnd = iter->range().end;
+						self->locationCache.forEachContainedRange(cachedRange, [&](auto iter) {
 							if (iter->value() && !iter->value()->hasCaches) {
 								iter->value() = addCaches(iter->value(), cacheInterfaces);
 							}
-						}
+						});
 						auto iter = self->locationCache.rangeContaining(begin);
 						if (iter->value() && !iter->value()->hasCaches) {
 							if (end >= iter->range().end) {
@@ -1141,6 +1135,81 @@ ACTOR Future<Void> updateCachedRanges(DatabaseContext* self, std::map<UID, Stora
 	}
 }
 
+// The ranges with cached locations, with adjacent ranges merged. If there are more than SHARD_MAP_WATCH_MAX_RANGES,
+// the last one is extended to cover the rest.
+VectorRef<KeyRangeRef> getCachedLocationRanges(DatabaseContext* self, Arena& arena) {
+	VectorRef<KeyRangeRef> ranges;
+	for (auto r = self->locationCache.begin(); r != self->locationCache.end(); ++r) {
+		if (!r->value()) {
+			continue;
+		}
+		if (!ranges.empty() &&
+		    (ranges.back().end == r->begin() || ranges.size() == CLIENT_KNOBS->SHARD_MAP_WATCH_MAX_RANGES)) {
+			ranges.back() = KeyRangeRef(ranges.back().begin, r->end());
+		} else {
+			ranges.push_back(arena, r->range());
+		}
+	}
+	// The ranges point into the cache, which can change while they are in a request
+	for (auto& range : ranges) {
+		range = KeyRangeRef(arena, range);
+	}
+	return ranges;
+}
+
+void updateTssMappings(Database cx, const GetKeyServerLocationsReply& reply);
+void updateTagMappings(Database cx, const GetKeyServerLocationsReply& reply);
+
+// Watches the commit proxies for changes to the locations of the ranges in the location cache, and updates the cache
+// before the next request to a range that moved would go to the wrong storage servers.
+ACTOR Future<Void> monitorShardMapChanges(DatabaseContext* self) {
+	state Version version = latestVersion;
+	state double backoff = CLIENT_KNOBS->DEFAULT_BACKOFF;
+	loop {
+		wait(delay(CLIENT_KNOBS->SHARD_MAP_WATCH_MIN_INTERVAL));
+		state WatchShardMapRequest req;
+		req.version = version;
+		req.ranges = getCachedLocationRanges(self, req.arena);
+		if (req.ranges.empty()) {
+			version = latestVersion;
+			continue;
+		}
+
+		try {
+			choose {
+				when(wait(self->onProxiesChanged())) {}
+				when(WatchShardMapReply rep = wait(basicLoadBalance(self->getCommitProxies(UseProvisionalProxies::False),
+				                                                    &CommitProxyInterface::watchShardMap,
+				                                                    req,
+				                                                    TaskPriority::DefaultPromiseEndpoint))) {
+					// After a reset the missed changes are found by requests to the wrong storage servers as before
+					CODE_PROBE(rep.reset, "Shard map watch reset");
+					for (const auto& range : rep.changed) {
+						self->invalidateCache(Optional<KeyRef>(), range);
+					}
+					for (const auto& [range, servers] : rep.locations.results) {
+						self->setCachedLocation(range, servers);
+					}
+					Database cx(Reference<DatabaseContext>::addRef(self));
+					updateTssMappings(cx, rep.locations);
+					updateTagMappings(cx, rep.locations);
+					self->transactionShardMapLocationsPushed += rep.locations.results.size();
+					version = rep.version;
+					backoff = CLIENT_KNOBS->DEFAULT_BACKOFF;
+				}
+			}
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// Pushed updates are an optimization, so keep trying after the failures of older or overloaded proxies
+			TraceEvent(SevDebug, "ShardMapWatchError", self->dbId).error(e);
+			wait(delay(backoff));
+			backoff = std::min(backoff * CLIENT_KNOBS->BACKOFF_GROWTH_RATE, CLIENT_KNOBS->DEFAULT_MAX_BACKOFF);
+		}
+	}
+}
+
 // The reason for getting a pointer to DatabaseContext instead of a reference counted object is because reference
 // counting will increment reference count for DatabaseContext which holds the future of this actor. This creates a
 // cyclic reference and hence this actor and Database object will not be destroyed at all.
@@ -1543,15 +1612,22 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
     transactionGetKeyRequests("GetKeyRequests", cc), transactionGetValueRequests("GetValueRequests", cc),
     transactionGetRangeRequests("GetRangeRequests", cc),
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
-    transactionGetRangeStreamRequests("GetRangeStreamRequests", cc), transactionWatchRequests("WatchRequests", cc),
+    transactionGetRangeStreamRequests("GetRangeStreamRequests", cc),
+    transactionRangeReadAheadHits("RangeReadAheadHits", cc),
+    transactionRangeReadAheadWasted("RangeReadAheadWasted", cc), transactionWatchRequests("WatchRequests", cc),
+    transactionBatchedWatchRequests("BatchedWatchRequests", cc),
+    transactionBatchedWatchKeys("BatchedWatchKeys", cc),
     transactionGetAddressesForKeyRequests("GetAddressesForKeyRequests", cc), transactionBytesRead("BytesRead", cc),
     transactionKeysRead("KeysRead", cc), transactionMetadataVersionReads("MetadataVersionReads", cc),
     transactionCommittedMutations("CommittedMutations", cc),
-    transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionSetMutations("SetMutations", cc),
+    transactionCommittedMutationBytes("CommittedMutationBytes", cc),
+    transactionCoalescedMutations("CoalescedMutations", cc),
+    transactionCommitMutationBytesSent("CommitMutationBytesSent", cc), transactionSetMutations("SetMutations", cc),
     transactionClearMutations("ClearMutations", cc), transactionAtomicMutations("AtomicMutations", cc),
     transactionsCommitStarted("CommitStarted", cc), transactionsCommitCompleted("CommitCompleted", cc),
     transactionKeyServerLocationRequests("KeyServerLocationRequests", cc),
     transactionKeyServerLocationRequestsCompleted("KeyServerLocationRequestsCompleted", cc),
+    transactionShardMapLocationsPushed("ShardMapLocationsPushed", cc),
     transactionBlobGranuleLocationRequests("BlobGranuleLocationRequests", cc),
     transactionBlobGranuleLocationRequestsCompleted("BlobGranuleLocationRequestsCompleted", cc),
     transactionStatusRequests("StatusRequests", cc), transactionTenantLookupRequests("TenantLookupRequests", cc),
@@ -1600,6 +1676,9 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 	tssMismatchHandler = handleTssMismatches(this);
 	clientStatusUpdater.actor = clientStatusUpdateActor(this);
 	cacheListMonitor = monitorCacheList(this);
+	if (CLIENT_KNOBS->SHARD_MAP_WATCH_ENABLED) {
+		shardMapMonitor = monitorShardMapChanges(this);
+	}
 
 	smoothMidShardSize.reset(CLIENT_KNOBS->INIT_MID_SHARD_BYTES);
 	globalConfig = std::make_unique<GlobalConfig>(this);
@@ -1856,15 +1935,22 @@ DatabaseContext::DatabaseContext(const Error& err)
     transactionGetKeyRequests("GetKeyRequests", cc), transactionGetValueRequests("GetValueRequests", cc),
     transactionGetRangeRequests("GetRangeRequests", cc),
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
-    transactionGetRangeStreamRequests("GetRangeStreamRequests", cc), transactionWatchRequests("WatchRequests", cc),
+    transactionGetRangeStreamRequests("GetRangeStreamRequests", cc),
+    transactionRangeReadAheadHits("RangeReadAheadHits", cc),
+    transactionRangeReadAheadWasted("RangeReadAheadWasted", cc), transactionWatchRequests("WatchRequests", cc),
+    transactionBatchedWatchRequests("BatchedWatchRequests", cc),
+    transactionBatchedWatchKeys("BatchedWatchKeys", cc),
     transactionGetAddressesForKeyRequests("GetAddressesForKeyRequests", cc), transactionBytesRead("BytesRead", cc),
     transactionKeysRead("KeysRead", cc), transactionMetadataVersionReads("MetadataVersionReads", cc),
     transactionCommittedMutations("CommittedMutations", cc),
-    transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionSetMutations("SetMutations", cc),
+    transactionCommittedMutationBytes("CommittedMutationBytes", cc),
+    transactionCoalescedMutations("CoalescedMutations", cc),
+    transactionCommitMutationBytesSent("CommitMutationBytesSent", cc), transactionSetMutations("SetMutations", cc),
     transactionClearMutations("ClearMutations", cc), transactionAtomicMutations("AtomicMutations", cc),
     transactionsCommitStarted("CommitStarted", cc), transactionsCommitCompleted("CommitCompleted", cc),
     transactionKeyServerLocationRequests("KeyServerLocationRequests", cc),
     transactionKeyServerLocationRequestsCompleted("KeyServerLocationRequestsCompleted", cc),
+    transactionShardMapLocationsPushed("ShardMapLocationsPushed", cc),
     transactionBlobGranuleLocationRequests("BlobGranuleLocationRequests", cc),
     transactionBlobGranuleLocationRequestsCompleted("BlobGranuleLocationRequestsCompleted", cc),
     transactionStatusRequests("StatusRequests", cc), transactionTenantLookupRequests("TenantLookupRequests", cc),
@@ -1914,6 +2000,7 @@ Database DatabaseContext::create(Reference<AsyncVar<ClientDBInfo>> clientInfo,
 
 DatabaseContext::~DatabaseContext() {
 	cacheListMonitor.cancel();
+	shardMapMonitor.cancel();
 	clientDBInfoMonitor.cancel();
 	monitorTssInfoChange.cancel();
 	tssMismatchHandler.cancel();
@@ -1929,7 +2016,7 @@ DatabaseContext::~DatabaseContext() {
 	for (auto it = server_interf.begin(); it != server_interf.end(); it = server_interf.erase(it))
 		it->second->notifyContextDestroyed();
 	ASSERT_ABORT(server_interf.empty());
-	locationCache.insert(allKeys, Reference<LocationInfo>());
+	locationCache.clear();
 	for (auto& it : notAtLatestChangeFeeds) {
 		it.second->context = nullptr;
 	}
@@ -2043,10 +2130,11 @@ void DatabaseContext::invalidateCache(const Optional<KeyRef>& tenantPrefix, cons
 		resolvedKeys = resolvedKeys.withPrefix(tenantPrefix.get(), arena);
 	}
 
-	auto rs = locationCache.intersectingRanges(resolvedKeys);
-	Key begin = rs.begin().begin(),
-	    end = rs.end().begin(); // insert invalidates rs, so can't be passed a mere reference into it
-	locationCache.insert(KeyRangeRef(begin, end), Reference<LocationInfo>());
+	if (resolvedKeys.empty()) {
+		return;
+	}
+	// insert() copies the range, so it can be passed keys pointing into the cache
+	locationCache.insert(locationCache.intersectingRange(resolvedKeys), Reference<LocationInfo>());
 }
 
 void DatabaseContext::setFailedEndpointOnHealthyServer(const Endpoint& endpoint) {
@@ -2136,7 +2224,7 @@ void DatabaseContext::setOption(FDBDatabaseOptions::Option option, Optional<Stri
 			if (clientInfo->get().grvProxies.size())
 				grvProxies = makeReference<GrvProxyInfo>(clientInfo->get().grvProxies, BalanceOnRequests::True);
 			server_interf.clear();
-			locationCache.insert(allKeys, Reference<LocationInfo>());
+			locationCache.clear();
 			break;
 		case FDBDatabaseOptions::MAX_WATCHES:
 			maxOutstandingWatches = (int)extractIntOption(value, 0, CLIENT_KNOBS->ABSOLUTE_MAX_WATCHES);
@@ -2152,7 +2240,7 @@ void DatabaseContext::setOption(FDBDatabaseOptions::Option option, Optional<Stri
 			if (clientInfo->get().grvProxies.size())
 				grvProxies = makeReference<GrvProxyInfo>(clientInfo->get().grvProxies, BalanceOnRequests::True);
 			server_interf.clear();
-			locationCache.insert(allKeys, Reference<LocationInfo>());
+			locationCache.clear();
 			break;
 		case FDBDatabaseOptions::SNAPSHOT_RYW_ENABLE:
 			validateOptionValueNotPresent(value);
@@ -4257,6 +4345,209 @@ ACTOR Future<Void> watchValueMap(Future<Version> version,
 	return Void();
 }
 
+// Registers the keys at `indices`, which are sorted by key and owned by one location, with a single storage server of
+// that location and sends the promise of each key as the server reports it changed. Fired keys are removed from
+// `indices`. Returns once every key has fired, or early with keys left in `indices` if they must be registered again at
+// the (possibly advanced) `version`.
+ACTOR Future<Void> watchValuesFromLocation(Database cx,
+                                           Reference<WatchValuesParameters> parameters,
+                                           KeyRangeLocationInfo locationInfo,
+                                           std::vector<int>* indices,
+                                           Version* version) {
+	state Span span("NAPI:watchValuesFromLocation"_loc, parameters->spanContext);
+	state std::vector<int> sent = *indices;
+	state std::vector<bool> fired(sent.size(), false);
+	state WatchValuesRequest req;
+	req.spanContext = span.context;
+	req.tenantInfo = parameters->tenant;
+	req.version = *version;
+	req.tags = cx->sampleReadTags() ? parameters->tags : Optional<TagSet>();
+	req.debugID = parameters->debugID;
+	req.arena.dependsOn(parameters->keys.arena());
+	req.keys.reserve(req.arena, sent.size());
+	for (int index : sent) {
+		req.keys.push_back(req.arena, parameters->keys[index]);
+	}
+
+	if (locationInfo.locations->size() == 0) {
+		throw all_alternatives_failed();
+	}
+
+	state int useIdx = -1;
+	loop {
+		int count = 0;
+		for (int i = 0; i < locationInfo.locations->size(); i++) {
+			if (!IFailureMonitor::failureMonitor()
+			         .getState(locationInfo.locations->get(i, &StorageServerInterface::watchValues).getEndpoint())
+			         .failed) {
+				if (deterministicRandom()->random01() <= 1.0 / ++count) {
+					useIdx = i;
+				}
+			}
+		}
+
+		if (useIdx >= 0) {
+			break;
+		}
+
+		std::vector<Future<Void>> ok(locationInfo.locations->size());
+		for (int i = 0; i < ok.size(); i++) {
+			ok[i] = IFailureMonitor::failureMonitor().onStateEqual(
+			    locationInfo.locations->get(i, &StorageServerInterface::watchValues).getEndpoint(),
+			    FailureStatus(false));
+		}
+		wait(allAlternativesFailedDelay(quorum(ok, 1)));
+	}
+
+	state ReplyPromiseStream<WatchValuesReply> replyStream =
+	    locationInfo.locations->get(useIdx, &StorageServerInterface::watchValues).getReplyStream(req);
+	++cx->transactionBatchedWatchRequests;
+	cx->transactionBatchedWatchKeys += sent.size();
+
+	loop {
+		state WatchValuesReply rep;
+		try {
+			choose {
+				when(WatchValuesReply r = waitNext(replyStream.getFuture())) {
+					rep = r;
+				}
+				when(wait(cx->connectionRecord ? cx->connectionRecord->onChange() : Never())) {
+					wait(Never());
+				}
+			}
+		} catch (Error& e) {
+			if (e.code() == error_code_end_of_stream) {
+				ASSERT(indices->empty());
+				return Void();
+			}
+			if (e.code() == error_code_broken_promise) {
+				throw connection_failed();
+			}
+			throw;
+		}
+
+		// As in watchValue, a large gap to the committed version may mean a recovery rolled back the change, so the
+		// keys are registered again instead of firing.
+		Version v = wait(waitForCommittedVersion(cx, rep.version, span.context));
+		bool buggifyRetry = g_network->isSimulated() && !g_simulator->speedUpSimulation && BUGGIFY_WITH_PROB(0.1);
+		CODE_PROBE(buggifyRetry, "Batched watch buggifying version gap retry");
+		if (v - rep.version >= 50'000'000 || buggifyRetry) {
+			*version = v;
+			return Void();
+		}
+
+		for (int i : rep.fired) {
+			ASSERT(i >= 0 && i < sent.size());
+			fired[i] = true;
+		}
+		indices->clear();
+		for (int i = 0; i < sent.size(); i++) {
+			if (!fired[i]) {
+				indices->push_back(sent[i]);
+			}
+		}
+		for (int i : rep.fired) {
+			if (parameters->promises[sent[i]].canBeSet()) {
+				parameters->promises[sent[i]].send(Void());
+			}
+		}
+	}
+}
+
+// Watches the keys at `indices`, which are sorted by key, registering the keys owned by one location together. Keys
+// owned by later locations are handed to a concurrent copy of this actor. Errors which are not retried are sent to the
+// promises of the keys which have not fired.
+ACTOR Future<Void> watchValuesBatch(Database cx,
+                                    Reference<WatchValuesParameters> parameters,
+                                    std::vector<int> indices,
+                                    Version version);
+
+ACTOR Future<Void> watchValuesBatch(Database cx,
+                                    Reference<WatchValuesParameters> parameters,
+                                    std::vector<int> indices,
+                                    Version version) {
+	state std::vector<Future<Void>> others;
+	while (!indices.empty()) {
+		state KeyRangeLocationInfo locationInfo = wait(getKeyLocation(cx,
+		                                                              parameters->tenant,
+		                                                              parameters->keys[indices[0]].key,
+		                                                              &StorageServerInterface::watchValues,
+		                                                              parameters->spanContext,
+		                                                              parameters->debugID,
+		                                                              parameters->useProvisionalProxies,
+		                                                              Reverse::False,
+		                                                              version));
+		int count = 0;
+		while (count < indices.size() && count < CLIENT_KNOBS->WATCH_BATCH_MAX_KEYS &&
+		       locationInfo.range.contains(parameters->keys[indices[count]].key)) {
+			++count;
+		}
+		ASSERT(count > 0);
+		if (count < indices.size()) {
+			others.push_back(
+			    watchValuesBatch(cx, parameters, std::vector<int>(indices.begin() + count, indices.end()), version));
+			indices.resize(count);
+		}
+
+		try {
+			wait(watchValuesFromLocation(cx, parameters, locationInfo, &indices, &version));
+		} catch (Error& e) {
+			if (e.code() == error_code_wrong_shard_server || e.code() == error_code_all_alternatives_failed ||
+			    e.code() == error_code_connection_failed || e.code() == error_code_request_maybe_delivered) {
+				if (!indices.empty()) {
+					cx->invalidateCache(parameters->tenant.prefix, parameters->keys[indices[0]].key);
+				}
+				wait(delay(CLIENT_KNOBS->WRONG_SHARD_SERVER_DELAY, parameters->taskID));
+			} else if (e.code() == error_code_watch_cancelled || e.code() == error_code_process_behind) {
+				CODE_PROBE(e.code() == error_code_watch_cancelled, "Too many watches to register a batched watch");
+				wait(delay(CLIENT_KNOBS->WATCH_POLLING_TIME, parameters->taskID));
+			} else if (e.code() == error_code_timed_out || e.code() == error_code_future_version) {
+				CODE_PROBE(e.code() == error_code_timed_out, "A batched watch timed out");
+				wait(delay(CLIENT_KNOBS->FUTURE_VERSION_RETRY_DELAY, parameters->taskID));
+			} else {
+				if (e.code() == error_code_operation_cancelled) {
+					throw;
+				}
+				for (int index : indices) {
+					if (parameters->promises[index].canBeSet()) {
+						parameters->promises[index].sendError(e);
+					}
+				}
+				indices.clear();
+			}
+		}
+	}
+
+	wait(waitForAll(others));
+	return Void();
+}
+
+// Watches all of the keys of a transaction with batched registrations once the version is known
+ACTOR Future<Void> watchValuesBatchMap(Future<Version> version,
+                                       Database cx,
+                                       Reference<WatchValuesParameters> parameters) {
+	state std::vector<int> indices(parameters->keys.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	std::sort(indices.begin(), indices.end(), [&keys = parameters->keys](int a, int b) {
+		return keys[a].key < keys[b].key;
+	});
+
+	try {
+		Version ver = wait(version);
+		wait(watchValuesBatch(cx, parameters, std::move(indices), ver));
+	} catch (Error& e) {
+		if (e.code() == error_code_operation_cancelled) {
+			throw;
+		}
+		for (auto& promise : parameters->promises) {
+			if (promise.canBeSet()) {
+				promise.sendError(e);
+			}
+		}
+	}
+	return Void();
+}
+
 template <class GetKeyValuesFamilyRequest>
 void transformRangeLimits(GetRangeLimits limits, Reverse reverse, GetKeyValuesFamilyRequest& req) {
 	if (limits.bytes != 0) {
@@ -5529,6 +5820,12 @@ void debugAddTags(Reference<TransactionState> trState) {
 Transaction::Transaction()
   : trState(makeReference<TransactionState>(TaskPriority::DefaultEndpoint, generateSpanID(false))) {}
 
+// Learns the size commit requests usually reach, so that a transaction's request starts out with an arena large enough
+static ArenaSizeHint& commitRequestArenaSizeHint() {
+	static ArenaSizeHint hint("CommitTransactionRequest");
+	return hint;
+}
+
 Transaction::Transaction(Database const& cx, Optional<Reference<Tenant>> const& tenant)
   : trState(makeReference<TransactionState>(cx,
                                             tenant,
@@ -5536,6 +5833,7 @@ Transaction::Transaction(Database const& cx, Optional<Reference<Tenant>> const&
                                             generateSpanID(cx->transactionTracingSample),
                                             createTrLogInfoProbabilistically(cx))),
     span(trState->spanContext, "Transaction"_loc), backoff(CLIENT_KNOBS->DEFAULT_BACKOFF), tr(trState->spanContext) {
+	tr.arena = Arena(commitRequestArenaSizeHint().reserveSize());
 	if (DatabaseContext::debugUseTags) {
 		debugAddTags(trState);
 	}
@@ -5544,15 +5842,18 @@ Transaction::Transaction(Database const& cx, Optional<Reference<Tenant>> const&
 Transaction::~Transaction() {
 	flushTrLogsIfEnabled();
 	cancelWatches();
+	discardReadAhead();
 }
 
 void Transaction::operator=(Transaction&& r) noexcept {
 	flushTrLogsIfEnabled();
+	discardReadAhead();
 	tr = std::move(r.tr);
 	trState = std::move(r.trState);
 	extraConflictRanges = std::move(r.extraConflictRanges);
 	commitResult = std::move(r.commitResult);
 	committing = std::move(r.committing);
+	rangeReadAhead = std::move(r.rangeReadAhead);
 	backoff = r.backoff;
 	watches = r.watches;
 }
@@ -5581,6 +5882,11 @@ void Transaction::setVersion(Version v) {
 	trState->readVersionObtainedFromGrvProxy = false;
 }
 
+void Transaction::setSnapshotVersion(Version v) {
+	setVersion(v);
+	trState->readOptions.withDefault(ReadOptions()).retainVersion = true;
+}
+
 Future<Optional<Value>> Transaction::get(const Key& key, Snapshot snapshot) {
 	++trState->cx->transactionLogicalReads;
 	++trState->cx->transactionGetValueRequests;
@@ -5845,6 +6151,288 @@ Future<Key> Transaction::getKey(const KeySelector& key, Snapshot snapshot) {
 	return getKeyAndConflictRange(trState, key, conflictRange);
 }
 
+bool RangeReadAhead::canServe(KeySelector const& begin,
+                              KeySelector const& end,
+                              Snapshot snapshot,
+                              Reverse reverse) const {
+	if (!started || serving || cancelled || snapshot != this->snapshot || reverse != this->reverse ||
+	    begin.offset != 1 || end.offset != 1) {
+		return false;
+	}
+	// One side of the scan is fixed, and the other has to start where the last result left off
+	if (reverse) {
+		return begin.getKey() == remaining.begin && end.getKey() >= remaining.end && end.getKey() <= lastServed;
+	}
+	return end.getKey() == remaining.end && begin.getKey() >= lastServed && begin.getKey() <= remaining.begin;
+}
+
+void RangeReadAhead::take(RangeResult& output, GetRangeLimits& limits) {
+	bool consumedAny = false;
+	while (!limits.isReached() && !fragments.empty()) {
+		RangeReadAheadFragment& fragment = *fragments.front();
+		if (!fragment.chunks.empty()) {
+			RangeResult& chunk = fragment.chunks.front();
+			int first = fragment.served;
+			while (fragment.served < chunk.size() && !limits.isReached()) {
+				limits.decrement(chunk[fragment.served++]);
+			}
+			if (fragment.served > first) {
+				output.arena().dependsOn(chunk.arena());
+				output.append(output.arena(), chunk.begin() + first, fragment.served - first);
+				KeyRef last = output.back().key;
+				remaining = reverse ? KeyRangeRef(remaining.begin, last) : KeyRangeRef(keyAfter(last), remaining.end);
+			}
+			if (fragment.served == chunk.size()) {
+				bufferedBytes -= chunk.expectedSize();
+				fragment.chunks.pop_front();
+				fragment.served = 0;
+				consumedAny = true;
+			}
+			continue;
+		}
+
+		// Everything read from this fragment has been served, and there are no other keys up to its read through point
+		if (reverse ? fragment.readThrough < remaining.end : fragment.readThrough > remaining.begin) {
+			remaining = reverse ? KeyRangeRef(remaining.begin, fragment.readThrough)
+			                    : KeyRangeRef(fragment.readThrough, remaining.end);
+		}
+		if (!fragment.done) {
+			break;
+		}
+		fragments.pop_front();
+		consumedAny = true;
+	}
+	if (consumedAny) {
+		consumed.trigger();
+	}
+}
+
+bool RangeReadAhead::stalled() const {
+	if (cancelled) {
+		return true;
+	}
+	if (fragments.empty()) {
+		return splitFailed && !unassigned.empty();
+	}
+	return fragments.front()->failed && fragments.front()->chunks.empty();
+}
+
+int RangeReadAhead::discard() {
+	int chunks = 0;
+	for (auto& fragment : fragments) {
+		chunks += fragment->chunks.size();
+		fragment->reader = Future<Void>();
+	}
+	fragments.clear();
+	bufferedBytes = 0;
+	reader = Future<Void>();
+	cancelled = true;
+	changed.trigger();
+	return chunks;
+}
+
+// Reads one fragment of a range scan ahead of the application, one chunk at a time.  A failed read stops the
+// fragment; the error is only seen by the application if it reads that part of the range without read-ahead.
+ACTOR static Future<Void> readRangeAheadFragment(Reference<TransactionState> trState,
+                                                 Reference<RangeReadAhead> readAhead,
+                                                 Reference<RangeReadAheadFragment> fragment) {
+	state Reverse reverse = readAhead->reverse;
+	loop {
+		// The fragment the application is waiting for can always read one chunk
+		while (readAhead->bufferedBytes >= CLIENT_KNOBS->RANGE_READ_AHEAD_BYTES &&
+		       (!fragment->chunks.empty() || readAhead->fragments.empty() ||
+		        readAhead->fragments.front().getPtr() != fragment.getPtr())) {
+			wait(readAhead->consumed.onTrigger());
+		}
+
+		state KeyRange keys = reverse ? KeyRangeRef(fragment->range.begin, fragment->readThrough)
+		                              : KeyRangeRef(fragment->readThrough, fragment->range.end);
+		state RangeResult chunk;
+		try {
+			// Conflict ranges are only added for the rows served to the application
+			Promise<std::pair<Key, Key>> conflictRange;
+			RangeResult _chunk =
+			    wait(::getRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(trState,
+			                                                                         firstGreaterOrEqual(keys.begin),
+			                                                                         firstGreaterOrEqual(keys.end),
+			                                                                         ""_sr,
+			                                                                         readAhead->chunkLimits,
+			                                                                         conflictRange,
+			                                                                         Snapshot::True,
+			                                                                         reverse));
+			chunk = _chunk;
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			fragment->failed = true;
+			readAhead->changed.trigger();
+			return Void();
+		}
+
+		if (chunk.more) {
+			fragment->readThrough = chunk.getReadThrough(reverse);
+		} else {
+			fragment->readThrough = reverse ? fragment->range.begin : fragment->range.end;
+		}
+		fragment->done = reverse ? fragment->readThrough <= fragment->range.begin
+		                         : fragment->readThrough >= fragment->range.end;
+		if (!chunk.empty()) {
+			readAhead->bufferedBytes += chunk.expectedSize();
+			fragment->chunks.push_back(std::move(chunk));
+		}
+		readAhead->changed.trigger();
+		if (fragment->done) {
+			return Void();
+		}
+	}
+}
+
+// Waits for the first result of a scan and, if there is more to it, splits the rest of the range into one fragment
+// per shard and keeps up to maxFragments of them reading ahead of the application.
+ACTOR static Future<Void> readRangeAhead(Reference<TransactionState> trState,
+                                         Reference<RangeReadAhead> readAhead,
+                                         Future<RangeResult> first,
+                                         KeySelector begin,
+                                         KeySelector end) {
+	state Reverse reverse = readAhead->reverse;
+	state RangeResult result;
+	try {
+		RangeResult _result = wait(first);
+		result = _result;
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		return Void();
+	}
+	// Only a scan whose fixed side resolves to a key boundary can be split at shard boundaries
+	if (!result.more || (result.empty() && !result.readThrough.present()) || (reverse ? begin : end).offset != 1) {
+		return Void();
+	}
+
+	Key next = result.getReadThrough(reverse);
+	if (reverse) {
+		readAhead->remaining = KeyRangeRef(begin.getKey(), std::max<KeyRef>(next, begin.getKey()));
+		readAhead->lastServed = result.empty() ? readAhead->remaining.end : Key(result.back().key, result.arena());
+	} else {
+		readAhead->remaining = KeyRangeRef(std::min<KeyRef>(next, end.getKey()), end.getKey());
+		readAhead->lastServed = result.empty() ? readAhead->remaining.begin : keyAfter(result.back().key);
+	}
+	readAhead->unassigned = readAhead->remaining;
+	readAhead->started = true;
+
+	loop {
+		while (readAhead->fragments.size() >= readAhead->maxFragments) {
+			wait(readAhead->consumed.onTrigger());
+		}
+		if (readAhead->unassigned.empty()) {
+			return Void();
+		}
+
+		state std::vector<KeyRangeLocationInfo> locations;
+		try {
+			std::vector<KeyRangeLocationInfo> _locations =
+			    wait(getKeyRangeLocations(trState,
+			                              readAhead->unassigned,
+			                              readAhead->maxFragments - readAhead->fragments.size(),
+			                              reverse,
+			                              &StorageServerInterface::getKeyValues,
+			                              UseTenant::True));
+			locations = _locations;
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			readAhead->splitFailed = true;
+			readAhead->changed.trigger();
+			return Void();
+		}
+
+		for (const auto& location : locations) {
+			// The fragments have to cover the scan without gaps
+			KeyRange range = location.range & readAhead->unassigned;
+			if (range.empty() || (reverse ? range.end != readAhead->unassigned.end
+			                              : range.begin != readAhead->unassigned.begin)) {
+				break;
+			}
+			auto fragment = makeReference<RangeReadAheadFragment>();
+			fragment->range = range;
+			fragment->readThrough = reverse ? range.end : range.begin;
+			readAhead->unassigned = reverse ? KeyRangeRef(readAhead->unassigned.begin, range.begin)
+			                                : KeyRangeRef(range.end, readAhead->unassigned.end);
+			readAhead->fragments.push_back(fragment);
+			fragment->reader = readRangeAheadFragment(trState, readAhead, fragment);
+		}
+		readAhead->changed.trigger();
+	}
+}
+
+// Serves a read of a scan from the fragments read ahead, waiting for them if needed.  If read-ahead stops before any
+// rows are served, the read is done directly instead.
+ACTOR static Future<RangeResult> readFromReadAhead(Reference<TransactionState> trState,
+                                                   Reference<RangeReadAhead> readAhead,
+                                                   KeySelector begin,
+                                                   KeySelector end,
+                                                   GetRangeLimits limits,
+                                                   Promise<std::pair<Key, Key>> conflictRange) {
+	state Reverse reverse = readAhead->reverse;
+	state GetRangeLimits originalLimits = limits;
+	state Key start = reverse ? end.getKey() : begin.getKey();
+	state RangeResult output;
+	state bool exhausted = false;
+
+	readAhead->serving = true;
+	try {
+		loop {
+			readAhead->take(output, limits);
+			exhausted = readAhead->exhausted() && !readAhead->cancelled;
+			if (limits.isReached() || exhausted || (!output.empty() && limits.hasSatisfiedMinRows()) ||
+			    (!output.empty() && readAhead->stalled())) {
+				break;
+			}
+			if (readAhead->stalled()) {
+				readAhead->serving = false;
+				RangeResult result = wait(::getRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+				    trState, begin, end, ""_sr, originalLimits, conflictRange, readAhead->snapshot, reverse));
+				return result;
+			}
+			wait(readAhead->changed.onTrigger());
+		}
+	} catch (Error& e) {
+		readAhead->serving = false;
+		throw;
+	}
+	readAhead->serving = false;
+
+	// Like the reads of a storage server, a partial result ends at the next key to read if that is not the key after
+	// the last row
+	const KeyRangeRef remaining = readAhead->remaining;
+	output.more = !exhausted || limits.isReached();
+	if (output.more) {
+		KeyRef next = reverse ? remaining.end : remaining.begin;
+		if (output.empty() || (reverse ? next != output.back().key : next != keyAfter(output.back().key))) {
+			output.setReadThrough(KeyRef(output.arena(), next));
+		}
+	}
+	if (!readAhead->cancelled) {
+		if (reverse) {
+			readAhead->lastServed = output.empty() ? start : Key(output.back().key, output.arena());
+		} else {
+			readAhead->lastServed = output.empty() ? start : keyAfter(output.back().key);
+		}
+	}
+
+	if (!readAhead->snapshot) {
+		if (reverse) {
+			conflictRange.send(std::make_pair(Key(output.more ? remaining.end : remaining.begin), start));
+		} else {
+			conflictRange.send(std::make_pair(start, Key(output.more ? remaining.begin : remaining.end)));
+		}
+	}
+	return output;
+}
+
 template <class GetKeyValuesFamilyRequest>
 void increaseCounterForRequest(Database cx) {
 	if constexpr (std::is_same<GetKeyValuesFamilyRequest, GetKeyValuesRequest>::value) {
@@ -5897,6 +6485,12 @@ Future<RangeResultFamily> Transaction::getRangeInternal(const KeySelector& begin
 		// you don't want RYW, you may use ReadYourWrites APIs with RYW disabled.)
 		throw unsupported_operation();
 	}
+	if constexpr (std::is_same_v<RangeResultFamily, RangeResult>) {
+		if (trState->options.rangeReadAheadBatches > 0) {
+			return getRangeWithReadAhead(b, e, limits, snapshot, reverse);
+		}
+	}
+
 	Promise<std::pair<Key, Key>> conflictRange;
 	if (!snapshot) {
 		extraConflictRanges.push_back(conflictRange.getFuture());
@@ -5906,6 +6500,56 @@ Future<RangeResultFamily> Transaction::getRangeInternal(const KeySelector& begin
 	    trState, b, e, mapper, limits, conflictRange, snapshot, reverse);
 }
 
+// Serves the read from the fragments read ahead if it continues the scan being read ahead.  Otherwise the application
+// has moved on to another range: the fragments are discarded, and reading ahead restarts after this read.
+Future<RangeResult> Transaction::getRangeWithReadAhead(const KeySelector& begin,
+                                                       const KeySelector& end,
+                                                       GetRangeLimits limits,
+                                                       Snapshot snapshot,
+                                                       Reverse reverse) {
+	Promise<std::pair<Key, Key>> conflictRange;
+	if (!snapshot) {
+		extraConflictRanges.push_back(conflictRange.getFuture());
+	}
+
+	if (rangeReadAhead && rangeReadAhead->canServe(begin, end, snapshot, reverse)) {
+		++trState->cx->transactionRangeReadAheadHits;
+		return readFromReadAhead(trState, rangeReadAhead, begin, end, limits, conflictRange);
+	}
+
+	Future<RangeResult> result = ::getRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+	    trState, begin, end, ""_sr, limits, conflictRange, snapshot, reverse);
+
+	// A concurrent read of the scan being served does not restart it
+	if (rangeReadAhead && rangeReadAhead->serving) {
+		return result;
+	}
+	discardReadAhead();
+
+	// Each fragment is read in chunks of the size of this read, and the bytes buffered for the scan are bounded by the
+	// knob, but one fragment can always be read
+	rangeReadAhead = makeReference<RangeReadAhead>();
+	rangeReadAhead->snapshot = snapshot;
+	rangeReadAhead->reverse = reverse;
+	int64_t chunkBytes = limits.hasByteLimit() ? std::min<int64_t>(limits.bytes, CLIENT_KNOBS->REPLY_BYTE_LIMIT)
+	                                           : CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+	rangeReadAhead->chunkLimits = GetRangeLimits(GetRangeLimits::ROW_LIMIT_UNLIMITED, chunkBytes);
+	rangeReadAhead->maxFragments = std::min<int64_t>(
+	    trState->options.rangeReadAheadBatches, std::max<int64_t>(1, CLIENT_KNOBS->RANGE_READ_AHEAD_BYTES / chunkBytes));
+	rangeReadAhead->reader = readRangeAhead(trState, rangeReadAhead, result, begin, end);
+	return result;
+}
+
+void Transaction::discardReadAhead() {
+	if (rangeReadAhead) {
+		int chunks = rangeReadAhead->discard();
+		if (trState) {
+			trState->cx->transactionRangeReadAheadWasted += chunks;
+		}
+		rangeReadAhead.clear();
+	}
+}
+
 Future<RangeResult> Transaction::getRange(const KeySelector& begin,
                                           const KeySelector& end,
                                           GetRangeLimits limits,
@@ -6216,6 +6860,7 @@ void TransactionOptions::clear() {
 	bypassStorageQuota = false;
 	enableReplicaConsistencyCheck = false;
 	requiredReplicas = 0;
+	rangeReadAheadBatches = CLIENT_KNOBS->RANGE_READ_AHEAD_BATCHES;
 }
 
 TransactionOptions::TransactionOptions() {
@@ -6232,8 +6877,10 @@ void TransactionOptions::reset(Database const& cx) {
 
 void Transaction::resetImpl(bool generateNewSpan) {
 	flushTrLogsIfEnabled();
+	discardReadAhead();
 	trState = trState->cloneAndReset(createTrLogInfoProbabilistically(trState->cx), generateNewSpan);
 	tr = CommitTransactionRequest(trState->spanContext);
+	tr.arena = Arena(commitRequestArenaSizeHint().reserveSize());
 	extraConflictRanges.clear();
 	commitResult = Promise<Void>();
 	committing = Future<Void>();
@@ -6486,6 +7133,29 @@ void Transaction::setupWatches() {
 	try {
 		Future<Version> watchVersion = getCommittedVersion() > 0 ? getCommittedVersion() : getReadVersion();
 
+		if (watches.size() >= CLIENT_KNOBS->WATCH_BATCH_MIN_KEYS) {
+			// Register the watches with one request per storage location instead of one per key
+			Standalone<VectorRef<WatchedValueRef>> keys;
+			keys.reserve(keys.arena(), watches.size());
+			for (const auto& watch : watches) {
+				keys.push_back_deep(keys.arena(), WatchedValueRef(watch->key, watch->value.castTo<ValueRef>()));
+			}
+			auto parameters = makeReference<WatchValuesParameters>(
+			    trState->getTenantInfo(),
+			    keys,
+			    trState->options.readTags,
+			    trState->spanContext,
+			    trState->taskID,
+			    trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
+			    trState->useProvisionalProxies);
+			Future<Void> batch = watchValuesBatchMap(watchVersion, trState->cx, parameters);
+			for (int i = 0; i < watches.size(); ++i)
+				watches[i]->setWatch(holdWhile(batch, parameters->promises[i].getFuture()));
+
+			watches.clear();
+			return;
+		}
+
 		for (int i = 0; i < watches.size(); ++i)
 			watches[i]->setWatch(
 			    watchValueMap(watchVersion,
@@ -6689,6 +7359,24 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 		}
 
 		req.debugID = commitID;
+
+		// req keeps the plain mutations for accounting and logging; sentReq is what goes over the wire
+		state CommitTransactionRequest sentReq = req;
+		{
+			int mutationBytes = req.transaction.mutations.expectedSize();
+			if (CLIENT_KNOBS->COMMIT_COMPRESS_MUTATIONS &&
+			    mutationBytes >= CLIENT_KNOBS->COMMIT_COMPRESS_MUTATIONS_MIN_BYTES) {
+				CompressionFilter filter = CompressionFilter::NONE;
+				if (mutationBytes >= CLIENT_KNOBS->COMMIT_ZSTD_MUTATIONS_MIN_BYTES &&
+				    CompressionUtils::supportedFilters.count(CompressionFilter::ZSTD)) {
+					filter = CompressionFilter::ZSTD;
+				}
+				sentReq.compressMutations(filter);
+				mutationBytes = sentReq.compressedMutations.get().data.size();
+			}
+			trState->cx->transactionCommitMutationBytesSent += mutationBytes;
+		}
+
 		state Future<CommitID> reply;
 		// Only gets filled in in the happy path where we don't have to commit on the first proxy or use provisional
 		// proxies
@@ -6699,17 +7387,18 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 		if (trState->options.commitOnFirstProxy) {
 			if (trState->cx->clientInfo->get().firstCommitProxy.present()) {
 				reply = throwErrorOr(brokenPromiseToMaybeDelivered(
-				    trState->cx->clientInfo->get().firstCommitProxy.get().commit.tryGetReply(req)));
+				    trState->cx->clientInfo->get().firstCommitProxy.get().commit.tryGetReply(sentReq)));
 			} else {
 				const std::vector<CommitProxyInterface>& proxies = trState->cx->clientInfo->get().commitProxies;
-				reply = proxies.size() ? throwErrorOr(brokenPromiseToMaybeDelivered(proxies[0].commit.tryGetReply(req)))
-				                       : Never();
+				reply = proxies.size()
+				            ? throwErrorOr(brokenPromiseToMaybeDelivered(proxies[0].commit.tryGetReply(sentReq)))
+				            : Never();
 			}
 		} else {
 			proxiesUsed = trState->cx->getCommitProxies(trState->useProvisionalProxies);
 			reply = basicLoadBalance(proxiesUsed,
 			                         &CommitProxyInterface::commit,
-			                         req,
+			                         sentReq,
 			                         TaskPriority::DefaultPromiseEndpoint,
 			                         AtMostOnce::True,
 			                         &alternativeChosen);
@@ -6866,6 +7555,66 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 	}
 }
 
+// Removes the mutations in a transaction which have no effect because a later set or clear in the same transaction
+// overwrites every key they touch, and returns how many were removed. Mutations of system keys are always kept since
+// commit proxies act on them individually, as are versionstamp operations.
+static int coalesceMutations(Arena& arena, VectorRef<MutationRef>& mutations) {
+	if (mutations.size() < 2) {
+		return 0;
+	}
+
+	std::unordered_set<StringRef> setLater;
+	Optional<CoalescedKeyRangeMap<bool>> clearedLater;
+	auto isClearedLater = [&](KeyRangeRef keys) {
+		if (!clearedLater.present()) {
+			return false;
+		}
+		auto r = clearedLater.get().rangeContaining(keys.begin);
+		return r.value() && r.end() >= keys.end;
+	};
+
+	std::vector<bool> keep(mutations.size(), true);
+	int removed = 0;
+	for (int i = mutations.size() - 1; i >= 0; i--) {
+		MutationRef const& m = mutations[i];
+		if (m.type == MutationRef::ClearRange) {
+			KeyRangeRef keys(m.param1, m.param2);
+			if (keys.end > normalKeys.end) {
+				continue;
+			}
+			if (isClearedLater(keys) || (keys.singleKeyRange() && setLater.count(keys.begin))) {
+				keep[i] = false;
+				removed++;
+				continue;
+			}
+			if (!clearedLater.present()) {
+				clearedLater.emplace(false);
+			}
+			clearedLater.get().insert(keys, true);
+		} else if (m.param1 < normalKeys.end && m.type != MutationRef::SetVersionstampedKey &&
+		           m.type != MutationRef::SetVersionstampedValue &&
+		           (m.type == MutationRef::SetValue || m.isAtomicOp())) {
+			if (setLater.count(m.param1) || (clearedLater.present() && clearedLater.get()[m.param1])) {
+				keep[i] = false;
+				removed++;
+			} else if (m.type == MutationRef::SetValue) {
+				setLater.insert(m.param1);
+			}
+		}
+	}
+
+	if (removed) {
+		int size = 0;
+		for (int i = 0; i < mutations.size(); i++) {
+			if (keep[i]) {
+				mutations[size++] = mutations[i];
+			}
+		}
+		mutations.resize(arena, size);
+	}
+	return removed;
+}
+
 Future<Void> Transaction::commitMutations() {
 	try {
 		// if this is a read-only transaction return immediately
@@ -6960,6 +7709,11 @@ Future<Void> Transaction::commitMutations() {
 			tr.transaction.report_conflicting_keys = true;
 		}
 
+		if (CLIENT_KNOBS->COMMIT_COALESCE_MUTATIONS) {
+			trState->cx->transactionCoalescedMutations += coalesceMutations(tr.arena, tr.transaction.mutations);
+		}
+
+		commitRequestArenaSizeHint().record(tr.arena);
 		Future<Void> commitResult = tryCommit(trState, tr);
 
 		if (isCheckingWrites) {
@@ -7145,6 +7899,11 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		trState->options.sizeLimit = extractIntOption(value, 32, CLIENT_KNOBS->TRANSACTION_SIZE_LIMIT);
 		break;
 
+	case FDBTransactionOptions::RANGE_READ_AHEAD:
+		validateOptionValuePresent(value);
+		trState->options.rangeReadAheadBatches = extractIntOption(value, 0, 100);
+		break;
+
 	case FDBTransactionOptions::LOCK_AWARE:
 		validateOptionValueNotPresent(value);
 		if (!trState->readOptions.present()) {
@@ -7299,6 +8058,11 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		trState->readOptions.withDefault(ReadOptions()).type = ReadType::HIGH;
 		break;
 
+	case FDBTransactionOptions::RETAIN_READ_VERSION:
+		validateOptionValueNotPresent(value);
+		trState->readOptions.withDefault(ReadOptions()).retainVersion = true;
+		break;
+
 	case FDBTransactionOptions::ENABLE_REPLICA_CONSISTENCY_CHECK:
 		validateOptionValueNotPresent(value);
 		trState->options.enableReplicaConsistencyCheck = true;
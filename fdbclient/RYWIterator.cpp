@@ -719,7 +719,10 @@ TEST_CASE("/fdbclient/WriteMap/random") {
 			bool addConflict = deterministicRandom()->random01() < 0.5;
 			KeyRef key = RandomTestImpl::getRandomKey(arena);
 			ValueRef value = RandomTestImpl::getRandomValue(arena);
-			writes.mutate(key, MutationRef::SetValue, value, addConflict);
+			if (deterministicRandom()->coinflip())
+				writes.set(key, value, addConflict);
+			else
+				writes.mutate(key, MutationRef::SetValue, value, addConflict);
 			if (unreadableMap[key])
 				setMap[key].push(RYWMutation(value, MutationRef::SetValue));
 			else
@@ -729,6 +732,11 @@ TEST_CASE("/fdbclient/WriteMap/random") {
 			clearMap.insert(key, false);
 			TraceEvent("RWMT_Set").detail("Key", key).detail("Value", value.size()).detail("AddConflict", addConflict);
 		}
+
+		if (deterministicRandom()->random01() < 0.05) {
+			// Reading merges any buffered sets
+			WriteMap::iterator read(&writes);
+		}
 	}
 
 	WriteMap::iterator it(&writes);
@@ -2350,7 +2350,10 @@ void ReadYourWritesTransaction::set(const KeyRef& key, const ValueRef& value) {
 	KeyRef k = KeyRef(arena, key);
 	ValueRef v = ValueRef(arena, value);
 
-	writes.mutate(k, MutationRef::SetValue, v, addWriteConflict);
+	if (CLIENT_KNOBS->RYW_BUFFER_BLIND_SETS)
+		writes.set(k, v, addWriteConflict);
+	else
+		writes.mutate(k, MutationRef::SetValue, v, addWriteConflict);
 	RYWImpl::triggerWatches(this, key, value);
 }
 
@@ -534,6 +534,44 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
          "transaction_start_seconds":0.0,
          "commit_seconds":0.02
       },
+      "latency_statistics":{
+         "read":{
+            "count":0,
+            "min":0.0,
+            "max":0.0,
+            "median":0.0,
+            "mean":0.0,
+            "p25":0.0,
+            "p90":0.0,
+            "p95":0.0,
+            "p99":0.0,
+            "p99.9":0.0
+         },
+         "commit":{
+            "count":0,
+            "min":0.0,
+            "max":0.0,
+            "median":0.0,
+            "mean":0.0,
+            "p25":0.0,
+            "p90":0.0,
+            "p95":0.0,
+            "p99":0.0,
+            "p99.9":0.0
+         },
+         "grv":{
+            "count":0,
+            "min":0.0,
+            "max":0.0,
+            "median":0.0,
+            "mean":0.0,
+            "p25":0.0,
+            "p90":0.0,
+            "p95":0.0,
+            "p99":0.0,
+            "p99.9":0.0
+         }
+      },
       "clients":{
          "count":1,
          "supported_versions":[
@@ -441,6 +441,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 
 	// KeyValueStoreMemory
 	init( REPLACE_CONTENTS_BYTES,                                1e5 );
+	init( KVS_MEMORY_RECOVERY_THREADS,                             4 ); if( randomize && BUGGIFY ) KVS_MEMORY_RECOVERY_THREADS = deterministicRandom()->randomInt(0, 3);
+	init( KVS_MEMORY_RECOVERY_PARTITION_BYTES,                   1e6 ); if( randomize && BUGGIFY ) KVS_MEMORY_RECOVERY_PARTITION_BYTES = deterministicRandom()->randomInt(1, 1e4);
 
 	// KeyValueStoreRocksDB
 	init( ROCKSDB_SET_READ_TIMEOUT,         		    !isSimulated );
@@ -609,6 +611,13 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SHARDED_ROCKSDB_MAX_OPEN_FILES,                      50000 ); // Should be smaller than OS's fd limit.
 	init (SHARDED_ROCKSDB_READ_ASYNC_IO,                       false ); if (isSimulated) SHARDED_ROCKSDB_READ_ASYNC_IO = deterministicRandom()->coinflip();
 	init( SHARDED_ROCKSDB_PREFIX_LEN,                              0 ); if( randomize && BUGGIFY )  SHARDED_ROCKSDB_PREFIX_LEN = deterministicRandom()->randomInt(1, 20);
+	init( SHARDED_ROCKSDB_SHARD_PROFILE_INTERVAL,               60.0 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_SHARD_PROFILE_INTERVAL = deterministicRandom()->coinflip() ? 0.0 : 5.0;
+	init( SHARDED_ROCKSDB_WRITE_HEAVY_BYTES_PER_SEC,             1e6 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_WRITE_HEAVY_BYTES_PER_SEC = 1e3;
+	init( SHARDED_ROCKSDB_READ_HOT_OPS_PER_SEC,                  1e3 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_READ_HOT_OPS_PER_SEC = 10;
+	init( SHARDED_ROCKSDB_COLD_OPS_PER_SEC,                      1.0 );
+	init( SHARDED_ROCKSDB_WRITE_HEAVY_L0_TRIGGER_MULTIPLIER,       4 );
+	init( SHARDED_ROCKSDB_WRITE_HEAVY_WRITE_BUFFER_MULTIPLIER,     2 );
+	init( SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE,                     0 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE = 16384;
 
 
 	// Leader election
@@ -638,6 +647,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( KEY_LOCATION_MAX_QUEUE_SIZE,                           1e6 );
 	init( TENANT_ID_REQUEST_MAX_QUEUE_SIZE,                      1e6 );
 	init( BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE,                  1e5 ); if ( randomize && BUGGIFY ) BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE = 100;
+	init( SHARD_MAP_WATCH_MAX_QUEUE_SIZE,                        1e4 ); if ( randomize && BUGGIFY ) SHARD_MAP_WATCH_MAX_QUEUE_SIZE = 10;
+	init( SHARD_MAP_WATCH_TIMEOUT,                              30.0 ); if ( randomize && BUGGIFY ) SHARD_MAP_WATCH_TIMEOUT = 1.0;
+	init( SHARD_MAP_WATCH_MAX_RESULTS,                          1000 ); if ( randomize && BUGGIFY ) SHARD_MAP_WATCH_MAX_RESULTS = 1;
+	init( SHARD_MAP_CHANGE_LOG_SIZE,                           10000 ); if ( randomize && BUGGIFY ) SHARD_MAP_CHANGE_LOG_SIZE = 2;
 	init( COMMIT_PROXY_LIVENESS_TIMEOUT,                        20.0 );
 	init( COMMIT_PROXY_MAX_LIVENESS_TIMEOUT,                   600.0 ); if ( randomize && BUGGIFY ) COMMIT_PROXY_MAX_LIVENESS_TIMEOUT = 20.0;
 
@@ -1012,6 +1025,11 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( MIN_BYTE_SAMPLING_PROBABILITY,                           0 );
 
 	init( MAX_STORAGE_SERVER_WATCH_BYTES,                      100e6 ); if( randomize && BUGGIFY ) MAX_STORAGE_SERVER_WATCH_BYTES = 10e3;
+	init( WATCH_VALUES_BATCH_DELAY,                            0.001 ); if( randomize && BUGGIFY ) WATCH_VALUES_BATCH_DELAY = deterministicRandom()->random01() * 0.1;
+	init( WATCH_VALUES_READ_PARALLELISM,                        1000 ); if( randomize && BUGGIFY ) WATCH_VALUES_READ_PARALLELISM = 1;
+	init( STORAGE_SNAPSHOT_RETENTION_TIME,                      10.0 ); if( randomize && BUGGIFY ) STORAGE_SNAPSHOT_RETENTION_TIME = 1.0;
+	init( STORAGE_SNAPSHOT_MAX_RETAINED_VERSIONS, 60 * VERSIONS_PER_SECOND ); if( randomize && BUGGIFY ) STORAGE_SNAPSHOT_MAX_RETAINED_VERSIONS = deterministicRandom()->randomInt(1, 20) * VERSIONS_PER_SECOND;
+	init( STORAGE_SNAPSHOT_RETENTION_MAX_QUEUE_BYTES,          500e6 ); if( randomize && BUGGIFY ) STORAGE_SNAPSHOT_RETENTION_MAX_QUEUE_BYTES = 1e6;
 	init( MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE,                        1e9 ); if( randomize && BUGGIFY ) MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE = 1e3;
 	init( LONG_BYTE_SAMPLE_RECOVERY_DELAY,                      60.0 );
 	init( BYTE_SAMPLE_LOAD_PARALLELISM,                            8 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_PARALLELISM = 1;
@@ -1165,6 +1183,13 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( FASTRESTORE_RATE_UPDATE_SECONDS,                       1.0 ); if( randomize && BUGGIFY ) { FASTRESTORE_RATE_UPDATE_SECONDS = deterministicRandom()->random01() < 0.5 ? 0.1 : 2;}
 	init( FASTRESTORE_DUMP_INSERT_RANGE_VERSION,               false );
 
+	// Storage engine cache budget
+	init( CACHE_BUDGET_BROKER_BYTES,                               0 ); if( randomize && BUGGIFY ) CACHE_BUDGET_BROKER_BYTES = deterministicRandom()->randomInt64(1e6, 1e8);
+	init( CACHE_BUDGET_BROKER_INTERVAL,                         10.0 ); if( randomize && BUGGIFY ) CACHE_BUDGET_BROKER_INTERVAL = 1.0;
+	init( CACHE_BUDGET_BROKER_STEP_FRACTION,                    0.05 );
+	init( CACHE_BUDGET_BROKER_MIN_SHARE,                        0.25 );
+	init( CACHE_BUDGET_BROKER_FULL_RATIO,                        0.9 );
+
 	init( REDWOOD_DEFAULT_PAGE_SIZE,                            8192 );
 	init( REDWOOD_DEFAULT_EXTENT_SIZE,              32 * 1024 * 1024 );
 	init( REDWOOD_DEFAULT_EXTENT_READ_SIZE,              1024 * 1024 );
@@ -1183,6 +1208,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REDWOOD_EVICT_UPDATED_PAGES,                          true ); if( randomize && BUGGIFY ) { REDWOOD_EVICT_UPDATED_PAGES = false; }
 	init( REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT,                    2 ); if( randomize && BUGGIFY ) { REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT = deterministicRandom()->randomInt(1, 7); }
 	init( REDWOOD_NODE_MAX_UNBALANCE,                              2 );
+	init( REDWOOD_LEAF_FILTER_BITS_PER_KEY,                        0 ); if( randomize && BUGGIFY ) REDWOOD_LEAF_FILTER_BITS_PER_KEY = deterministicRandom()->randomInt(1, 20);
+	init( REDWOOD_LEAF_FILTER_MAX_BYTES,                       100e6 ); if( randomize && BUGGIFY ) REDWOOD_LEAF_FILTER_MAX_BYTES = deterministicRandom()->randomInt(0, 100e3);
 	init( REDWOOD_IO_PRIORITIES,                       "32,32,32,32" );
 
 	// Server request latency measurement
@@ -21,6 +21,16 @@
 #include "fdbclient/Tuple.h"
 #include "flow/UnitTest.h"
 
+#include <bit>
+
+#if defined(__aarch64__)
+#include "flow/sse2neon.h"
+#define TUPLE_SIMD 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TUPLE_SIMD 1
+#endif
+
 const uint8_t VERSIONSTAMP_96_CODE = 0x33;
 const uint8_t USER_TYPE_START = 0x40;
 const uint8_t USER_TYPE_END = 0x4f;
@@ -38,13 +48,73 @@ static double bigEndianDouble(double orig) {
 	return *(double*)&big;
 }
 
+const uint8_t* TupleElementCodec::findZero(const uint8_t* begin, const uint8_t* end) {
+#ifdef TUPLE_SIMD
+	const __m128i zero = _mm_setzero_si128();
+	for (; end - begin >= 16; begin += 16) {
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)begin), zero));
+		if (mask) {
+			return begin + std::countr_zero((unsigned)mask);
+		}
+	}
+#endif
+	while (begin != end && *begin) {
+		++begin;
+	}
+	return begin;
+}
+
+size_t TupleElementCodec::countZeros(const uint8_t* begin, const uint8_t* end) {
+	size_t count = 0;
+#ifdef TUPLE_SIMD
+	const __m128i zero = _mm_setzero_si128();
+	for (; end - begin >= 16; begin += 16) {
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)begin), zero));
+		count += std::popcount((unsigned)mask);
+	}
+#endif
+	for (; begin != end; ++begin) {
+		count += !*begin;
+	}
+	return count;
+}
+
+// Returns the offset of the zero byte terminating the string starting at data[offset], skipping escaped zero bytes
 static size_t findStringTerminator(const StringRef data, size_t offset) {
-	size_t i = offset;
-	while (i < data.size() - 1 && !(data[i] == '\x00' && data[i + 1] != (uint8_t)'\xff')) {
-		i += (data[i] == '\x00' ? 2 : 1);
+	const uint8_t* i = data.begin() + offset;
+	const uint8_t* last = data.end() - 1;
+	while (i < last) {
+		i = TupleElementCodec::findZero(i, last);
+		if (i == last || i[1] != (uint8_t)'\xff') {
+			break;
+		}
+		i += 2;
 	}
 
-	return i;
+	return i - data.begin();
+}
+
+// Unescapes the encoded string (without its type code) in [begin, end), which may or may not include the terminator
+static StringRef unescapeString(const uint8_t* begin, const uint8_t* end, Arena& arena) {
+	const uint8_t* zero = TupleElementCodec::findZero(begin, end);
+	if (zero + 1 >= end) {
+		// No escaped zero bytes, so the string can be used in place
+		return StringRef(begin, zero - begin);
+	}
+
+	uint8_t* out = new (arena) uint8_t[end - begin];
+	uint8_t* o = out;
+	while (true) {
+		memcpy(o, begin, zero - begin);
+		o += zero - begin;
+		if (zero + 1 >= end) {
+			break;
+		}
+		*o++ = '\x00';
+		begin = zero + 2;
+		zero = TupleElementCodec::findZero(begin, end);
+	}
+	return StringRef(out, o - out);
 }
 
 // If encoding and the sign bit is 1 (the number is negative), flip all the bits.
@@ -61,6 +131,155 @@ static void adjustFloatingPoint(uint8_t* bytes, size_t size, bool encode) {
 	}
 }
 
+static int significantBytes(uint64_t value) {
+	int bytes = 0;
+	for (; value; value >>= 8) {
+		++bytes;
+	}
+	return bytes;
+}
+
+size_t TupleElementCodec::encodedSize(int64_t value) {
+	return significantBytes(value < 0 ? 0 - (uint64_t)value : (uint64_t)value) + 1;
+}
+
+// Integers are encoded as their significant big endian bytes, negative ones as the one's complement of their magnitude
+uint8_t* TupleElementCodec::encode(uint8_t* out, int64_t value) {
+	bool neg = value < 0;
+	uint64_t magnitude = neg ? 0 - (uint64_t)value : (uint64_t)value;
+	int len = significantBytes(magnitude);
+	uint64_t swap = bigEndian64(neg ? ~magnitude : magnitude);
+
+	*out++ = (uint8_t)(neg ? 0x14 - len : 0x14 + len);
+	memcpy(out, ((const uint8_t*)&swap) + 8 - len, len);
+	return out + len;
+}
+
+uint8_t* TupleElementCodec::encode(uint8_t* out, bool value) {
+	*out++ = value ? 0x27 : 0x26;
+	return out;
+}
+
+uint8_t* TupleElementCodec::encode(uint8_t* out, float value) {
+	float swap = bigEndianFloat(value);
+	adjustFloatingPoint((uint8_t*)&swap, sizeof(float), true);
+
+	*out++ = 0x20;
+	memcpy(out, &swap, sizeof(float));
+	return out + sizeof(float);
+}
+
+uint8_t* TupleElementCodec::encode(uint8_t* out, double value) {
+	double swap = bigEndianDouble(value);
+	adjustFloatingPoint((uint8_t*)&swap, sizeof(double), true);
+
+	*out++ = 0x21;
+	memcpy(out, &swap, sizeof(double));
+	return out + sizeof(double);
+}
+
+uint8_t* TupleElementCodec::encode(uint8_t* out, std::nullptr_t) {
+	*out++ = '\x00';
+	return out;
+}
+
+// Strings are terminated by a zero byte, and zero bytes within them are escaped as 0x00 0xff
+uint8_t* TupleElementCodec::encode(uint8_t* out, StringRef const& str, bool utf8) {
+	*out++ = uint8_t(utf8 ? '\x02' : '\x01');
+
+	const uint8_t* begin = str.begin();
+	const uint8_t* end = str.end();
+	while (true) {
+		const uint8_t* zero = findZero(begin, end);
+		memcpy(out, begin, zero - begin);
+		out += zero - begin;
+		if (zero == end) {
+			break;
+		}
+		*out++ = '\x00';
+		*out++ = '\xff';
+		begin = zero + 1;
+	}
+
+	*out++ = '\x00';
+	return out;
+}
+
+uint8_t* TupleElementCodec::encode(uint8_t* out, TupleVersionstamp const& versionstamp) {
+	*out++ = VERSIONSTAMP_96_CODE;
+	memcpy(out, versionstamp.begin(), versionstamp.size());
+	return out + versionstamp.size();
+}
+
+// Checks that packed holds at least size bytes of an element with one of the given codes at offset
+static uint8_t checkElement(StringRef packed, size_t offset, uint8_t minCode, uint8_t maxCode, size_t size) {
+	if (offset >= packed.size() || packed[offset] < minCode || packed[offset] > maxCode ||
+	    packed.size() - offset < size) {
+		throw invalid_tuple_data_type();
+	}
+	return packed[offset];
+}
+
+int64_t TupleElementCodec::decodeInt(StringRef packed, size_t& offset) {
+	uint8_t code = checkElement(packed, offset, 0x0c, 0x1c, 1);
+	bool neg = code < 0x14;
+	int len = neg ? 0x14 - code : code - 0x14;
+	checkElement(packed, offset, code, code, len + 1);
+
+	uint64_t swap = 0;
+	memcpy(((uint8_t*)&swap) + 8 - len, packed.begin() + offset + 1, len);
+	uint64_t bits = bigEndian64(swap);
+	offset += len + 1;
+
+	if (neg) {
+		uint64_t mask = len == 8 ? ~uint64_t(0) : (uint64_t(1) << (8 * len)) - 1;
+		return (int64_t)(0 - (~bits & mask));
+	}
+	return (int64_t)bits;
+}
+
+bool TupleElementCodec::decodeBool(StringRef packed, size_t& offset) {
+	return checkElement(packed, offset++, 0x26, 0x27, 1) == 0x27;
+}
+
+float TupleElementCodec::decodeFloat(StringRef packed, size_t& offset) {
+	checkElement(packed, offset, 0x20, 0x20, sizeof(float) + 1);
+	float swap;
+	memcpy(&swap, packed.begin() + offset + 1, sizeof(float));
+	adjustFloatingPoint((uint8_t*)&swap, sizeof(float), false);
+	offset += sizeof(float) + 1;
+	return bigEndianFloat(swap);
+}
+
+double TupleElementCodec::decodeDouble(StringRef packed, size_t& offset) {
+	checkElement(packed, offset, 0x21, 0x21, sizeof(double) + 1);
+	double swap;
+	memcpy(&swap, packed.begin() + offset + 1, sizeof(double));
+	adjustFloatingPoint((uint8_t*)&swap, sizeof(double), false);
+	offset += sizeof(double) + 1;
+	return bigEndianDouble(swap);
+}
+
+void TupleElementCodec::decodeNull(StringRef packed, size_t& offset) {
+	checkElement(packed, offset++, 0x00, 0x00, 1);
+}
+
+StringRef TupleElementCodec::decodeString(StringRef packed, size_t& offset, bool utf8, Arena& arena) {
+	uint8_t code = utf8 ? '\x02' : '\x01';
+	checkElement(packed, offset, code, code, 1);
+	size_t end = std::min(findStringTerminator(packed, offset + 1) + 1, (size_t)packed.size());
+	StringRef str = unescapeString(packed.begin() + offset + 1, packed.begin() + end, arena);
+	offset = end;
+	return str;
+}
+
+TupleVersionstamp TupleElementCodec::decodeVersionstamp(StringRef packed, size_t& offset) {
+	checkElement(packed, offset, VERSIONSTAMP_96_CODE, VERSIONSTAMP_96_CODE, VERSIONSTAMP_TUPLE_SIZE + 1);
+	TupleVersionstamp versionstamp(StringRef(packed.begin() + offset + 1, VERSIONSTAMP_TUPLE_SIZE));
+	offset += VERSIONSTAMP_TUPLE_SIZE + 1;
+	return versionstamp;
+}
+
 Tuple::Tuple(StringRef const& str, bool exclude_incomplete, bool include_user_type) {
 	data.append(data.arena(), str.begin(), str.size());
 
@@ -159,34 +378,21 @@ Tuple& Tuple::append(Tuple const& tuple) {
 	return *this;
 }
 
-Tuple& Tuple::append(TupleVersionstamp const& vs) {
+uint8_t* Tuple::appendElement(size_t size) {
 	offsets.push_back(data.size());
+	data.reserve(data.arena(), data.size() + size);
+	uint8_t* out = data.end();
+	data.extendUnsafeNoReallocNoInit(size);
+	return out;
+}
 
-	data.push_back(data.arena(), VERSIONSTAMP_96_CODE);
-	data.append(data.arena(), vs.begin(), vs.size());
-
+Tuple& Tuple::append(TupleVersionstamp const& vs) {
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(vs)), vs);
 	return *this;
 }
 
 Tuple& Tuple::append(StringRef const& str, bool utf8) {
-	offsets.push_back(data.size());
-
-	const uint8_t utfChar = uint8_t(utf8 ? '\x02' : '\x01');
-	data.append(data.arena(), &utfChar, 1);
-
-	size_t lastPos = 0;
-	for (size_t pos = 0; pos < str.size(); ++pos) {
-		if (str[pos] == '\x00') {
-			data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-			data.push_back(data.arena(), (uint8_t)'\x00');
-			data.push_back(data.arena(), (uint8_t)'\xff');
-			lastPos = pos + 1;
-		}
-	}
-
-	data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
-	data.push_back(data.arena(), (uint8_t)'\x00');
-
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(str)), str, utf8);
 	return *this;
 }
 
@@ -202,27 +408,7 @@ Tuple& Tuple::appendRaw(StringRef const& str) {
 }
 
 Tuple& Tuple::append(int64_t value) {
-	uint64_t swap = value;
-	bool neg = false;
-
-	offsets.push_back(data.size());
-
-	if (value < 0) {
-		value = ~(-value);
-		neg = true;
-	}
-
-	swap = bigEndian64(value);
-
-	for (int i = 0; i < 8; i++) {
-		if (((uint8_t*)&swap)[i] != (neg ? 255 : 0)) {
-			data.push_back(data.arena(), (uint8_t)(20 + (8 - i) * (neg ? -1 : 1)));
-			data.append(data.arena(), ((const uint8_t*)&swap) + i, 8 - i);
-			return *this;
-		}
-	}
-
-	data.push_back(data.arena(), (uint8_t)'\x14');
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(value)), value);
 	return *this;
 }
 
@@ -231,41 +417,22 @@ Tuple& Tuple::append(int32_t value) {
 }
 
 Tuple& Tuple::append(bool value) {
-	offsets.push_back(data.size());
-	if (value) {
-		data.push_back(data.arena(), 0x27);
-	} else {
-		data.push_back(data.arena(), 0x26);
-	}
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(value)), value);
 	return *this;
 }
 
 Tuple& Tuple::append(float value) {
-	offsets.push_back(data.size());
-	float swap = bigEndianFloat(value);
-	uint8_t* bytes = (uint8_t*)&swap;
-	adjustFloatingPoint(bytes, sizeof(float), true);
-
-	data.push_back(data.arena(), 0x20);
-	data.append(data.arena(), bytes, sizeof(float));
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(value)), value);
 	return *this;
 }
 
 Tuple& Tuple::append(double value) {
-	offsets.push_back(data.size());
-	double swap = value;
-	swap = bigEndianDouble(swap);
-	uint8_t* bytes = (uint8_t*)&swap;
-	adjustFloatingPoint(bytes, sizeof(double), true);
-
-	data.push_back(data.arena(), 0x21);
-	data.append(data.arena(), bytes, sizeof(double));
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(value)), value);
 	return *this;
 }
 
 Tuple& Tuple::append(std::nullptr_t) {
-	offsets.push_back(data.size());
-	data.push_back(data.arena(), (uint8_t)'\x00');
+	TupleElementCodec::encode(appendElement(TupleElementCodec::encodedSize(nullptr)), nullptr);
 	return *this;
 }
 
@@ -330,27 +497,10 @@ Standalone<StringRef> Tuple::getString(size_t index) const {
 		e = data.size();
 	}
 
-	Standalone<StringRef> result;
-	VectorRef<uint8_t> staging;
-
-	for (size_t i = b; i < e; ++i) {
-		if (data[i] == '\x00') {
-			staging.append(result.arena(), data.begin() + b, i - b);
-			++i;
-			b = i + 1;
-
-			if (i < e) {
-				staging.push_back(result.arena(), '\x00');
-			}
-		}
-	}
-
-	if (b < e) {
-		staging.append(result.arena(), data.begin() + b, e - b);
-	}
-
-	result.StringRef::operator=(StringRef(staging.begin(), staging.size()));
-	return result;
+	// Strings without escaped zero bytes share the tuple's arena rather than being copied
+	Arena arena;
+	StringRef str = unescapeString(data.begin() + b, data.begin() + e, arena);
+	return Standalone<StringRef>(str, str.begin() == data.begin() + b ? data.arena() : arena);
 }
 
 int64_t Tuple::getInt(size_t index, bool allow_incomplete) const {
@@ -601,3 +751,83 @@ TEST_CASE("/fdbclient/Tuple/unpack") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbclient/Tuple/schema") {
+	const int64_t ints[] = { 0,
+		                     1,
+		                     -1,
+		                     255,
+		                     -255,
+		                     256,
+		                     -256,
+		                     std::numeric_limits<int32_t>::max(),
+		                     std::numeric_limits<int32_t>::min(),
+		                     std::numeric_limits<int64_t>::max(),
+		                     std::numeric_limits<int64_t>::min() };
+	const StringRef strs[] = { ""_sr, "a"_sr, "\x00"_sr, "a\x00"_sr, "\x00\xff\x00"_sr, "0123456789abcdef\x00xyz"_sr };
+	for (int64_t i : ints) {
+		for (StringRef str : strs) {
+			using Schema = TupleSchema<StringRef, int64_t, Tuple::UnicodeStr, bool, double, std::nullptr_t>;
+			Tuple t = Tuple::makeTuple(str, i, Tuple::UnicodeStr(str), i < 0, (double)i, nullptr);
+			Standalone<StringRef> packed = Schema::pack(str, i, Tuple::UnicodeStr(str), i < 0, (double)i, nullptr);
+			ASSERT(packed == t.pack());
+			ASSERT_EQ(Schema::packedSize(str, i, Tuple::UnicodeStr(str), i < 0, (double)i, nullptr), packed.size());
+
+			Arena arena;
+			auto [s, n, u, b, d, null] = Schema::unpack(packed, arena);
+			ASSERT(s == str);
+			ASSERT_EQ(n, i);
+			ASSERT(u.str == str);
+			ASSERT_EQ(b, i < 0);
+			ASSERT_EQ(d, (double)i);
+
+			ASSERT(Tuple::unpack(packed).getString(0) == str);
+			ASSERT_EQ(Tuple::unpack(packed).getInt(1), i);
+		}
+	}
+
+	// Decoding checks the element types and the end of the tuple
+	Arena arena;
+	Standalone<StringRef> packed = TupleSchema<int64_t, StringRef>::pack(1, "a"_sr);
+	try {
+		TupleSchema<StringRef, int64_t>::unpack(packed, arena);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_invalid_tuple_data_type);
+	}
+	try {
+		TupleSchema<int64_t>::unpack(packed, arena);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_invalid_tuple_data_type);
+	}
+	try {
+		TupleSchema<int64_t>::unpack(packed.substr(0, 1), arena);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_invalid_tuple_data_type);
+	}
+
+	return Void();
+}
+
+TEST_CASE("/fdbclient/Tuple/findZero") {
+	for (int i = 0; i < 1000; i++) {
+		int size = deterministicRandom()->randomInt(0, 100);
+		std::string str = deterministicRandom()->randomAlphaNumeric(size);
+		int zeros = deterministicRandom()->randomInt(0, 4);
+		for (int z = 0; z < zeros && size; z++) {
+			str[deterministicRandom()->randomInt(0, size)] = '\x00';
+		}
+		const uint8_t* begin = (const uint8_t*)str.data();
+		const uint8_t* end = begin + str.size();
+		ASSERT(TupleElementCodec::findZero(begin, end) == std::find(begin, end, 0));
+		ASSERT_EQ(TupleElementCodec::countZeros(begin, end), std::count(begin, end, 0));
+
+		Tuple t = Tuple::makeTuple(StringRef(str), 1);
+		ASSERT(Tuple::unpack(t.pack()).getString(0) == StringRef(str));
+		ASSERT_EQ(Tuple::unpack(t.pack()).getInt(1), 1);
+	}
+
+	return Void();
+}
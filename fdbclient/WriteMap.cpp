@@ -79,12 +79,32 @@ WriteMap& WriteMap::operator=(WriteMap&& r) noexcept {
 	writeMapEmpty = r.writeMapEmpty;
 	writes = std::move(r.writes);
 	ver = r.ver;
+	pendingSets = std::move(r.pendingSets);
 	scratch_iterator = std::move(r.scratch_iterator);
 	arena = r.arena;
 	return *this;
 }
 
+void WriteMap::mergePendingSets() {
+	std::vector<PendingSet> sets = std::move(pendingSets);
+	pendingSets.clear();
+
+	// Bulk loads usually write in key order, and sorting the rest lets consecutive inserts walk the same tree path.
+	// Sets to different keys commute, and the sort is stable so that sets to the same key are applied in order.
+	auto byKey = [](PendingSet const& a, PendingSet const& b) { return a.key < b.key; };
+	if (!std::is_sorted(sets.begin(), sets.end(), byKey))
+		std::stable_sort(sets.begin(), sets.end(), byKey);
+
+	for (auto const& s : sets)
+		mutateNow(s.key, MutationRef::SetValue, s.value, s.addConflict);
+}
+
 void WriteMap::mutate(KeyRef key, MutationRef::Type operation, ValueRef param, bool addConflict) {
+	applyPendingSets();
+	mutateNow(key, operation, param, addConflict);
+}
+
+void WriteMap::mutateNow(KeyRef key, MutationRef::Type operation, ValueRef param, bool addConflict) {
 	writeMapEmpty = false;
 	auto& it = scratch_iterator;
 	it.reset(writes, ver);
@@ -158,6 +178,7 @@ void WriteMap::mutate(KeyRef key, MutationRef::Type operation, ValueRef param, b
 }
 
 void WriteMap::clear(KeyRangeRef keys, bool addConflict) {
+	applyPendingSets();
 	writeMapEmpty = false;
 	if (!addConflict) {
 		clearNoConflict(keys);
@@ -203,6 +224,7 @@ void WriteMap::clear(KeyRangeRef keys, bool addConflict) {
 }
 
 void WriteMap::addUnmodifiedAndUnreadableRange(KeyRangeRef keys) {
+	applyPendingSets();
 	auto& it = scratch_iterator;
 	it.reset(writes, ver);
 	it.skip(keys.begin);
@@ -242,6 +264,7 @@ void WriteMap::addUnmodifiedAndUnreadableRange(KeyRangeRef keys) {
 }
 
 void WriteMap::addConflictRange(KeyRangeRef keys) {
+	applyPendingSets();
 	writeMapEmpty = false;
 	auto& it = scratch_iterator;
 	it.reset(writes, ver);
@@ -257,6 +257,23 @@ struct BlobFilePointerRef {
 		}
 	}
 
+	BlobFilePointerRef(Arena& to, const BlobFilePointerRef& from)
+	  : filename(to, from.filename), offset(from.offset), length(from.length), fullFileLength(from.fullFileLength),
+	    fileVersion(from.fileVersion) {
+		if (from.cipherKeysCtx.present()) {
+			BlobGranuleCipherKeysCtx ctx = from.cipherKeysCtx.get();
+			ctx.textCipherKey.baseCipher = StringRef(to, ctx.textCipherKey.baseCipher);
+			ctx.headerCipherKey.baseCipher = StringRef(to, ctx.headerCipherKey.baseCipher);
+			ctx.ivRef = StringRef(to, ctx.ivRef);
+			cipherKeysCtx = ctx;
+		}
+		if (from.cipherKeysMetaRef.present()) {
+			BlobGranuleCipherKeysMetaRef meta = from.cipherKeysMetaRef.get();
+			meta.ivRef = StringRef(to, meta.ivRef);
+			cipherKeysMetaRef = meta;
+		}
+	}
+
 	template <class Ar>
 	void serialize(Ar& ar) {
 		serializer(ar, filename, offset, length, fullFileLength, fileVersion, cipherKeysCtx);
@@ -292,6 +309,19 @@ struct BlobGranuleChunkRef {
 	GranuleDeltas newDeltas;
 	Optional<KeyRef> tenantPrefix;
 
+	BlobGranuleChunkRef() {}
+	BlobGranuleChunkRef(Arena& to, const BlobGranuleChunkRef& from)
+	  : keyRange(to, from.keyRange), includedVersion(from.includedVersion), snapshotVersion(from.snapshotVersion),
+	    deltaFiles(to, from.deltaFiles) {
+		newDeltas.append_deep(to, from.newDeltas.begin(), from.newDeltas.size());
+		if (from.snapshotFile.present()) {
+			snapshotFile = BlobFilePointerRef(to, from.snapshotFile.get());
+		}
+		if (from.tenantPrefix.present()) {
+			tenantPrefix = KeyRef(to, from.tenantPrefix.get());
+		}
+	}
+
 	template <class Ar>
 	void serialize(Ar& ar) {
 		serializer(ar, keyRange, includedVersion, snapshotVersion, snapshotFile, deltaFiles, newDeltas, tenantPrefix);
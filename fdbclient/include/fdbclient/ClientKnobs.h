@@ -65,6 +65,10 @@ public:
 	double BACKOFF_GROWTH_RATE;
 	double RESOURCE_CONSTRAINED_MAX_BACKOFF;
 	int PROXY_COMMIT_OVERHEAD_BYTES;
+	bool COMMIT_COALESCE_MUTATIONS; // Drop mutations which are overwritten later in the same transaction before commit
+	bool COMMIT_COMPRESS_MUTATIONS; // Send commit mutations prefix compressed; requires proxies which understand it
+	int COMMIT_COMPRESS_MUTATIONS_MIN_BYTES; // Smallest mutation payload sent compressed
+	int COMMIT_ZSTD_MUTATIONS_MIN_BYTES; // Smallest mutation payload additionally compressed with zstd, if available
 	double SHARD_STAT_SMOOTH_AMOUNT;
 	int INIT_MID_SHARD_BYTES;
 
@@ -73,6 +77,7 @@ public:
 	int64_t SYSTEM_KEY_SIZE_LIMIT;
 	int64_t VALUE_SIZE_LIMIT;
 	int64_t SPLIT_KEY_SIZE_LIMIT;
+	bool RYW_BUFFER_BLIND_SETS; // Append sets to the write map unsorted until the transaction next reads its writes
 	int METADATA_VERSION_CACHE_SIZE;
 	int64_t CHANGE_FEED_LOCATION_LIMIT;
 	int64_t CHANGE_FEED_CACHE_SIZE;
@@ -94,6 +99,10 @@ public:
 	int LOCATION_CACHE_EVICTION_SIZE_SIM;
 	double LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD;
 	double LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL;
+	// Whether to keep the location cache up to date with shard map changes pushed from the commit proxies
+	bool SHARD_MAP_WATCH_ENABLED;
+	int SHARD_MAP_WATCH_MAX_RANGES; // Most key ranges with cached locations sent in one shard map watch
+	double SHARD_MAP_WATCH_MIN_INTERVAL; // Least time between two shard map watches
 
 	int GET_RANGE_SHARD_LIMIT;
 	int WARM_RANGE_SHARD_LIMIT;
@@ -107,6 +116,8 @@ public:
 	bool TAG_ENCODE_KEY_SERVERS;
 	int64_t RANGESTREAM_FRAGMENT_SIZE;
 	int RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT;
+	int RANGE_READ_AHEAD_BATCHES; // Default for the range_read_ahead transaction option; 0 disables read-ahead
+	int64_t RANGE_READ_AHEAD_BYTES; // Upper bound on the bytes a single range scan may have requested ahead
 	bool QUARANTINE_TSS_ON_MISMATCH;
 	double CHANGE_FEED_EMPTY_BATCH_TIME;
 
@@ -121,6 +132,8 @@ public:
 	double NO_RECENT_UPDATES_DURATION;
 	double FAST_WATCH_TIMEOUT;
 	double WATCH_TIMEOUT;
+	int WATCH_BATCH_MIN_KEYS; // A transaction committing at least this many watches registers them in batches
+	int WATCH_BATCH_MAX_KEYS; // Most keys registered with a storage server in one batched watch request
 
 	double IS_ACCEPTABLE_DELAY;
 
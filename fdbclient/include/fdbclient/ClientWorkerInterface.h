@@ -35,6 +35,7 @@ struct ClientWorkerInterface {
 	RequestStream<struct RebootRequest> reboot;
 	RequestStream<struct ProfilerRequest> profiler;
 	RequestStream<struct SetFailureInjection> setFailureInjection;
+	RequestStream<struct ActorProfileRequest> actorProfile;
 
 	bool operator==(ClientWorkerInterface const& r) const { return id() == r.id(); }
 	bool operator!=(ClientWorkerInterface const& r) const { return id() != r.id(); }
@@ -45,7 +46,7 @@ struct ClientWorkerInterface {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, reboot, profiler, setFailureInjection);
+		serializer(ar, reboot, profiler, setFailureInjection, actorProfile);
 	}
 };
 
@@ -90,6 +91,35 @@ struct ProfilerRequest {
 	}
 };
 
+// The stacks folded by the actor sampler (flow/ActorSampler.h) of a worker
+struct ActorProfileReply {
+	constexpr static FileIdentifier file_identifier = 14629351;
+	std::map<std::string, int64_t> stacks; // "Priority<N>;<outermost actor>;...;<innermost actor>" -> samples
+	int64_t samples = 0;
+	int64_t dropped = 0;
+	double duration = 0; // Seconds since the worker started sampling or was last reset
+	int hz = 0;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, stacks, samples, dropped, duration, hz);
+	}
+};
+
+struct ActorProfileRequest {
+	constexpr static FileIdentifier file_identifier = 9138421;
+	ReplyPromise<ActorProfileReply> reply;
+	bool reset = false; // Start a new profile after replying with the current one
+
+	ActorProfileRequest() = default;
+	explicit ActorProfileRequest(bool reset) : reset(reset) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, reply, reset);
+	}
+};
+
 struct SetFailureInjection {
 	constexpr static FileIdentifier file_identifier = 15439864;
 	ReplyPromise<Void> reply;
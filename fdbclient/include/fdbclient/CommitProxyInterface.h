@@ -39,6 +39,7 @@
 
 #include "fdbrpc/Stats.h"
 #include "fdbrpc/TimedRequest.h"
+#include "flow/CompressionUtils.h"
 
 struct CommitProxyInterface {
 	constexpr static FileIdentifier file_identifier = 8954922;
@@ -67,6 +68,7 @@ struct CommitProxyInterface {
 	PublicRequestStream<struct GetTenantIdRequest> getTenantId;
 	PublicRequestStream<struct GetBlobGranuleLocationsRequest> getBlobGranuleLocations;
 	RequestStream<struct SetThrottledShardRequest> setThrottledShard;
+	RequestStream<struct WatchShardMapRequest> watchShardMap;
 
 	UID id() const { return commit.getEndpoint().token; }
 	std::string toString() const { return id().shortString(); }
@@ -100,6 +102,7 @@ struct CommitProxyInterface {
 			    commit.getEndpoint().getAdjustedEndpoint(12));
 			setThrottledShard =
 			    RequestStream<struct SetThrottledShardRequest>(commit.getEndpoint().getAdjustedEndpoint(13));
+			watchShardMap = RequestStream<struct WatchShardMapRequest>(commit.getEndpoint().getAdjustedEndpoint(14));
 		}
 	}
 
@@ -120,6 +123,7 @@ struct CommitProxyInterface {
 		streams.push_back(getTenantId.getReceiver());
 		streams.push_back(getBlobGranuleLocations.getReceiver());
 		streams.push_back(setThrottledShard.getReceiver());
+		streams.push_back(watchShardMap.getReceiver());
 		FlowTransport::transport().addEndpoints(streams);
 	}
 };
@@ -210,6 +214,27 @@ struct CommitID {
 	    conflictingKRIndices(conflictingKRIndices) {}
 };
 
+// The mutations of a commit request in the compact form clients send when COMMIT_COMPRESS_MUTATIONS is enabled. Each
+// key is written as the length of the prefix it shares with the key before it and the remaining bytes, followed by the
+// mutation checksum if ENABLE_MUTATION_CHECKSUM is set, and the encoded mutations are then compressed with filter.
+struct CompressedMutationsRef {
+	CompressionFilter filter = CompressionFilter::NONE;
+	int32_t count = 0;
+	bool checksummed = false;
+	StringRef data;
+
+	CompressedMutationsRef() = default;
+	CompressedMutationsRef(Arena& arena, VectorRef<MutationRef> const& mutations, CompressionFilter filter);
+
+	// Throws serialization_failed if data is not a valid encoding of count mutations
+	VectorRef<MutationRef> decode(Arena& arena) const;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, filter, count, checksummed, data);
+	}
+};
+
 struct CommitTransactionRequest : TimedRequest {
 	constexpr static FileIdentifier file_identifier = 93948;
 	enum { FLAG_IS_LOCK_AWARE = 0x1, FLAG_FIRST_IN_BATCH = 0x2, FLAG_BYPASS_STORAGE_QUOTA = 0x4 };
@@ -227,6 +252,8 @@ struct CommitTransactionRequest : TimedRequest {
 	Optional<ClientTrCommitCostEstimation> commitCostEstimation;
 	Optional<TagSet> tagSet;
 	IdempotencyIdRef idempotencyId;
+	// When present, replaces transaction.mutations on the wire
+	Optional<CompressedMutationsRef> compressedMutations;
 
 	TenantInfo tenantInfo;
 
@@ -235,6 +262,11 @@ struct CommitTransactionRequest : TimedRequest {
 
 	bool verify() const { return tenantInfo.isAuthorized(); }
 
+	// Moves transaction.mutations into compressedMutations
+	void compressMutations(CompressionFilter filter);
+	// Restores transaction.mutations from compressedMutations, if present
+	void decompressMutations();
+
 	template <class Ar>
 	void serialize(Ar& ar) {
 		serializer(ar,
@@ -247,6 +279,7 @@ struct CommitTransactionRequest : TimedRequest {
 		           spanContext,
 		           tenantInfo,
 		           idempotencyId,
+		           compressedMutations,
 		           arena);
 	}
 };
@@ -477,6 +510,46 @@ struct GetKeyServerLocationsRequest {
 	}
 };
 
+struct WatchShardMapReply {
+	constexpr static FileIdentifier file_identifier = 4817250;
+	Arena arena;
+	// All changes at versions <= version have been reported
+	Version version;
+	// True if the proxy no longer knows the changes since the requested version, so none were reported
+	bool reset;
+	// Ranges whose locations changed, clipped to the requested ranges
+	VectorRef<KeyRangeRef> changed;
+	// The current locations of the changed ranges, which may not cover all of them
+	GetKeyServerLocationsReply locations;
+
+	WatchShardMapReply() : version(invalidVersion), reset(false) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, version, reset, changed, locations, arena);
+	}
+};
+
+// Waits until the locations of any of the given ranges change after the given version, or
+// SHARD_MAP_WATCH_TIMEOUT passes, so that clients can update their location caches before
+// they send requests to the wrong storage servers.
+struct WatchShardMapRequest {
+	constexpr static FileIdentifier file_identifier = 13071664;
+	Arena arena;
+	// Only changes at versions > version are reported. If latestVersion, the proxy replies immediately with its
+	// current version.
+	Version version;
+	VectorRef<KeyRangeRef> ranges;
+	ReplyPromise<WatchShardMapReply> reply;
+
+	WatchShardMapRequest() : version(latestVersion) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, version, ranges, reply, arena);
+	}
+};
+
 struct GetBlobGranuleLocationsReply {
 	constexpr static FileIdentifier file_identifier = 2923309;
 	Arena arena;
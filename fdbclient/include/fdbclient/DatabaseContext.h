@@ -35,6 +35,7 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/FlatKeyRangeMap.h"
 #include "fdbclient/CommitProxyInterface.h"
 #include "fdbclient/SpecialKeySpace.actor.h"
 #include "fdbclient/VersionVector.h"
@@ -147,6 +148,30 @@ struct WatchParameters : public ReferenceCounted<WatchParameters> {
 	    debugID(debugID), useProvisionalProxies(useProvisionalProxies) {}
 };
 
+// The watches committed by one transaction when they are registered in batches: keys[i] is watched to change from its
+// value, and promises[i] is sent once it does.
+struct WatchValuesParameters : public ReferenceCounted<WatchValuesParameters> {
+	const TenantInfo tenant;
+	const Standalone<VectorRef<WatchedValueRef>> keys;
+	std::vector<Promise<Void>> promises;
+
+	const TagSet tags;
+	const SpanContext spanContext;
+	const TaskPriority taskID;
+	const Optional<UID> debugID;
+	const UseProvisionalProxies useProvisionalProxies;
+
+	WatchValuesParameters(TenantInfo tenant,
+	                      Standalone<VectorRef<WatchedValueRef>> keys,
+	                      TagSet tags,
+	                      SpanContext spanContext,
+	                      TaskPriority taskID,
+	                      Optional<UID> debugID,
+	                      UseProvisionalProxies useProvisionalProxies)
+	  : tenant(tenant), keys(keys), promises(keys.size()), tags(tags), spanContext(spanContext), taskID(taskID),
+	    debugID(debugID), useProvisionalProxies(useProvisionalProxies) {}
+};
+
 class WatchMetadata : public ReferenceCounted<WatchMetadata> {
 public:
 	Promise<Version> watchPromise;
@@ -542,7 +567,7 @@ public:
 
 	// Cache of location information
 	int locationCacheSize;
-	CoalescedKeyRangeMap<Reference<LocationInfo>> locationCache;
+	FlatKeyRangeMap<Reference<LocationInfo>> locationCache;
 	std::unordered_map<Endpoint, EndpointFailureInfo> failedEndpointsOnHealthyServersInfo;
 
 	std::map<UID, StorageServerInfo*> server_interf;
@@ -602,13 +627,19 @@ public:
 	Counter transactionGetRangeRequests;
 	Counter transactionGetMappedRangeRequests;
 	Counter transactionGetRangeStreamRequests;
+	Counter transactionRangeReadAheadHits;
+	Counter transactionRangeReadAheadWasted;
 	Counter transactionWatchRequests;
+	Counter transactionBatchedWatchRequests; // WatchValuesRequests sent to storage servers
+	Counter transactionBatchedWatchKeys; // Keys registered through WatchValuesRequests
 	Counter transactionGetAddressesForKeyRequests;
 	Counter transactionBytesRead;
 	Counter transactionKeysRead;
 	Counter transactionMetadataVersionReads;
 	Counter transactionCommittedMutations;
 	Counter transactionCommittedMutationBytes;
+	Counter transactionCoalescedMutations;
+	Counter transactionCommitMutationBytesSent;
 	Counter transactionSetMutations;
 	Counter transactionClearMutations;
 	Counter transactionAtomicMutations;
@@ -616,6 +647,7 @@ public:
 	Counter transactionsCommitCompleted;
 	Counter transactionKeyServerLocationRequests;
 	Counter transactionKeyServerLocationRequestsCompleted;
+	Counter transactionShardMapLocationsPushed;
 	Counter transactionBlobGranuleLocationRequests;
 	Counter transactionBlobGranuleLocationRequestsCompleted;
 	Counter transactionStatusRequests;
@@ -717,6 +749,7 @@ public:
 	UniqueOrderedOptionList<FDBTransactionOptions> transactionDefaults;
 
 	Future<Void> cacheListMonitor;
+	Future<Void> shardMapMonitor;
 	AsyncTrigger updateCache;
 	std::vector<std::unique_ptr<SpecialKeyRangeReadImpl>> specialKeySpaceModules;
 	std::unique_ptr<SpecialKeySpace> specialKeySpace;
@@ -1737,6 +1737,9 @@ struct ReadOptions {
 	// Once CacheResult is serializable, change type from bool to CacheResult
 	bool cacheResult;
 	bool lockAware = false;
+	// Ask storage servers to keep the history needed to read at this version for a bounded time (see
+	// STORAGE_SNAPSHOT_RETENTION_TIME), so that many transactions can share one read version
+	bool retainVersion = false;
 	Optional<UID> debugID;
 	Optional<Version> consistencyCheckStartVersion;
 
@@ -1750,7 +1753,7 @@ struct ReadOptions {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, type, cacheResult, debugID, consistencyCheckStartVersion, lockAware);
+		serializer(ar, type, cacheResult, debugID, consistencyCheckStartVersion, lockAware, retainVersion);
 	}
 };
 
@@ -0,0 +1,307 @@
+/*
+ * FlatKeyRangeMap.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_FLATKEYRANGEMAP_H
+#define FDBCLIENT_FLATKEYRANGEMAP_H
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/SystemData.h"
+#include "flow/flow.h"
+
+// Maps every key in [allKeys.begin, endKey) to a Val, like CoalescedKeyRangeMap, but stores the range boundaries in
+// sorted arrays instead of a tree of heap nodes.
+//
+// The boundaries are split into leaves of at most LeafCapacity entries.  Each leaf keeps its boundary keys in one
+// arena and its values in a parallel vector, and the map keeps the first key of each leaf in a top level array, so a
+// lookup is two binary searches over contiguous memory.  Inserting or erasing a boundary moves at most LeafCapacity
+// entries, or the top level array when a leaf is split or emptied.
+//
+// Adjacent ranges with equal values are coalesced by insert(), but not when a value is changed through an iterator.
+// Iterators are invalidated by insert().
+template <class Val, int LeafCapacity = 128>
+class FlatKeyRangeMap : NonCopyable {
+	struct Leaf {
+		Arena arena;
+		std::vector<KeyRef> begins;
+		std::vector<Val> values;
+		// Bytes of erased keys still held by arena
+		int deadBytes = 0;
+	};
+
+public:
+	class iterator {
+	public:
+		iterator() : map(nullptr), leaf(0), index(0) {}
+
+		KeyRangeRef range() const { return KeyRangeRef(begin(), end()); }
+		KeyRef begin() const { return map->leaves[leaf]->begins[index]; }
+		KeyRef end() const {
+			const Leaf& l = *map->leaves[leaf];
+			if (index + 1 < l.begins.size()) {
+				return l.begins[index + 1];
+			}
+			return leaf + 1 < map->leaves.size() ? map->leafBegins[leaf + 1] : map->mapEnd;
+		}
+		Val& value() const { return map->leaves[leaf]->values[index]; }
+		Val& cvalue() const { return value(); }
+
+		// Allow iterators to be used like KeyRangeMap iterators, i.e. it->value()
+		const iterator& operator*() const { return *this; }
+		const iterator* operator->() const { return this; }
+
+		iterator& operator++() {
+			if (++index == map->leaves[leaf]->begins.size()) {
+				++leaf;
+				index = 0;
+			}
+			return *this;
+		}
+		iterator& operator--() {
+			if (index == 0) {
+				--leaf;
+				index = map->leaves[leaf]->begins.size() - 1;
+			} else {
+				--index;
+			}
+			return *this;
+		}
+
+		bool operator==(const iterator& r) const { return leaf == r.leaf && index == r.index; }
+		bool operator!=(const iterator& r) const { return !(*this == r); }
+
+	private:
+		friend class FlatKeyRangeMap;
+		iterator(const FlatKeyRangeMap* map, int leaf, int index) : map(map), leaf(leaf), index(index) {}
+
+		const FlatKeyRangeMap* map;
+		int leaf;
+		int index;
+	};
+
+	explicit FlatKeyRangeMap(Val v = Val(), Key endKey = allKeys.end) : mapEnd(endKey), count(0) {
+		insertBoundary(allKeys.begin, v);
+	}
+
+	// Number of ranges in the map
+	int size() const { return count; }
+
+	iterator begin() const { return iterator(this, 0, 0); }
+	iterator end() const { return iterator(this, leaves.size(), 0); }
+	iterator lastItem() const { return rangeContainingKeyBefore(mapEnd); }
+
+	iterator rangeContaining(const KeyRef& key) const {
+		int l = findLeaf(key);
+		const Leaf& leaf = *leaves[l];
+		auto i = std::upper_bound(leaf.begins.begin(), leaf.begins.end(), key);
+		return iterator(this, l, i - leaf.begins.begin() - 1);
+	}
+
+	// Range containing a key infinitesimally before key, or the first range if key is allKeys.begin
+	iterator rangeContainingKeyBefore(const KeyRef& key) const {
+		int l = findLeafBefore(key);
+		const Leaf& leaf = *leaves[l];
+		auto i = std::lower_bound(leaf.begins.begin(), leaf.begins.end(), key);
+		return iterator(this, l, std::max<int>(i - leaf.begins.begin() - 1, 0));
+	}
+
+	// A range chosen at random, not necessarily uniformly
+	iterator randomRange() const {
+		int l = deterministicRandom()->randomInt(0, leaves.size());
+		return iterator(this, l, deterministicRandom()->randomInt(0, leaves[l]->begins.size()));
+	}
+
+	// Calls f(iterator) for each range entirely within keys
+	template <class F>
+	void forEachContainedRange(const KeyRangeRef& keys, F f) const {
+		iterator i = rangeContaining(keys.begin);
+		if (i.begin() < keys.begin) {
+			++i;
+		}
+		for (; i != end() && i.end() <= keys.end; ++i) {
+			f(i);
+		}
+	}
+
+	// The union of all ranges intersecting keys, which must not be empty
+	KeyRangeRef intersectingRange(const KeyRangeRef& keys) const {
+		return KeyRangeRef(rangeContaining(keys.begin).begin(), rangeContainingKeyBefore(keys.end).end());
+	}
+
+	void insert(const KeyRangeRef& keys, const Val& value) {
+		ASSERT(keys.end <= mapEnd);
+		if (keys.empty()) {
+			return;
+		}
+
+		// keys might point into the map's own storage, which the changes below can free
+		Key begin = keys.begin;
+		Key end = keys.end;
+
+		bool hasEnd = end < mapEnd;
+		Val endValue;
+		if (hasEnd) {
+			endValue = rangeContaining(end).value();
+		}
+
+		eraseBoundaries(begin, end);
+		insertBoundary(begin, value);
+		// If the range following keys has the same value then it now starts at begin
+		if (hasEnd && !(endValue == value)) {
+			insertBoundary(end, endValue);
+		}
+		if (begin > allKeys.begin && rangeContainingKeyBefore(begin).value() == value) {
+			eraseBoundaries(begin, begin);
+		}
+	}
+
+	// Resets the map to a single range with value v
+	void clear(Val v = Val()) {
+		leaves.clear();
+		leafBegins.clear();
+		count = 0;
+		insertBoundary(allKeys.begin, v);
+	}
+
+	const Key mapEnd;
+
+private:
+	// Index of the leaf whose first key is the last one <= key
+	int findLeaf(const KeyRef& key) const {
+		auto i = std::upper_bound(leafBegins.begin(), leafBegins.end(), key);
+		return i == leafBegins.begin() ? 0 : i - leafBegins.begin() - 1;
+	}
+
+	// Index of the leaf whose first key is the last one < key
+	int findLeafBefore(const KeyRef& key) const {
+		auto i = std::lower_bound(leafBegins.begin(), leafBegins.end(), key);
+		return i == leafBegins.begin() ? 0 : i - leafBegins.begin() - 1;
+	}
+
+	void insertBoundary(const KeyRef& key, const Val& value) {
+		if (leaves.empty()) {
+			leaves.push_back(std::make_unique<Leaf>());
+			leafBegins.emplace_back();
+		}
+
+		int l = findLeaf(key);
+		Leaf& leaf = *leaves[l];
+		auto i = std::lower_bound(leaf.begins.begin(), leaf.begins.end(), key);
+		int index = i - leaf.begins.begin();
+		if (i != leaf.begins.end() && *i == key) {
+			leaf.values[index] = value;
+			return;
+		}
+
+		leaf.begins.insert(i, KeyRef(leaf.arena, key));
+		leaf.values.insert(leaf.values.begin() + index, value);
+		++count;
+		if (index == 0) {
+			leafBegins[l] = leaf.begins[0];
+		}
+		if (leaf.begins.size() > LeafCapacity) {
+			splitLeaf(l);
+		}
+	}
+
+	// Erase all boundaries in [begin, end]
+	void eraseBoundaries(const KeyRef& begin, const KeyRef& end) {
+		if (leaves.empty()) {
+			return;
+		}
+		int l = findLeafBefore(begin);
+		while (l < leaves.size()) {
+			Leaf& leaf = *leaves[l];
+			auto first = std::lower_bound(leaf.begins.begin(), leaf.begins.end(), begin);
+			auto last = std::upper_bound(first, leaf.begins.end(), end);
+			bool reachedEnd = last == leaf.begins.end();
+			if (first != last) {
+				int from = first - leaf.begins.begin();
+				int to = last - leaf.begins.begin();
+				for (auto k = first; k != last; ++k) {
+					leaf.deadBytes += k->size();
+				}
+				leaf.begins.erase(first, last);
+				leaf.values.erase(leaf.values.begin() + from, leaf.values.begin() + to);
+				count -= to - from;
+
+				if (leaf.begins.empty()) {
+					leaves.erase(leaves.begin() + l);
+					leafBegins.erase(leafBegins.begin() + l);
+					if (reachedEnd) {
+						continue;
+					}
+					break;
+				}
+				if (leaf.deadBytes > leaf.arena.getSize() / 2) {
+					compactLeaf(leaf);
+				}
+				leafBegins[l] = leaf.begins[0];
+			}
+			if (!reachedEnd) {
+				break;
+			}
+			++l;
+		}
+	}
+
+	// Copy the live keys of leaf into a new arena
+	static void compactLeaf(Leaf& leaf) {
+		Arena arena;
+		for (auto& k : leaf.begins) {
+			k = KeyRef(arena, k);
+		}
+		leaf.arena = arena;
+		leaf.deadBytes = 0;
+	}
+
+	void splitLeaf(int l) {
+		Leaf& leaf = *leaves[l];
+		int half = leaf.begins.size() / 2;
+		auto right = std::make_unique<Leaf>();
+		right->begins.reserve(LeafCapacity + 1);
+		right->values.reserve(LeafCapacity + 1);
+		for (int i = half; i < leaf.begins.size(); ++i) {
+			right->begins.push_back(KeyRef(right->arena, leaf.begins[i]));
+			right->values.push_back(std::move(leaf.values[i]));
+		}
+		for (int i = half; i < leaf.begins.size(); ++i) {
+			leaf.deadBytes += leaf.begins[i].size();
+		}
+		leaf.begins.resize(half);
+		leaf.values.resize(half);
+		compactLeaf(leaf);
+		leafBegins[l] = leaf.begins[0];
+
+		leafBegins.insert(leafBegins.begin() + l + 1, right->begins[0]);
+		leaves.insert(leaves.begin() + l + 1, std::move(right));
+	}
+
+	std::vector<std::unique_ptr<Leaf>> leaves;
+	// First key of each leaf, pointing into the leaf's arena
+	std::vector<KeyRef> leafBegins;
+	int count;
+};
+
+#endif
@@ -168,6 +168,7 @@ struct TransactionOptions {
 	bool bypassStorageQuota : 1;
 	bool enableReplicaConsistencyCheck : 1;
 	int requiredReplicas;
+	int rangeReadAheadBatches;
 
 	TransactionPriority priority;
 
@@ -348,12 +349,71 @@ private:
 	bool tenantSet;
 };
 
+// The part of a range being read ahead which lies in one shard.  It is read in chunks of up to the byte limit of the
+// scan, one chunk at a time, while the bytes buffered for the scan are within RANGE_READ_AHEAD_BYTES.
+struct RangeReadAheadFragment : ReferenceCounted<RangeReadAheadFragment> {
+	KeyRange range;
+	// Every key in range which is before readThrough in scan order has been read
+	Key readThrough;
+	// The chunks read and not yet served, in scan order, and the rows of the first one which were served
+	std::deque<RangeResult> chunks;
+	int served = 0;
+	bool done = false;
+	bool failed = false;
+	Future<Void> reader;
+};
+
+// The state of the range scan a transaction is reading ahead of, see the RANGE_READ_AHEAD transaction option.
+//
+// After a range read returns a partial result, the rest of the range is split at the shard boundaries and up to
+// maxFragments shards are read concurrently.  The following reads of the same scan are served from the fragments in
+// order, as long as each one starts where the result before it left off.
+struct RangeReadAhead : ReferenceCounted<RangeReadAhead> {
+	Snapshot snapshot = Snapshot::False;
+	Reverse reverse = Reverse::False;
+	GetRangeLimits chunkLimits;
+	int maxFragments = 0;
+
+	// The keys of the scan which have not been served, and the part of them which no fragment covers yet
+	KeyRange remaining;
+	KeyRange unassigned;
+	// The next read may start anywhere between the end of the last row served and the start of remaining, since there
+	// are no keys in between
+	Key lastServed;
+
+	std::deque<Reference<RangeReadAheadFragment>> fragments;
+	int64_t bufferedBytes = 0;
+	bool started = false;
+	bool serving = false;
+	bool splitFailed = false;
+	bool cancelled = false;
+
+	// Triggered when fragments make progress, and when the application consumes from them
+	AsyncTrigger changed;
+	AsyncTrigger consumed;
+	Future<Void> reader;
+
+	// True if a read of the (normalized) selectors can be served from the fragments
+	bool canServe(KeySelector const& begin, KeySelector const& end, Snapshot snapshot, Reverse reverse) const;
+
+	// Moves the rows which are ready and follow on from the last row served into output, within limits
+	void take(RangeResult& output, GetRangeLimits& limits);
+
+	bool exhausted() const { return fragments.empty() && unassigned.empty(); }
+	bool stalled() const;
+
+	int discard();
+};
+
 class Transaction : NonCopyable {
 public:
 	explicit Transaction(Database const& cx, Optional<Reference<Tenant>> const& tenant = Optional<Reference<Tenant>>());
 	~Transaction();
 
 	void setVersion(Version v);
+	// Sets the read version to a version shared by many read-only transactions and asks storage servers to retain
+	// the history needed to serve it (see FDBTransactionOptions::RETAIN_READ_VERSION)
+	void setSnapshotVersion(Version v);
 	Future<Version> getReadVersion() {
 		if (!trState->readVersionFuture.isValid()) {
 			trState->readVersionFuture = trState->getReadVersion(0);
@@ -568,6 +628,12 @@ private:
 	                                     GetRangeLimits limits,
 	                                     Snapshot snapshot,
 	                                     Reverse reverse);
+	Future<RangeResult> getRangeWithReadAhead(const KeySelector& begin,
+	                                          const KeySelector& end,
+	                                          GetRangeLimits limits,
+	                                          Snapshot snapshot,
+	                                          Reverse reverse);
+	void discardReadAhead();
 
 	void resetImpl(bool generateNewSpan);
 
@@ -576,6 +642,7 @@ private:
 	std::vector<Future<std::pair<Key, Key>>> extraConflictRanges;
 	Promise<Void> commitResult;
 	Future<Void> committing;
+	Reference<RangeReadAhead> rangeReadAhead;
 };
 
 ACTOR Future<Version> waitForCommittedVersion(Database cx, Version version, SpanContext spanContext);
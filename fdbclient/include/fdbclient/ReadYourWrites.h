@@ -77,6 +77,7 @@ public:
 	void construct(Database const&) override;
 	void construct(Database const&, Reference<Tenant> const& tenant) override;
 	void setVersion(Version v) override { tr.setVersion(v); }
+	void setSnapshotVersion(Version v) { tr.setSnapshotVersion(v); }
 	Future<Version> getReadVersion() override;
 	Optional<Version> getCachedReadVersion() const override { return tr.getCachedReadVersion(); }
 	Future<Optional<Value>> get(const Key& key, Snapshot = Snapshot::False) override;
@@ -425,6 +425,8 @@ public:
 
 	// KeyValueStoreMemory
 	int64_t REPLACE_CONTENTS_BYTES;
+	int KVS_MEMORY_RECOVERY_THREADS; // Threads materializing recovered snapshot partitions; 0 disables partitioning
+	int64_t KVS_MEMORY_RECOVERY_PARTITION_BYTES; // Snapshot bytes per independently materialized recovery partition
 
 	// KeyValueStoreRocksDB
 	bool ROCKSDB_SET_READ_TIMEOUT;
@@ -573,6 +575,13 @@ public:
 	int SHARDED_ROCKSDB_MAX_OPEN_FILES;
 	bool SHARDED_ROCKSDB_READ_ASYNC_IO;
 	int SHARDED_ROCKSDB_PREFIX_LEN;
+	double SHARDED_ROCKSDB_SHARD_PROFILE_INTERVAL; // How often physical shard option profiles are re-evaluated; 0 disables
+	int64_t SHARDED_ROCKSDB_WRITE_HEAVY_BYTES_PER_SEC; // Write rate at which a physical shard is tuned for ingest
+	double SHARDED_ROCKSDB_READ_HOT_OPS_PER_SEC; // Read rate at which a physical shard is tuned for lookups
+	double SHARDED_ROCKSDB_COLD_OPS_PER_SEC; // Below this combined read and write rate a physical shard is cold
+	int SHARDED_ROCKSDB_WRITE_HEAVY_L0_TRIGGER_MULTIPLIER;
+	int SHARDED_ROCKSDB_WRITE_HEAVY_WRITE_BUFFER_MULTIPLIER;
+	int SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE; // 0 leaves the block size of read hot shards unchanged
 
 	// Leader election
 	int MAX_NOTIFICATIONS;
@@ -600,6 +609,10 @@ public:
 	int KEY_LOCATION_MAX_QUEUE_SIZE;
 	int TENANT_ID_REQUEST_MAX_QUEUE_SIZE;
 	int BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE;
+	int SHARD_MAP_WATCH_MAX_QUEUE_SIZE; // Outstanding shard map watches per commit proxy
+	double SHARD_MAP_WATCH_TIMEOUT; // Longest time a commit proxy holds a shard map watch without changes
+	int SHARD_MAP_WATCH_MAX_RESULTS; // Most shard locations pushed in one shard map watch reply
+	int SHARD_MAP_CHANGE_LOG_SIZE; // Number of recent shard map changes each commit proxy remembers for watches
 	double COMMIT_PROXY_LIVENESS_TIMEOUT;
 	double COMMIT_PROXY_MAX_LIVENESS_TIMEOUT;
 
@@ -1015,6 +1028,12 @@ public:
 	double MIN_BYTE_SAMPLING_PROBABILITY; // Adjustable only for test of PhysicalShardMove. Should always be 0 for other
 	                                      // cases
 	int MAX_STORAGE_SERVER_WATCH_BYTES;
+	double WATCH_VALUES_BATCH_DELAY; // Time a batched watch collects triggered keys before re-reading them
+	int WATCH_VALUES_READ_PARALLELISM; // Most outstanding value reads of one batched watch
+	double STORAGE_SNAPSHOT_RETENTION_TIME; // How long a version read with the retain_read_version option stays readable
+	                                        // after its last read
+	int64_t STORAGE_SNAPSHOT_MAX_RETAINED_VERSIONS; // Versions kept readable behind the latest version at most
+	int64_t STORAGE_SNAPSHOT_RETENTION_MAX_QUEUE_BYTES; // Snapshot versions are not retained above this queue size
 	int MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE;
 	double LONG_BYTE_SAMPLE_RECOVERY_DELAY;
 	int BYTE_SAMPLE_LOAD_PARALLELISM;
@@ -1189,6 +1208,14 @@ public:
 	bool FASTRESTORE_DUMP_INSERT_RANGE_VERSION; // Dump all the range version after insertion. This is for debugging
 	                                            // purpose.
 
+	// Storage engine cache budget
+	int64_t CACHE_BUDGET_BROKER_BYTES; // Total block and page cache bytes shared by the storage engines of a process,
+	                                   // 0 lets each cache use its own configured size
+	double CACHE_BUDGET_BROKER_INTERVAL; // Seconds between moving cache budget to the cache which misses the most
+	double CACHE_BUDGET_BROKER_STEP_FRACTION; // Fraction of the budget moved by one rebalance
+	double CACHE_BUDGET_BROKER_MIN_SHARE; // Fraction of an equal share of the budget no cache is shrunk below
+	double CACHE_BUDGET_BROKER_FULL_RATIO; // Caches using less than this fraction of their capacity do not grow
+
 	int REDWOOD_DEFAULT_PAGE_SIZE; // Page size for new Redwood files
 	int REDWOOD_DEFAULT_EXTENT_SIZE; // Extent size for new Redwood files
 	int REDWOOD_DEFAULT_EXTENT_READ_SIZE; // Extent read size for Redwood files
@@ -1218,6 +1245,9 @@ public:
 	bool REDWOOD_EVICT_UPDATED_PAGES; // Whether to prioritize eviction of updated pages from cache.
 	int REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT; // Minimum height for which to keep and reuse page decode caches
 	int REDWOOD_NODE_MAX_UNBALANCE; // Maximum imbalance in a node before it should be rebuilt instead of updated
+	int REDWOOD_LEAF_FILTER_BITS_PER_KEY; // Bits per key of the in-memory leaf page filters used by point reads, 0
+	                                      // disables them
+	int64_t REDWOOD_LEAF_FILTER_MAX_BYTES; // Memory limit for leaf page filters
 
 	std::string REDWOOD_IO_PRIORITIES;
 
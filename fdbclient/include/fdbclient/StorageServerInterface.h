@@ -125,6 +125,7 @@ struct StorageServerInterface {
 	RequestStream<struct AuditStorageRequest> auditStorage;
 	RequestStream<struct GetHotShardsRequest> getHotShards;
 	RequestStream<struct GetStorageCheckSumRequest> getCheckSum;
+	PublicRequestStream<struct WatchValuesRequest> watchValues;
 
 private:
 	bool acceptingRequests;
@@ -204,6 +205,8 @@ public:
 				    RequestStream<struct GetHotShardsRequest>(getValue.getEndpoint().getAdjustedEndpoint(24));
 				getCheckSum =
 				    RequestStream<struct GetStorageCheckSumRequest>(getValue.getEndpoint().getAdjustedEndpoint(25));
+				watchValues =
+				    PublicRequestStream<struct WatchValuesRequest>(getValue.getEndpoint().getAdjustedEndpoint(26));
 			}
 		} else {
 			ASSERT(Ar::isDeserializing);
@@ -258,6 +261,7 @@ public:
 		streams.push_back(auditStorage.getReceiver());
 		streams.push_back(getHotShards.getReceiver());
 		streams.push_back(getCheckSum.getReceiver());
+		streams.push_back(watchValues.getReceiver());
 		FlowTransport::transport().addEndpoints(streams);
 	}
 };
@@ -386,6 +390,63 @@ struct WatchValueRequest {
 	}
 };
 
+// A key watched by a WatchValuesRequest, together with the value it is expected to have. An absent value watches for
+// the key being set.
+struct WatchedValueRef {
+	KeyRef key;
+	Optional<ValueRef> value;
+
+	WatchedValueRef() {}
+	WatchedValueRef(KeyRef key, Optional<ValueRef> value) : key(key), value(value) {}
+	WatchedValueRef(Arena& a, const WatchedValueRef& copyFrom) : key(a, copyFrom.key), value(a, copyFrom.value) {}
+
+	int expectedSize() const { return key.expectedSize() + value.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, key, value);
+	}
+};
+
+struct WatchValuesReply : public ReplyPromiseStreamReply {
+	constexpr static FileIdentifier file_identifier = 9210531;
+	std::vector<int> fired; // Indices into WatchValuesRequest::keys of the keys whose value changed
+	Version version; // The version at which the fired keys were seen to differ from their watched values
+
+	WatchValuesReply() : version(invalidVersion) {}
+	WatchValuesReply(std::vector<int> fired, Version version) : fired(std::move(fired)), version(version) {}
+
+	int expectedSize() const { return sizeof(WatchValuesReply) + fired.size() * sizeof(int); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, ReplyPromiseStreamReply::acknowledgeToken, ReplyPromiseStreamReply::sequence, fired, version);
+	}
+};
+
+// Watches many keys with a single registration. The storage server streams back the indices of the keys whose value
+// no longer matches, in batches, and ends the stream once every key has fired. A key fires at most once.
+struct WatchValuesRequest {
+	constexpr static FileIdentifier file_identifier = 9210532;
+	SpanContext spanContext;
+	TenantInfo tenantInfo;
+	Arena arena;
+	VectorRef<WatchedValueRef> keys;
+	Version version;
+	Optional<TagSet> tags;
+	Optional<UID> debugID;
+	ReplyPromiseStream<WatchValuesReply> reply;
+
+	WatchValuesRequest() : version(invalidVersion) {}
+
+	bool verify() const { return tenantInfo.isAuthorized(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, keys, version, tags, debugID, reply, spanContext, tenantInfo, arena);
+	}
+};
+
 struct GetKeyValuesReply : public LoadBalancedReply {
 	constexpr static FileIdentifier file_identifier = 1783066;
 	Arena arena;
@@ -122,8 +122,130 @@ struct Tuple {
 
 private:
 	Tuple(const StringRef& data, bool exclude_incomplete = false, bool exclude_user_type = false);
+
+	// Starts a new element of exactly size bytes at the end of data and returns where to write it
+	uint8_t* appendElement(size_t size);
+
 	Standalone<VectorRef<uint8_t>> data;
 	std::vector<size_t> offsets;
 };
 
+// Encoding and decoding of single tuple elements in caller-provided memory, without building a Tuple. encodedSize()
+// returns exactly the number of bytes the matching encode() writes, and encode() returns the end of what it wrote.
+struct TupleElementCodec {
+	static size_t encodedSize(int64_t value);
+	static size_t encodedSize(int32_t value) { return encodedSize((int64_t)value); }
+	static size_t encodedSize(bool) { return 1; }
+	static size_t encodedSize(float) { return sizeof(float) + 1; }
+	static size_t encodedSize(double) { return sizeof(double) + 1; }
+	static size_t encodedSize(std::nullptr_t) { return 1; }
+	static size_t encodedSize(StringRef const& str) { return str.size() + countZeros(str.begin(), str.end()) + 2; }
+	static size_t encodedSize(Tuple::UnicodeStr const& str) { return encodedSize(str.str); }
+	static size_t encodedSize(TupleVersionstamp const&) { return VERSIONSTAMP_TUPLE_SIZE + 1; }
+
+	static uint8_t* encode(uint8_t* out, int64_t value);
+	static uint8_t* encode(uint8_t* out, int32_t value) { return encode(out, (int64_t)value); }
+	static uint8_t* encode(uint8_t* out, bool value);
+	static uint8_t* encode(uint8_t* out, float value);
+	static uint8_t* encode(uint8_t* out, double value);
+	static uint8_t* encode(uint8_t* out, std::nullptr_t);
+	static uint8_t* encode(uint8_t* out, StringRef const& str, bool utf8 = false);
+	static uint8_t* encode(uint8_t* out, Tuple::UnicodeStr const& str) { return encode(out, str.str, true); }
+	static uint8_t* encode(uint8_t* out, TupleVersionstamp const& versionstamp);
+
+	// Decodes the element starting at packed[offset] and advances offset past it. Throws invalid_tuple_data_type if the
+	// element is missing, truncated or of another type. Strings point into packed unless they contain escaped zero
+	// bytes, in which case they are unescaped into arena.
+	template <class T>
+	static T decode(StringRef packed, size_t& offset, Arena& arena);
+
+	static int64_t decodeInt(StringRef packed, size_t& offset);
+	static bool decodeBool(StringRef packed, size_t& offset);
+	static float decodeFloat(StringRef packed, size_t& offset);
+	static double decodeDouble(StringRef packed, size_t& offset);
+	static void decodeNull(StringRef packed, size_t& offset);
+	static StringRef decodeString(StringRef packed, size_t& offset, bool utf8, Arena& arena);
+	static TupleVersionstamp decodeVersionstamp(StringRef packed, size_t& offset);
+
+	// The first zero byte in [begin, end), or end
+	static const uint8_t* findZero(const uint8_t* begin, const uint8_t* end);
+	static size_t countZeros(const uint8_t* begin, const uint8_t* end);
+};
+
+template <>
+inline int64_t TupleElementCodec::decode<int64_t>(StringRef packed, size_t& offset, Arena&) {
+	return decodeInt(packed, offset);
+}
+template <>
+inline int32_t TupleElementCodec::decode<int32_t>(StringRef packed, size_t& offset, Arena&) {
+	return (int32_t)decodeInt(packed, offset);
+}
+template <>
+inline bool TupleElementCodec::decode<bool>(StringRef packed, size_t& offset, Arena&) {
+	return decodeBool(packed, offset);
+}
+template <>
+inline float TupleElementCodec::decode<float>(StringRef packed, size_t& offset, Arena&) {
+	return decodeFloat(packed, offset);
+}
+template <>
+inline double TupleElementCodec::decode<double>(StringRef packed, size_t& offset, Arena&) {
+	return decodeDouble(packed, offset);
+}
+template <>
+inline std::nullptr_t TupleElementCodec::decode<std::nullptr_t>(StringRef packed, size_t& offset, Arena&) {
+	decodeNull(packed, offset);
+	return nullptr;
+}
+template <>
+inline StringRef TupleElementCodec::decode<StringRef>(StringRef packed, size_t& offset, Arena& arena) {
+	return decodeString(packed, offset, false, arena);
+}
+template <>
+inline Tuple::UnicodeStr TupleElementCodec::decode<Tuple::UnicodeStr>(StringRef packed, size_t& offset, Arena& arena) {
+	return Tuple::UnicodeStr(decodeString(packed, offset, true, arena));
+}
+template <>
+inline TupleVersionstamp TupleElementCodec::decode<TupleVersionstamp>(StringRef packed, size_t& offset, Arena&) {
+	return decodeVersionstamp(packed, offset);
+}
+
+// A tuple of fixed shape, e.g. TupleSchema<StringRef, int64_t> for keys of the form (bytes, int). Packing sizes the
+// result up front and writes it with a single allocation (or none, into a caller buffer), and unpacking returns typed
+// values without building a Tuple. The encoding is the same as that of the equivalent Tuple.
+template <class... Types>
+struct TupleSchema {
+	static size_t packedSize(Types const&... values) { return (TupleElementCodec::encodedSize(values) + ... + 0); }
+
+	// Writes packedSize(values...) bytes to out and returns the end of them
+	static uint8_t* pack(uint8_t* out, Types const&... values) {
+		((out = TupleElementCodec::encode(out, values)), ...);
+		return out;
+	}
+
+	static StringRef pack(Arena& arena, Types const&... values) {
+		size_t size = packedSize(values...);
+		uint8_t* out = new (arena) uint8_t[size];
+		pack(out, values...);
+		return StringRef(out, size);
+	}
+
+	static Standalone<StringRef> pack(Types const&... values) {
+		Standalone<StringRef> result;
+		result.contents() = pack(result.arena(), values...);
+		return result;
+	}
+
+	// Throws invalid_tuple_data_type unless packed is exactly a tuple of this schema
+	static std::tuple<Types...> unpack(StringRef packed, Arena& arena) {
+		size_t offset = 0;
+		// Braced initialization evaluates the elements in order
+		std::tuple<Types...> result{ TupleElementCodec::decode<Types>(packed, offset, arena)... };
+		if (offset != packed.size()) {
+			throw invalid_tuple_data_type();
+		}
+		return result;
+	}
+};
+
 #endif /* FDBCLIENT_TUPLE_H */
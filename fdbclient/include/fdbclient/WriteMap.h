@@ -136,13 +136,21 @@ public:
 
 	WriteMap(WriteMap&& r) noexcept
 	  : arena(r.arena), writeMapEmpty(r.writeMapEmpty), writes(std::move(r.writes)), ver(r.ver),
-	    scratch_iterator(std::move(r.scratch_iterator)) {}
+	    pendingSets(std::move(r.pendingSets)), scratch_iterator(std::move(r.scratch_iterator)) {}
 
 	WriteMap& operator=(WriteMap&& r) noexcept;
 
 	// a write with addConflict false on top of an existing write with a conflict range will not remove the conflict
 	void mutate(KeyRef key, MutationRef::Type operation, ValueRef param, bool addConflict);
 
+	// Equivalent to mutate(key, SetValue, value, addConflict), but only appends the set to a buffer which is sorted and
+	// merged into the tree the next time the map is read or mutated in any other way. key and value must outlive the
+	// map, e.g. by being allocated in its arena.
+	void set(KeyRef key, ValueRef value, bool addConflict) {
+		writeMapEmpty = false;
+		pendingSets.emplace_back(key, value, addConflict);
+	}
+
 	void clear(KeyRangeRef keys, bool addConflict);
 
 	void addUnmodifiedAndUnreadableRange(KeyRangeRef keys);
@@ -155,7 +163,7 @@ public:
 		// regardless of the snapshot value) Every key will belong to exactly one segment.  The first segment begins at
 		// "" and the last segment ends at \xff\xff.
 
-		explicit iterator(WriteMap* map) : tree(map->writes), at(map->ver), offset(false) { ++map->ver; }
+		explicit iterator(WriteMap* map) : tree(map->getWrites()), at(map->ver), offset(false) { ++map->ver; }
 		// Creates an iterator which is conceptually before the beginning of map (you may essentially only call skip()
 		// or ++ on it) This iterator also represents a snapshot (will be unaffected by future writes)
 
@@ -219,8 +227,31 @@ private:
 	// incremented after reads, so that consecutive writes have the same version and those separated by
 	// reads have different versions.
 	Version ver;
+
+	struct PendingSet {
+		KeyRef key;
+		ValueRef value;
+		bool addConflict;
+
+		PendingSet(KeyRef key, ValueRef value, bool addConflict) : key(key), value(value), addConflict(addConflict) {}
+	};
+	// Sets made through set() which have not been merged into writes yet, in the order they were made
+	std::vector<PendingSet> pendingSets;
+
 	iterator scratch_iterator; // Avoid unnecessary memory allocation in write operations
 
+	Tree const& getWrites() {
+		applyPendingSets();
+		return writes;
+	}
+
+	void applyPendingSets() {
+		if (!pendingSets.empty())
+			mergePendingSets();
+	}
+	void mergePendingSets();
+	void mutateNow(KeyRef key, MutationRef::Type operation, ValueRef param, bool addConflict);
+
 	void dump();
 
 	// SOMEDAY: clearNoConflict replaces cleared sets with two map entries for everyone one item cleared
@@ -69,6 +69,23 @@ Future<Void> g_currentDeliveryPeerDisconnect;
 constexpr int PACKET_LEN_WIDTH = sizeof(uint32_t);
 const uint64_t TOKEN_STREAM_FLAG = 1;
 
+// Endpoints with a priority below BULK_ENDPOINT_PRIORITY, such as the replies to fetchKeys, have these bits of their
+// token set to TOKEN_BULK_PATTERN, so that senders can put their traffic on one of the peer's bulk connection lanes.
+// The tokens of all other endpoints are kept off the pattern.
+const uint64_t TOKEN_BULK_MASK = 0x1fe;
+const uint64_t TOKEN_BULK_PATTERN = 0x0b6 << 1;
+
+static uint64_t setBulkToken(uint64_t first, bool bulk) {
+	if (bulk) {
+		return (first & ~TOKEN_BULK_MASK) | TOKEN_BULK_PATTERN;
+	}
+	return (first & TOKEN_BULK_MASK) == TOKEN_BULK_PATTERN ? first ^ 2 : first;
+}
+
+static bool isBulkToken(Endpoint::Token const& token) {
+	return (token.first() & TOKEN_BULK_MASK) == TOKEN_BULK_PATTERN;
+}
+
 FDB_BOOLEAN_PARAM(InReadSocket);
 FDB_BOOLEAN_PARAM(IsStableConnection);
 
@@ -160,7 +177,9 @@ const Endpoint& EndpointMap::insert(NetworkAddressList localAddresses,
 		}
 	}
 
+	// Senders compute the tokens of the other streams from the first, so they can't be marked as bulk
 	UID base = deterministicRandom()->randomUniqueID();
+	base = UID(setBulkToken(base.first(), false), base.second());
 	for (uint64_t i = 0; i < streams.size(); i++) {
 		int index = adjacentStart + i;
 		uint64_t first = (base.first() + (i << 32)) | TOKEN_STREAM_FLAG;
@@ -307,6 +326,7 @@ public:
 		bytesSent.init("Net2.BytesSent"_sr);
 		countPacketsReceived.init("Net2.CountPacketsReceived"_sr);
 		countPacketsGenerated.init("Net2.CountPacketsGenerated"_sr);
+		countWrites.init("Net2.CountWrites"_sr);
 		countConnEstablished.init("Net2.CountConnEstablished"_sr);
 		countConnClosedWithError.init("Net2.CountConnClosedWithError"_sr);
 		countConnClosedWithoutError.init("Net2.CountConnClosedWithoutError"_sr);
@@ -335,6 +355,7 @@ public:
 	Int64MetricHandle bytesSent;
 	Int64MetricHandle countPacketsReceived;
 	Int64MetricHandle countPacketsGenerated;
+	Int64MetricHandle countWrites;
 	Int64MetricHandle countConnEstablished;
 	Int64MetricHandle countConnClosedWithError;
 	Int64MetricHandle countConnClosedWithoutError;
@@ -392,13 +413,20 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				    .detail("ConnectMaxLatency", peer->connectLatencies.max())
 				    .detail("ConnectMeanLatency", peer->connectLatencies.mean())
 				    .detail("ConnectMedianLatency", peer->connectLatencies.median())
-				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90));
+				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90))
+				    .detail("PacketsWritten", peer->packetsWritten)
+				    .detail("Writes", peer->writes)
+				    .detail("PacketsPerWrite", peer->writes ? (double)peer->packetsWritten / peer->writes : 0.0)
+				    .detail("PacketRate", peer->packetRate)
+				    .detail("CoalesceDelay", peer->getCoalesceDelay(0));
 				peer->lastLoggedTime = now();
 				peer->connectOutgoingCount = 0;
 				peer->connectIncomingCount = 0;
 				peer->connectFailedCount = 0;
 				peer->pingLatencies.clear();
 				peer->connectLatencies.clear();
+				peer->packetsWritten = 0;
+				peer->writes = 0;
 				peer->lastLoggedBytesReceived = peer->bytesReceived;
 				peer->lastLoggedBytesSent = peer->bytesSent;
 				peer->timeoutCount = 0;
@@ -437,7 +465,8 @@ struct ConnectPacket {
 	// IP Address to reconnect to the originating process. Only one of these must be populated.
 	uint32_t canonicalRemoteIp4 = 0;
 
-	enum ConnectPacketFlags { FLAG_IPV6 = 1 };
+	// The bits from FLAG_LANE_SHIFT up hold the connection lane of the sending peer (see Peer::lane)
+	enum ConnectPacketFlags { FLAG_IPV6 = 1, FLAG_LANE_SHIFT = 8 };
 	uint16_t flags = 0;
 	uint8_t canonicalRemoteIp6[16] = { 0 };
 
@@ -465,6 +494,9 @@ struct ConnectPacket {
 
 	bool isIPv6() const { return flags & FLAG_IPV6; }
 
+	int lane() const { return flags >> FLAG_LANE_SHIFT; }
+	void setLane(int lane) { flags = (flags & ((1 << FLAG_LANE_SHIFT) - 1)) | (lane << FLAG_LANE_SHIFT); }
+
 	uint32_t totalPacketSize() const { return connectPacketLength + sizeof(connectPacketLength); }
 
 	template <class Ar>
@@ -549,7 +581,13 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 
 		// TODO: Stop monitoring and close the connection with no onDisconnect requests outstanding
 		state PingRequest pingRequest;
-		FlowTransport::transport().sendUnreliable(SerializeSource<PingRequest>(pingRequest), remotePingEndpoint, true);
+		if (peer->lane) {
+			// Each lane is pinged over its own connection
+			sendPacket(peer->transport, peer, SerializeSource<PingRequest>(pingRequest), remotePingEndpoint, false);
+		} else {
+			FlowTransport::transport().sendUnreliable(
+			    SerializeSource<PingRequest>(pingRequest), remotePingEndpoint, true);
+		}
 		state int64_t startingBytes = peer->bytesReceived;
 		state int timeouts = 0;
 		state double startTime = now();
@@ -591,17 +629,18 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 	state double lastWriteTime = now();
 	loop {
 		// wait( delay(0, TaskPriority::WriteSocket) );
-		wait(delayJittered(
-		    std::max<double>(FLOW_KNOBS->MIN_COALESCE_DELAY, FLOW_KNOBS->MAX_COALESCE_DELAY - (now() - lastWriteTime)),
-		    TaskPriority::WriteSocket));
+		wait(delayJittered(self->getCoalesceDelay(now() - lastWriteTime), TaskPriority::WriteSocket));
 		// wait( delay(500e-6, TaskPriority::WriteSocket) );
 		// wait( yield(TaskPriority::WriteSocket) );
+		self->onFlush();
 
 		// Send until there is nothing left to send
 		loop {
 			lastWriteTime = now();
 
 			int sent = conn->write(self->unsent.getUnsent(), /* limit= */ FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+			++self->writes;
+			++self->transport->countWrites;
 			if (sent) {
 				self->bytesSent += sent;
 				self->transport->bytesSent += sent;
@@ -877,8 +916,12 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 				throw;
 			// Try to recover, even from serious errors, by retrying
 
+			if (self->lane && self->reliable.empty() && self->unsent.empty() && self->outstandingReplies == 0) {
+				// Lanes belong to their primary peer, and are reconnected by the next send which picks them
+				return Void();
+			}
 			if (self->peerReferences <= 0 && self->reliable.empty() && self->unsent.empty() &&
-			    self->outstandingReplies == 0) {
+			    self->outstandingReplies == 0 && self->lanesIdle()) {
 				TraceEvent("PeerDestroy").errorUnsuppressed(e).suppressFor(1.0).detail("PeerAddr", self->destination);
 				self->connect.cancel();
 				self->transport->peers.erase(self->destination);
@@ -889,19 +932,61 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 	}
 }
 
-Peer::Peer(TransportData* transport, NetworkAddress const& destination)
+Peer::Peer(TransportData* transport, NetworkAddress const& destination, int lane)
   : transport(transport), destination(destination), compatible(true), connected(false), outgoingConnectionIdle(true),
     lastConnectTime(0.0), reconnectionDelay(FLOW_KNOBS->INITIAL_RECONNECTION_TIME), peerReferences(-1),
     bytesReceived(0), bytesSent(0), lastDataPacketSentTime(now()), outstandingReplies(0),
     pingLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), lastLoggedTime(0.0),
-    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0),
+    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0), unsentPackets(0), packetRate(0),
+    lastFlushTime(now()),
     protocolVersion(Reference<AsyncVar<Optional<ProtocolVersion>>>(new AsyncVar<Optional<ProtocolVersion>>())),
     connectOutgoingCount(0), connectIncomingCount(0), connectFailedCount(0),
-    connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1) {
-	IFailureMonitor::failureMonitor().setStatus(destination, FailureStatus(false));
+    connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), packetsWritten(0), writes(0),
+    lane(lane) {
+	if (lane == 0) {
+		IFailureMonitor::failureMonitor().setStatus(destination, FailureStatus(false));
+	}
+}
+
+Reference<Peer> Peer::getLane(int lane) {
+	ASSERT(this->lane == 0 && lane > 0);
+	if (lanes.size() < lane) {
+		lanes.resize(lane);
+	}
+	Reference<Peer>& p = lanes[lane - 1];
+	if (!p) {
+		p = makeReference<Peer>(transport, destination, lane);
+	}
+	return p;
+}
+
+Reference<Peer> Peer::laneFor(Reference<Peer> self, Endpoint::Token const& token) {
+	// Only connections between servers are striped, since clients don't accept connections and a lane opened by the
+	// other side couldn't be matched up with its primary connection
+	if (FLOW_KNOBS->PEER_CONNECTION_LANES <= 1 || lane != 0 || !compatible || !destination.isPublic() ||
+	    !isBulkToken(token)) {
+		return self;
+	}
+	// Lane 0 carries everything else, and the packets for any one endpoint always use the same lane so they stay in
+	// order
+	Reference<Peer> p = getLane(1 + (token.first() >> 32) % (FLOW_KNOBS->PEER_CONNECTION_LANES - 1));
+	if (!p->connect.isValid() || p->connect.isReady()) {
+		p->connect = connectionKeeper(p);
+	}
+	return p;
+}
+
+bool Peer::lanesIdle() const {
+	for (auto const& p : lanes) {
+		if (p && (!p->reliable.empty() || !p->unsent.empty() || p->outstandingReplies)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 void Peer::send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent) {
+	++unsentPackets;
 	unsent.setWriteBuffer(pb);
 	if (rp)
 		reliable.insert(rp);
@@ -909,6 +994,30 @@ void Peer::send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent) {
 		dataToSend.trigger();
 }
 
+double Peer::getCoalesceDelay(double sinceLastWrite) const {
+	// Packets queued since the last write are sent after at most MAX_COALESCE_DELAY, and an idle connection writes
+	// after MIN_COALESCE_DELAY
+	double delay = std::max<double>(FLOW_KNOBS->MIN_COALESCE_DELAY, FLOW_KNOBS->MAX_COALESCE_DELAY - sinceLastWrite);
+	if (packetRate * FLOW_KNOBS->MAX_ADAPTIVE_COALESCE_DELAY < FLOW_KNOBS->COALESCE_MIN_PACKETS) {
+		return delay;
+	}
+	// Busy connections wait long enough to batch COALESCE_TARGET_PACKETS, measured from the last write as above
+	double window = std::min(FLOW_KNOBS->MAX_ADAPTIVE_COALESCE_DELAY, FLOW_KNOBS->COALESCE_TARGET_PACKETS / packetRate);
+	return std::max(delay, window - sinceLastWrite);
+}
+
+void Peer::onFlush() {
+	// An exponentially weighted moving average over time, so that a gap of COALESCE_RATE_WINDOW forgets the old rate
+	double elapsed = now() - lastFlushTime;
+	if (elapsed > 0) {
+		double weight = std::min(1.0, elapsed / FLOW_KNOBS->COALESCE_RATE_WINDOW);
+		packetRate += weight * (unsentPackets / elapsed - packetRate);
+		lastFlushTime = now();
+		packetsWritten += unsentPackets;
+		unsentPackets = 0;
+	}
+}
+
 void Peer::prependConnectPacket() {
 	// Send the ConnectPacket expected at the beginning of a new connection
 	ConnectPacket pkt;
@@ -928,6 +1037,7 @@ void Peer::prependConnectPacket() {
 	pkt.protocolVersion = g_network->protocolVersion();
 	pkt.protocolVersion.addObjectSerializerFlag();
 	pkt.connectionId = transport->transportId;
+	pkt.setLane(lane);
 
 	PacketBuffer *pb_first = PacketBuffer::create(), *pb_end = nullptr;
 	PacketWriter wr(pb_first, nullptr, Unversioned());
@@ -1003,6 +1113,11 @@ void Peer::onIncomingConnection(Reference<Peer> self, Reference<IConnection> con
 TransportData::~TransportData() {
 	for (auto& p : peers) {
 		p.second->connect.cancel();
+		for (auto& lane : p.second->lanes) {
+			if (lane) {
+				lane->connect.cancel();
+			}
+		}
 	}
 }
 
@@ -1420,6 +1535,10 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 								                             NetworkAddressFromHostname(peerAddress.fromHostname));
 							}
 							peer = transport->getOrOpenPeer(peerAddress, false);
+							if (pkt.lane() && pkt.canonicalRemotePort) {
+								// One of the remote peer's bulk lanes, which pairs with the lane of the same index here
+								peer = peer->getLane(pkt.lane());
+							}
 							peer->compatible = compatible;
 							if (!compatible) {
 								peer->transport->numIncompatibleConnections++;
@@ -1732,6 +1851,8 @@ void FlowTransport::addEndpoint(Endpoint& endpoint, NetworkMessageReceiver* rece
 		endpoint.addresses = NetworkAddressList();
 		endpoint.token = UID(endpoint.token.first() & ~TOKEN_STREAM_FLAG, endpoint.token.second());
 	}
+	bool bulk = static_cast<int>(taskID) < FLOW_KNOBS->BULK_ENDPOINT_PRIORITY;
+	endpoint.token = UID(setBulkToken(endpoint.token.first(), bulk), endpoint.token.second());
 	self->endpoints.insert(receiver, endpoint.token, taskID);
 }
 
@@ -1914,6 +2035,7 @@ ReliablePacket* FlowTransport::sendReliable(ISerializeSource const& what, const
 		return nullptr;
 	}
 	Reference<Peer> peer = self->getOrOpenPeer(destination.getPrimaryAddress());
+	peer = peer->laneFor(peer, destination.token);
 	return sendPacket(self, peer, what, destination, true);
 }
 
@@ -1937,6 +2059,9 @@ Reference<Peer> FlowTransport::sendUnreliable(ISerializeSource const& what,
 	} else {
 		peer = self->getPeer(destination.getPrimaryAddress());
 	}
+	if (peer) {
+		peer = peer->laneFor(peer, destination.token);
+	}
 
 	sendPacket(self, peer, what, destination, false);
 	return peer;
@@ -222,7 +222,8 @@ LatencySample::LatencySample(std::string name,
                              double loggingInterval,
                              double accuracy,
                              bool skipTraceOnSilentInterval)
-  : name(name), IMetric(knobToMetricModel(FLOW_KNOBS->METRICS_DATA_MODEL)), id(id), sampleEmit(now()), sketch(accuracy),
+  : name(name), IMetric(knobToMetricModel(FLOW_KNOBS->METRICS_DATA_MODEL)), id(id), sampleEmit(now()),
+    accuracy(accuracy), histogram(HdrHistogram::significantBitsFor(accuracy)),
     latencySampleEventHolder(makeReference<EventCacheHolder>(id.toString() + "/" + name)),
     skipTraceOnSilentInterval(skipTraceOnSilentInterval) {
 	logger = recurring([this]() { logSample(); }, loggingInterval);
@@ -233,33 +234,33 @@ LatencySample::LatencySample(std::string name,
 	p999id = deterministicRandom()->randomUniqueID();
 }
 
-void LatencySample::addMeasurement(double measurement) {
-	sketch.addSample(measurement);
-}
-
 void LatencySample::logSample() {
-	if (skipTraceOnSilentInterval && sketch.getPopulationSize() == 0) {
+	if (skipTraceOnSilentInterval && histogram.count() == 0) {
 		return;
 	}
-	double p25 = sketch.percentile(0.25);
-	double p50 = sketch.mean();
-	double p90 = sketch.percentile(0.9);
-	double p95 = sketch.percentile(0.95);
-	double p99 = sketch.percentile(0.99);
-	double p99_9 = sketch.percentile(0.999);
-	TraceEvent(name.c_str(), id)
-	    .detail("Count", sketch.getPopulationSize())
+	double p25 = histogram.percentile(0.25) * resolution;
+	double p50 = histogram.percentile(0.5) * resolution;
+	double p90 = histogram.percentile(0.9) * resolution;
+	double p95 = histogram.percentile(0.95) * resolution;
+	double p99 = histogram.percentile(0.99) * resolution;
+	double p99_9 = histogram.percentile(0.999) * resolution;
+	TraceEvent ev(name.c_str(), id);
+	ev.setMaxEventLength(-1)
+	    .detail("Count", histogram.count())
 	    .detail("Elapsed", now() - sampleEmit)
-	    .detail("Min", sketch.min())
-	    .detail("Max", sketch.max())
-	    .detail("Mean", sketch.mean())
+	    .detail("Min", histogram.min() * resolution)
+	    .detail("Max", histogram.max() * resolution)
+	    .detail("Mean", histogram.mean() * resolution)
 	    .detail("Median", p50)
 	    .detail("P25", p25)
 	    .detail("P90", p90)
 	    .detail("P95", p95)
 	    .detail("P99", p99)
-	    .detail("P99.9", p99_9)
-	    .trackLatest(latencySampleEventHolder->trackingKey);
+	    .detail("P99.9", p99_9);
+	if (FLOW_KNOBS->LATENCY_SAMPLE_TRACE_HISTOGRAM) {
+		ev.setMaxFieldLength(-1).detail("Histogram", histogram.toString());
+	}
+	ev.trackLatest(latencySampleEventHolder->trackingKey);
 	MetricCollection* metrics = MetricCollection::getMetricCollection();
 	if (metrics != nullptr) {
 		NetworkAddress addr = g_network->getLocalAddress();
@@ -269,16 +270,20 @@ void LatencySample::logSample() {
 		case MetricsDataModel::OTLP: {
 			// We only want to emit the entire DDSketch if the knob is set
 			if (FLOW_KNOBS->METRICS_EMIT_DDSKETCH) {
+				// Collectors expect DDSketch buckets, so each bucket of the histogram is added at its midpoint
+				DDSketch<double> sketch(accuracy);
+				histogram.forEachBucket([&](uint64_t lowest, uint64_t highest, uint32_t count) {
+					sketch.addSamples((lowest + (highest - lowest) / 2) * resolution, count);
+				});
+				double min = histogram.min() * resolution;
+				double max = histogram.max() * resolution;
+				double sum = histogram.getSum() * resolution;
 				if (metrics->histMap.find(IMetric::id) != metrics->histMap.end()) {
 					metrics->histMap[IMetric::id].points.emplace_back(
-					    sketch.getErrorGuarantee(), sketch.getSamples(), sketch.min(), sketch.max(), sketch.getSum());
+					    sketch.getErrorGuarantee(), sketch.getSamples(), min, max, sum);
 				} else {
-					metrics->histMap[IMetric::id] = OTEL::OTELHistogram(name,
-					                                                    sketch.getErrorGuarantee(),
-					                                                    sketch.getSamples(),
-					                                                    sketch.min(),
-					                                                    sketch.max(),
-					                                                    sketch.getSum());
+					metrics->histMap[IMetric::id] =
+					    OTEL::OTELHistogram(name, sketch.getErrorGuarantee(), sketch.getSamples(), min, max, sum);
 				}
 				metrics->histMap[IMetric::id].points.back().addAttribute("ip", ip_str);
 				metrics->histMap[IMetric::id].points.back().addAttribute("port", port_str);
@@ -309,6 +314,6 @@ void LatencySample::logSample() {
 		}
 		}
 	}
-	sketch.clear();
+	histogram.clear();
 	sampleEmit = now();
 }
@@ -112,6 +112,28 @@ public:
 		return *this;
 	}
 
+	// Adds count copies of sample, e.g. to convert a histogram with other buckets into a sketch
+	DDSketchBase<Impl, T>& addSamples(T sample, uint32_t count) {
+		if (count == 0)
+			return *this;
+		if (!populationSize)
+			minValue = maxValue = sample;
+
+		if (sample <= EPS) {
+			zeroPopulationSize += count;
+		} else {
+			size_t index = static_cast<Impl*>(this)->getIndex(sample);
+			ASSERT(index >= 0 && index < buckets.size());
+			buckets[index] += count;
+		}
+
+		populationSize += count;
+		sum += sample * count;
+		maxValue = std::max(maxValue, sample);
+		minValue = std::min(minValue, sample);
+		return *this;
+	}
+
 	double mean() const {
 		if (populationSize == 0)
 			return 0;
@@ -170,6 +170,11 @@ struct Peer : public ReferenceCounted<Peer> {
 	int64_t lastLoggedBytesSent;
 	int timeoutCount;
 
+	// Used to pick how long connectionWriter waits to batch packets into one write, see getCoalesceDelay()
+	int64_t unsentPackets; // Packets queued since the last flush began
+	double packetRate; // Packets queued per second, smoothed over COALESCE_RATE_WINDOW
+	double lastFlushTime;
+
 	Reference<AsyncVar<Optional<ProtocolVersion>>> protocolVersion;
 
 	// Cleared every time stats are logged for this peer.
@@ -177,17 +182,43 @@ struct Peer : public ReferenceCounted<Peer> {
 	int connectIncomingCount;
 	int connectFailedCount;
 	DDSketch<double> connectLatencies;
+	int64_t packetsWritten;
+	int64_t writes;
 	Promise<Void> disconnect;
 
-	explicit Peer(TransportData* transport, NetworkAddress const& destination);
+	// With PEER_CONNECTION_LANES > 1, packets for bulk endpoints go over separate connections so that they don't hold
+	// up latency sensitive ones. Each connection has its own Peer: lane 0 is the one in TransportData::peers, and it
+	// owns the others.
+	int lane;
+	std::vector<Reference<Peer>> lanes;
+
+	explicit Peer(TransportData* transport, NetworkAddress const& destination, int lane = 0);
 
 	void send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent);
 
+	// How long to wait before writing, given the time since the last write. While the connection is busy enough that
+	// waiting would batch several packets, this aims for COALESCE_TARGET_PACKETS per write within
+	// MAX_ADAPTIVE_COALESCE_DELAY. Otherwise it waits between MIN_COALESCE_DELAY and MAX_COALESCE_DELAY.
+	double getCoalesceDelay(double sinceLastWrite) const;
+
+	// Called when connectionWriter starts writing the unsent packets
+	void onFlush();
+
 	void prependConnectPacket();
 
 	void discardUnreliablePackets();
 
 	void onIncomingConnection(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader);
+
+	// Returns the Peer of the given lane, creating it if necessary
+	Reference<Peer> getLane(int lane);
+
+	// Returns the Peer whose connection packets for token are sent on, starting its connection if necessary. All the
+	// packets for an endpoint go on the same lane, so they stay in order.
+	Reference<Peer> laneFor(Reference<Peer> self, Endpoint::Token const& token);
+
+	// True if no lane has anything left to send or any outstanding replies
+	bool lanesIdle() const;
 };
 
 class IPAllowList;
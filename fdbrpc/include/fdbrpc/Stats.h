@@ -46,6 +46,7 @@ MyCounters() : foo("foo", cc), bar("bar", cc), baz("baz", cc) {}
 #include "flow/flow.h"
 #include "flow/TDMetric.actor.h"
 #include "fdbrpc/DDSketch.h"
+#include "flow/HdrHistogram.h"
 
 struct ICounter : public IMetric {
 	// All counters have a name and value
@@ -229,6 +230,9 @@ public:
 	~LatencyBands();
 };
 
+// Logs the distribution of a measurement (usually a latency in seconds) every loggingInterval. The values reported are
+// within a relative error of accuracy, and the distribution itself is logged in the Histogram field so that status can
+// merge it across processes.
 class LatencySample : public IMetric {
 public:
 	LatencySample(std::string name,
@@ -236,7 +240,13 @@ public:
 	              double loggingInterval,
 	              double accuracy,
 	              bool skipTraceOnSilentInterval = false);
-	void addMeasurement(double measurement);
+	void addMeasurement(double measurement) {
+		histogram.record(static_cast<uint64_t>(std::clamp(measurement, 0.0, maxMeasurement) / resolution));
+	}
+
+	// Measurements are recorded in the histogram as integer multiples of resolution
+	static constexpr double resolution = 1e-9;
+	static constexpr double maxMeasurement = 1e10;
 
 private:
 	std::string name;
@@ -254,7 +264,8 @@ private:
 	UID p999id;
 	double sampleEmit;
 
-	DDSketch<double> sketch;
+	double accuracy;
+	HdrHistogram histogram;
 	Future<Void> logger;
 	bool skipTraceOnSilentInterval;
 
@@ -49,6 +49,7 @@
 
 #include "flow/Arena.h"
 #include "flow/CompressionUtils.h"
+#include "flow/ComputePool.h"
 #include "flow/EncryptUtils.h"
 #include "flow/Error.h"
 #include "flow/flow.h"
@@ -711,12 +712,19 @@ ACTOR Future<BlobFileIndex> writeDeltaFile(Reference<BlobWorkerData> bwData,
 
 	state Optional<CompressionFilter> compressFilter = getBlobFileCompressFilter();
 	ASSERT(!bwData->encryptMode.isEncryptionEnabled() || cipherKeysCtx.present());
-	state Value serialized = serializeChunkedDeltaFile(StringRef(fileName),
-	                                                   deltasToWrite,
-	                                                   keyRange,
-	                                                   SERVER_KNOBS->BG_DELTA_FILE_TARGET_CHUNK_BYTES,
-	                                                   compressFilter,
-	                                                   cipherKeysCtx);
+	// Compressing and encrypting the file is pure CPU work, so do it on the compute pool
+	state Value serialized = wait(runOnComputePool(
+	    [fileName = fileName,
+	     deltas = deltasToWrite,
+	     keyRange = keyRange,
+	     chunkSize = SERVER_KNOBS->BG_DELTA_FILE_TARGET_CHUNK_BYTES,
+	     compressFilter = compressFilter,
+	     cipherKeysArena = arena, // Owns what cipherKeysCtx points to
+	     cipherKeysCtx = cipherKeysCtx]() {
+		    return serializeChunkedDeltaFile(
+		        StringRef(fileName), deltas, keyRange, chunkSize, compressFilter, cipherKeysCtx);
+	    },
+	    TaskPriority::BlobWorkerUpdateStorage));
 	state size_t logicalSize = deltasToWrite.expectedSize();
 	state size_t serializedSize = serialized.size();
 	bwData->stats.compressionBytesRaw += logicalSize;
@@ -1021,11 +1029,17 @@ ACTOR Future<BlobFileIndex> writeSnapshot(Reference<BlobWorkerData> bwData,
 
 	state Optional<CompressionFilter> compressFilter = getBlobFileCompressFilter();
 	ASSERT(!bwData->encryptMode.isEncryptionEnabled() || cipherKeysCtx.present());
-	state Value serialized = serializeChunkedSnapshot(StringRef(fileName),
-	                                                  snapshot,
-	                                                  SERVER_KNOBS->BG_SNAPSHOT_FILE_TARGET_CHUNK_BYTES,
-	                                                  compressFilter,
-	                                                  cipherKeysCtx);
+	// Compressing and encrypting the file is pure CPU work, so do it on the compute pool
+	state Value serialized = wait(runOnComputePool(
+	    [fileName = fileName,
+	     snapshot = snapshot,
+	     chunkSize = SERVER_KNOBS->BG_SNAPSHOT_FILE_TARGET_CHUNK_BYTES,
+	     compressFilter = compressFilter,
+	     cipherKeysArena = arena, // Owns what cipherKeysCtx points to
+	     cipherKeysCtx = cipherKeysCtx]() {
+		    return serializeChunkedSnapshot(StringRef(fileName), snapshot, chunkSize, compressFilter, cipherKeysCtx);
+	    },
+	    TaskPriority::BlobWorkerUpdateStorage));
 	state size_t logicalSize = snapshot.expectedSize();
 	state size_t serializedSize = serialized.size();
 	bwData->stats.compressionBytesRaw += logicalSize;
@@ -0,0 +1,258 @@
+/*
+ * CacheBudgetBroker.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/CacheBudgetBroker.h"
+#include "flow/UnitTest.h"
+
+CacheBudgetBroker& CacheBudgetBroker::getBroker() {
+	static CacheBudgetBroker nonSimBroker(SERVER_KNOBS->CACHE_BUDGET_BROKER_BYTES);
+	static std::map<NetworkAddress, CacheBudgetBroker> simBrokers;
+
+	if (g_network->isSimulated()) {
+		auto it = simBrokers.find(g_network->getLocalAddress());
+		if (it == simBrokers.end()) {
+			it = simBrokers
+			         .emplace(std::piecewise_construct,
+			                  std::forward_as_tuple(g_network->getLocalAddress()),
+			                  std::forward_as_tuple(SERVER_KNOBS->CACHE_BUDGET_BROKER_BYTES))
+			         .first;
+		}
+		return it->second;
+	} else {
+		return nonSimBroker;
+	}
+}
+
+void CacheBudgetBroker::addConsumer(Reference<ICacheBudgetConsumer> consumer) {
+	Consumer& c = consumers[consumer->getCacheID()];
+	if (c.refs++ > 0) {
+		return;
+	}
+	c.consumer = consumer;
+	c.lastHits = consumer->getHits();
+	c.lastMisses = consumer->getMisses();
+	TraceEvent("CacheBudgetConsumerAdded")
+	    .detail("Name", consumer->getName())
+	    .detail("Capacity", consumer->getCapacity())
+	    .detail("Consumers", consumers.size())
+	    .detail("Budget", budget);
+	distribute();
+}
+
+void CacheBudgetBroker::removeConsumer(Reference<ICacheBudgetConsumer> consumer) {
+	auto it = consumers.find(consumer->getCacheID());
+	if (it == consumers.end() || --it->second.refs > 0) {
+		return;
+	}
+	TraceEvent("CacheBudgetConsumerRemoved")
+	    .detail("Name", consumer->getName())
+	    .detail("Consumers", consumers.size() - 1)
+	    .detail("Budget", budget);
+	consumers.erase(it);
+	distribute();
+}
+
+int64_t CacheBudgetBroker::minCapacity() const {
+	if (consumers.empty()) {
+		return budget;
+	}
+	return budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_MIN_SHARE / consumers.size();
+}
+
+void CacheBudgetBroker::distribute() {
+	if (budget <= 0 || consumers.empty()) {
+		return;
+	}
+
+	double total = 0;
+	for (auto& [id, c] : consumers) {
+		total += std::max<int64_t>(c.consumer->getCapacity(), 1);
+	}
+
+	// Every consumer gets the floor and the rest of the budget is split proportionally, so the grants never add up
+	// to more than the budget.
+	const int64_t floor = std::min<int64_t>(minCapacity(), budget / consumers.size());
+	const int64_t spare = budget - floor * (int64_t)consumers.size();
+	for (auto& [id, c] : consumers) {
+		int64_t capacity = std::max<int64_t>(c.consumer->getCapacity(), 1) / total * spare;
+		c.consumer->setCapacity(floor + capacity);
+	}
+}
+
+void CacheBudgetBroker::maybeRebalance() {
+	if (budget > 0 && now() - lastRebalance >= SERVER_KNOBS->CACHE_BUDGET_BROKER_INTERVAL) {
+		rebalance();
+	}
+}
+
+void CacheBudgetBroker::rebalance() {
+	lastRebalance = now();
+
+	ICacheBudgetConsumer* receiver = nullptr;
+	ICacheBudgetConsumer* donor = nullptr;
+	double receiverUtility = 0;
+	double donorUtility = 0;
+	const int64_t floor = minCapacity();
+
+	for (auto& [id, c] : consumers) {
+		int64_t hits = c.consumer->getHits();
+		int64_t misses = c.consumer->getMisses();
+		int64_t newHits = hits - c.lastHits;
+		int64_t newMisses = misses - c.lastMisses;
+		c.lastHits = hits;
+		c.lastMisses = misses;
+
+		int64_t capacity = c.consumer->getCapacity();
+		int64_t usage = c.consumer->getUsage();
+		bool full = capacity > 0 && usage >= capacity * SERVER_KNOBS->CACHE_BUDGET_BROKER_FULL_RATIO;
+		double utility = full ? (double)newMisses / capacity : 0;
+
+		TraceEvent("CacheBudgetConsumer")
+		    .detail("Name", c.consumer->getName())
+		    .detail("Capacity", capacity)
+		    .detail("Usage", usage)
+		    .detail("Hits", newHits)
+		    .detail("Misses", newMisses)
+		    .detail("HitRate", newHits + newMisses > 0 ? (double)newHits / (newHits + newMisses) : 0)
+		    .detail("MarginalUtility", utility);
+
+		if (utility > receiverUtility) {
+			receiver = c.consumer.getPtr();
+			receiverUtility = utility;
+		}
+		if (capacity > floor && (donor == nullptr || utility < donorUtility)) {
+			donor = c.consumer.getPtr();
+			donorUtility = utility;
+		}
+	}
+
+	if (receiver == nullptr || donor == nullptr || receiver == donor || receiverUtility <= donorUtility) {
+		return;
+	}
+
+	int64_t step = std::min<int64_t>(budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_STEP_FRACTION,
+	                                  donor->getCapacity() - floor);
+	if (step <= 0) {
+		return;
+	}
+	donor->setCapacity(donor->getCapacity() - step);
+	receiver->setCapacity(receiver->getCapacity() + step);
+
+	TraceEvent("CacheBudgetRebalance")
+	    .detail("From", donor->getName())
+	    .detail("FromCapacity", donor->getCapacity())
+	    .detail("FromMarginalUtility", donorUtility)
+	    .detail("To", receiver->getName())
+	    .detail("ToCapacity", receiver->getCapacity())
+	    .detail("ToMarginalUtility", receiverUtility)
+	    .detail("Bytes", step);
+}
+
+namespace {
+
+struct TestCacheBudgetConsumer : ICacheBudgetConsumer {
+	TestCacheBudgetConsumer(std::string name, int64_t capacity) : name(name), capacity(capacity) {}
+
+	const void* getCacheID() const override { return this; }
+	std::string getName() const override { return name; }
+	int64_t getCapacity() const override { return capacity; }
+	void setCapacity(int64_t bytes) override { capacity = bytes; }
+	int64_t getUsage() const override { return usage; }
+	int64_t getHits() const override { return hits; }
+	int64_t getMisses() const override { return misses; }
+
+	std::string name;
+	int64_t capacity;
+	int64_t usage = 0;
+	int64_t hits = 0;
+	int64_t misses = 0;
+};
+
+} // namespace
+
+TEST_CASE("/fdbserver/CacheBudgetBroker/Rebalance") {
+	const int64_t budget = 1e6;
+	CacheBudgetBroker broker(budget);
+
+	auto a = makeReference<TestCacheBudgetConsumer>("A", 3e6);
+	auto b = makeReference<TestCacheBudgetConsumer>("B", 1e6);
+
+	// A single consumer gets the whole budget
+	broker.addConsumer(a);
+	ASSERT_EQ(a->capacity, budget);
+
+	// Registering the same cache twice does not change the split
+	broker.addConsumer(a);
+	ASSERT_EQ(broker.getConsumerCount(), 1);
+
+	// The budget is split in proportion to the current capacities
+	broker.addConsumer(b);
+	ASSERT_EQ(broker.getConsumerCount(), 2);
+	ASSERT_LE(a->capacity + b->capacity, budget);
+	ASSERT_GE(a->capacity + b->capacity, budget - 2);
+	int64_t capacityA = a->capacity;
+	int64_t capacityB = b->capacity;
+
+	// A is full and missing, B has spare room, so B donates to A
+	a->usage = a->capacity;
+	a->misses = 1000;
+	a->hits = 1000;
+	b->usage = 0;
+	b->hits = 5000;
+	broker.rebalance();
+	int64_t step = std::min<int64_t>(budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_STEP_FRACTION,
+	                                 capacityB - budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_MIN_SHARE / 2);
+	ASSERT_EQ(a->capacity, capacityA + step);
+	ASSERT_EQ(b->capacity, capacityB - step);
+
+	// Without new misses nothing moves
+	broker.rebalance();
+	ASSERT_EQ(a->capacity, capacityA + step);
+
+	// B never shrinks below its minimum share
+	for (int i = 0; i < 100; ++i) {
+		a->usage = a->capacity;
+		a->misses += 1000;
+		broker.rebalance();
+	}
+	ASSERT_GE(b->capacity, (int64_t)(budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_MIN_SHARE / 2));
+
+	// When the last reference to A goes away, B gets the whole budget
+	broker.removeConsumer(a);
+	ASSERT_EQ(broker.getConsumerCount(), 2);
+	broker.removeConsumer(a);
+	ASSERT_EQ(broker.getConsumerCount(), 1);
+	ASSERT_EQ(b->capacity, budget);
+
+	// Consumers far below their minimum share never push the total over the budget
+	std::vector<Reference<TestCacheBudgetConsumer>> small;
+	for (int i = 0; i < 10; ++i) {
+		small.push_back(makeReference<TestCacheBudgetConsumer>("S", 1));
+		broker.addConsumer(small.back());
+	}
+	int64_t total = b->capacity;
+	for (auto& c : small) {
+		ASSERT_GE(c->capacity, (int64_t)(budget * SERVER_KNOBS->CACHE_BUDGET_BROKER_MIN_SHARE / 11));
+		total += c->capacity;
+	}
+	ASSERT_LE(total, budget);
+
+	return Void();
+}
@@ -893,6 +893,12 @@ ACTOR Future<Standalone<CommitTransactionRef>> provisionalMaster(Reference<Clust
 		}
 		when(CommitTransactionRequest req = waitNext(parent->provisionalCommitProxies[0].commit.getFuture())) {
 			req.reply.send(Never()); // don't reply (clients always get commit_unknown_result)
+			try {
+				req.decompressMutations();
+			} catch (Error& e) {
+				TraceEvent(SevWarnAlways, "ProvisionalCommitMutationsDecodeFailed").error(e);
+				continue;
+			}
 			auto t = &req.transaction;
 			if (t->read_snapshot == parent->lastEpochEnd && //< So no transactions can fall between the read snapshot
 			                                                // and the recovery transaction this (might) be merged with
@@ -398,6 +398,17 @@ ACTOR Future<Void> commitBatcher(ProxyCommitData* commitData,
 			choose {
 				when(CommitTransactionRequest req = waitNext(in)) {
 					// WARNING: this code is run at a high priority, so it needs to do as little work as possible
+					try {
+						req.decompressMutations();
+					} catch (Error& e) {
+						++commitData->stats.txnCommitErrors;
+						req.reply.sendError(e);
+						TraceEvent(SevWarnAlways, "CommitMutationsDecodeFailed")
+						    .suppressFor(60)
+						    .error(e)
+						    .detail("Client", req.reply.getEndpoint().getPrimaryAddress());
+						continue;
+					}
 					int bytes = getBytes(req);
 
 					// Drop requests if memory is under severe pressure
@@ -1445,6 +1456,59 @@ TEST_CASE("/CommitProxy/SplitRange/replaceRawClearRanges") {
 	return Void();
 }
 
+TEST_CASE("/CommitProxy/ShardMapChangeLog") {
+	ShardMapChangeLog changeLog(100);
+	Future<Void> onChange = changeLog.onChange.onTrigger();
+	changeLog.add(101, KeyRangeRef("a"_sr, "c"_sr));
+	changeLog.add(102, KeyRangeRef("x"_sr, "z"_sr));
+
+	// Watchers are woken once for both changes
+	ASSERT(!onChange.isReady());
+	changeLog.notify();
+	ASSERT(onChange.isReady());
+	onChange = changeLog.onChange.onTrigger();
+	changeLog.notify();
+	ASSERT(!onChange.isReady());
+
+	Arena arena;
+	VectorRef<KeyRangeRef> ranges;
+	ranges.push_back(arena, KeyRangeRef("b"_sr, "y"_sr));
+
+	VectorRef<KeyRangeRef> changed;
+	changeLog.getChanges(100, 102, ranges, arena, changed);
+	ASSERT_EQ(changed.size(), 2);
+	ASSERT(changed[0] == KeyRangeRef("b"_sr, "c"_sr));
+	ASSERT(changed[1] == KeyRangeRef("x"_sr, "y"_sr));
+
+	// Only changes in (begin, end] are reported
+	changed = VectorRef<KeyRangeRef>();
+	changeLog.getChanges(101, 102, ranges, arena, changed);
+	ASSERT_EQ(changed.size(), 1);
+	ASSERT(changed[0] == KeyRangeRef("x"_sr, "y"_sr));
+	changed = VectorRef<KeyRangeRef>();
+	changeLog.getChanges(100, 101, ranges, arena, changed);
+	ASSERT_EQ(changed.size(), 1);
+	ASSERT(changed[0] == KeyRangeRef("b"_sr, "c"_sr));
+
+	// Changes outside of the ranges are not reported
+	changeLog.add(103, KeyRangeRef("m"_sr, "n"_sr));
+	changed = VectorRef<KeyRangeRef>();
+	ranges = VectorRef<KeyRangeRef>();
+	ranges.push_back(arena, KeyRangeRef("o"_sr, "p"_sr));
+	changeLog.getChanges(100, 103, ranges, arena, changed);
+	ASSERT(changed.empty());
+	ASSERT_EQ(changeLog.latestVersion(), 103);
+
+	// Trimming the log forgets the oldest versions
+	for (Version v = 104; v < 104 + SERVER_KNOBS->SHARD_MAP_CHANGE_LOG_SIZE; ++v) {
+		changeLog.add(v, KeyRangeRef("m"_sr, "n"_sr));
+	}
+	ASSERT_EQ((int)changeLog.changes.size(), SERVER_KNOBS->SHARD_MAP_CHANGE_LOG_SIZE);
+	ASSERT_EQ(changeLog.oldestVersion, 103);
+
+	return Void();
+}
+
 // Return success and properly split clear range mutations if all tenant check pass. Otherwise, return corresponding
 // error
 Error validateAndProcessTenantAccess(Arena& arena,
@@ -2268,6 +2332,9 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 	// First pass
 	wait(applyMetadataToCommittedTransactions(self));
 
+	// Wake the shard map watchers once for all of the location changes in this batch
+	pProxyCommitData->shardMapChanges.notify();
+
 	if (debugID.present()) {
 		g_traceBatch.addEvent(
 		    "CommitDebug", debugID.get().first(), "CommitProxyServer.commitBatch.ApplyMetadataToCommittedTxn");
@@ -2958,6 +3025,83 @@ ACTOR static Future<Void> readRequestServer(CommitProxyInterface proxy,
 	}
 }
 
+// Replies once any of the requested ranges changed location after the requested version, with their new locations
+ACTOR static Future<Void> doWatchShardMapRequest(WatchShardMapRequest req, ProxyCommitData* commitData) {
+	state ShardMapChangeLog* log = &commitData->shardMapChanges;
+	state Future<Void> timeout = delay(SERVER_KNOBS->SHARD_MAP_WATCH_TIMEOUT);
+	state WatchShardMapReply rep;
+
+	wait(commitData->validState.getFuture());
+	wait(delay(0, TaskPriority::DefaultEndpoint));
+
+	loop {
+		rep.version = commitData->version.get();
+		if (req.version == latestVersion) {
+			break;
+		}
+		if (req.version < log->oldestVersion) {
+			CODE_PROBE(true, "Shard map watch older than change log");
+			rep.reset = true;
+			break;
+		}
+		log->getChanges(req.version, rep.version, req.ranges, rep.arena, rep.changed);
+		if (!rep.changed.empty()) {
+			break;
+		}
+
+		// Changes are logged when they are applied, before version reaches their commit version
+		Version latestChange = log->latestVersion();
+		choose {
+			when(wait(latestChange > rep.version ? commitData->version.whenAtLeast(latestChange)
+			                                     : log->onChange.onTrigger())) {}
+			when(wait(timeout)) {
+				break;
+			}
+		}
+	}
+
+	std::unordered_set<UID> tssMappingsIncluded;
+	int count = 0;
+	for (const auto& range : rep.changed) {
+		for (auto r : commitData->keyInfo.intersectingRanges(range)) {
+			if (count >= SERVER_KNOBS->SHARD_MAP_WATCH_MAX_RESULTS) {
+				break;
+			}
+			std::vector<StorageServerInterface> ssis;
+			ssis.reserve(r.value().src_info.size());
+			for (auto& it : r.value().src_info) {
+				ssis.push_back(it->interf);
+				maybeAddTssMapping(rep.locations, commitData, tssMappingsIncluded, it->interf.id());
+			}
+			rep.locations.results.emplace_back(KeyRangeRef(rep.locations.arena, r.range()), ssis);
+			count++;
+		}
+	}
+	addTagMapping(rep.locations, commitData);
+	commitData->stats.shardMapLocationsPushed += count;
+
+	req.reply.send(rep);
+	++commitData->stats.shardMapWatchOut;
+	return Void();
+}
+
+ACTOR static Future<Void> shardMapWatchServer(CommitProxyInterface proxy,
+                                              PromiseStream<Future<Void>> addActor,
+                                              ProxyCommitData* commitData) {
+	loop {
+		WatchShardMapRequest req = waitNext(proxy.watchShardMap.getFuture());
+		if (commitData->stats.shardMapWatchIn.getValue() - commitData->stats.shardMapWatchOut.getValue() >
+		    SERVER_KNOBS->SHARD_MAP_WATCH_MAX_QUEUE_SIZE) {
+			++commitData->stats.shardMapWatchErrors;
+			req.reply.sendError(commit_proxy_memory_limit_exceeded());
+			TraceEvent(SevWarnAlways, "ProxyShardMapWatchThresholdExceeded").suppressFor(60);
+		} else {
+			++commitData->stats.shardMapWatchIn;
+			addActor.send(doWatchShardMapRequest(req, commitData));
+		}
+	}
+}
+
 // Right now this just proxies a call to read the system keyspace for tenant+authorization purposes, but this will
 // eventually be extended to have this mapping in the transaction state store
 ACTOR static Future<Void> doBlobGranuleLocationRequest(GetBlobGranuleLocationsRequest req,
@@ -3901,6 +4045,7 @@ ACTOR Future<Void> commitProxyServerCore(CommitProxyInterface proxy,
 	addActor.send(monitorRemoteCommitted(&commitData));
 	addActor.send(tenantIdServer(proxy, addActor, &commitData));
 	addActor.send(readRequestServer(proxy, addActor, &commitData));
+	addActor.send(shardMapWatchServer(proxy, addActor, &commitData));
 	addActor.send(bgReadRequestServer(proxy, addActor, &commitData));
 	addActor.send(rejoinServer(proxy, &commitData));
 	addActor.send(ddMetricsRequestServer(proxy, db));
@@ -24,6 +24,7 @@
 #include "fdbclient/Notified.h"
 #include "fdbclient/SystemData.h"
 #include "fdbserver/ServerDBInfo.actor.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbserver/IDiskQueue.h"
@@ -32,6 +33,7 @@
 #include "fdbserver/RadixTree.h"
 #include "flow/ActorCollection.h"
 #include "flow/EncryptUtils.h"
+#include "flow/IThreadPool.h"
 #include "flow/Knobs.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -307,7 +309,8 @@ private:
 		OpCommit, // only in log, not in queue
 		OpRollback, // only in log, not in queue
 		OpSnapshotItemDelta,
-		OpEncrypted_Deprecated // deprecated since we now store the encryption status in the first bit of the opType
+		OpEncrypted_Deprecated, // deprecated since we now store the encryption status in the first bit of the opType
+		OpSnapshotPartition // only in recovery queue, not in log
 	};
 
 	struct OpRef {
@@ -322,6 +325,59 @@ private:
 		int len1, len2;
 	};
 
+	// A run of consecutive snapshot items read back during recovery.  The items replace everything in range, so the
+	// partition can be materialized into container pairs on a recovery thread independently of its neighbours, and is
+	// then applied on the main thread in log order relative to the other recovered operations.
+	// The partition owns copies of everything it references, since its last reference may be dropped on a recovery
+	// thread.
+	struct SnapshotPartition : ThreadSafeReferenceCounted<SnapshotPartition> {
+		Key begin;
+		KeyRange range; // set when sealed
+		Standalone<VectorRef<KeyValueRef>> items;
+		std::vector<std::pair<KeyValueMapPair, uint64_t>> pairs; // populated by materialize()
+		int64_t bytes = 0;
+
+		explicit SnapshotPartition(KeyRef begin) : begin(begin) {}
+
+		void add(KeyValueRef kv) {
+			items.push_back_deep(items.arena(), kv);
+			bytes += kv.expectedSize();
+		}
+
+		void seal(KeyRef end) { range = KeyRangeRef(begin, end); }
+
+		void materialize(int elementBytes) {
+			pairs.reserve(items.size());
+			for (auto const& kv : items) {
+				KeyValueMapPair pair(kv.key, kv.value);
+				pairs.emplace_back(pair, pair.arena.getSize() + elementBytes);
+			}
+			// The pairs own copies of the items now
+			items = Standalone<VectorRef<KeyValueRef>>();
+		}
+	};
+
+	struct RecoveryWorker final : IThreadPoolReceiver {
+		void init() override {}
+
+		struct MaterializeAction final : TypedAction<RecoveryWorker, MaterializeAction> {
+			Reference<SnapshotPartition> partition;
+			int elementBytes;
+			double timeEstimate;
+			ThreadReturnPromise<Void> result;
+
+			MaterializeAction(Reference<SnapshotPartition> partition, int elementBytes)
+			  : partition(partition), elementBytes(elementBytes),
+			    timeEstimate(SERVER_KNOBS->SET_TIME_ESTIMATE * partition->items.size()) {}
+
+			double getTimeEstimate() const override { return timeEstimate; }
+		};
+		void action(MaterializeAction& a) {
+			a.partition->materialize(a.elementBytes);
+			a.result.send(Void());
+		}
+	};
+
 	struct OpQueue {
 		OpQueue() : numBytes(0) {}
 
@@ -331,6 +387,8 @@ private:
 			numBytes = 0;
 			operations = Standalone<VectorRef<OpRef>>();
 			arenas.clear();
+			partitions.clear();
+			materializing.clear();
 		}
 
 		void rollback() { clear(); }
@@ -347,6 +405,19 @@ private:
 			queue_op(OpClearToEnd, fromKey, StringRef(), arena);
 		}
 
+		// Queues a sealed partition whose pairs are being materialized by 'materialized'
+		void snapshot_partition(Reference<SnapshotPartition> partition, Future<Void> materialized) {
+			// The range is copied into the queue's own arena since the partition may be destroyed on another thread
+			queue_op(OpSnapshotPartition, partition->range.begin, partition->range.end, nullptr);
+			numBytes += partition->bytes;
+			partitions.push_back(partition);
+			materializing.push_back(materialized);
+		}
+
+		Reference<SnapshotPartition> const& partition(int index) const { return partitions[index]; }
+
+		Future<Void> partitionsMaterialized() const { return waitForAll(materializing); }
+
 		void queue_op(OpType op, StringRef p1, StringRef p2, const Arena* arena) {
 			numBytes += p1.size() + p2.size() + sizeof(OpHeader) + sizeof(OpRef);
 
@@ -370,6 +441,8 @@ private:
 		Standalone<VectorRef<OpRef>> operations;
 		uint64_t numBytes;
 		std::vector<Arena> arenas;
+		std::vector<Reference<SnapshotPartition>> partitions;
+		std::vector<Future<Void>> materializing;
 	};
 	KeyValueStoreType type;
 	UID id;
@@ -407,6 +480,8 @@ private:
 	int64_t memoryLimit; // The upper limit on the memory used by the store (excluding, possibly, some clear operations)
 	std::vector<std::pair<KeyValueMapPair, uint64_t>> dataSets;
 
+	int64_t recoveredPartitions; // snapshot partitions materialized by recovery threads
+
 	bool enableEncryption;
 	TextAndHeaderCipherKeys cipherKeys;
 	Future<Void> refreshCipherKeysActor;
@@ -414,6 +489,7 @@ private:
 	int64_t commit_queue(OpQueue& ops, bool log, bool sequential = false) {
 		int64_t total = 0, count = 0;
 		IDiskQueue::location log_location = 0;
+		int nextPartition = 0;
 
 		for (auto o = ops.begin(); o != ops.end(); ++o) {
 			++count;
@@ -437,6 +513,21 @@ private:
 					dataSets.clear();
 				}
 				data.erase(data.lower_bound(o->p1), data.end());
+			} else if (o->op == OpSnapshotPartition) {
+				// Only recovery queues partitions, after waiting for all of them to be materialized
+				ASSERT(!log);
+				auto const& partition = ops.partition(nextPartition++);
+				if (sequential) {
+					data.insert(dataSets);
+					dataSets.clear();
+				}
+				data.erase(data.lower_bound(o->p1), data.lower_bound(o->p2));
+				data.insert(partition->pairs);
+				total += partition->bytes;
+				count += partition->pairs.size();
+				// The container now shares the pairs' arenas, so release them here rather than wherever the last
+				// reference to the partition happens to be dropped.
+				std::vector<std::pair<KeyValueMapPair, uint64_t>>().swap(partition->pairs);
 			} else
 				ASSERT(false);
 			if (log)
@@ -594,7 +685,35 @@ private:
 		return Standalone<StringRef>(plaintext, arena);
 	}
 
+	// Queues the in-progress recovery partition, if any, and starts materializing it on a recovery thread
+	void sealSnapshotPartition(OpQueue& recoveryQueue,
+	                           Reference<SnapshotPartition>& partition,
+	                           KeyRef end,
+	                           Reference<IThreadPool> const& recoveryThreads) {
+		if (!partition.isValid())
+			return;
+		partition->seal(end);
+		auto action = new typename RecoveryWorker::MaterializeAction(partition, data.getElementBytes());
+		Future<Void> materialized = action->result.getFuture();
+		recoveryThreads->post(action);
+		recoveryQueue.snapshot_partition(partition, materialized);
+		partition.clear();
+		++recoveredPartitions;
+	}
+
 	ACTOR static Future<Void> recover(KeyValueStoreMemory* self, bool exactRecovery) {
+		// Snapshot items are grouped into key range partitions which are materialized in parallel while the log is
+		// still being read.  In simulation the recovery threads run as coroutines on the network thread.
+		// radix_tree does not support batch insertion, so it always replays snapshot items one at a time.
+		state Reference<IThreadPool> recoveryThreads;
+		if (SERVER_KNOBS->KVS_MEMORY_RECOVERY_THREADS > 0 && std::is_same_v<Container, IKeyValueContainer>) {
+			recoveryThreads =
+			    g_network->isSimulated() ? CoroThreadPool::createThreadPool() : createGenericThreadPool();
+			for (int i = 0; i < SERVER_KNOBS->KVS_MEMORY_RECOVERY_THREADS; i++) {
+				recoveryThreads->addThread(new RecoveryWorker(), "fdb-kvsmem-rec");
+			}
+		}
+
 		loop {
 			// 'uncommitted' variables track something that might be rolled back by an OpRollback, and are copied into
 			// permanent variables (in self) in OpCommit.  OpRollback does the reverse (copying the permanent versions
@@ -604,6 +723,7 @@ private:
 			state IDiskQueue::location uncommittedPrevSnapshotEnd = self->previousSnapshotEnd =
 			    self->log->getNextReadLocation(); // not really, but popping up to here does nothing
 			state IDiskQueue::location uncommittedSnapshotEnd = self->currentSnapshotEnd = uncommittedPrevSnapshotEnd;
+			state int64_t recoveryStartLocation = uncommittedPrevSnapshotEnd.lo;
 
 			state int zeroFillSize = 0;
 			state int dbgSnapshotItemCount = 0;
@@ -616,6 +736,7 @@ private:
 			state Future<Void> loggingDelay = delay(1.0);
 
 			state OpQueue recoveryQueue;
+			state Reference<SnapshotPartition> partition; // the partition collecting snapshot items, if any
 			state OpHeader h;
 			state Standalone<StringRef> lastSnapshotKey;
 			state bool isZeroFilled;
@@ -668,6 +789,14 @@ private:
 						break;
 					}
 
+					// Any other operation must be applied after the snapshot items logged before it
+					if (!isZeroFilled && h.op != OpSnapshotItem && h.op != OpSnapshotItemDelta) {
+						self->sealSnapshotPartition(recoveryQueue, partition, uncommittedNextKey, recoveryThreads);
+						if (h.op == OpCommit) {
+							wait(recoveryQueue.partitionsMaterialized());
+						}
+					}
+
 					if (!isZeroFilled) {
 						StringRef p1 = data.substr(0, h.len1);
 						StringRef p2 = data.substr(h.len1, h.len2);
@@ -695,15 +824,31 @@ private:
 								// Copy the suffix into the new reconstituted key
 								memcpy(mutateString(p1) + borrowed, suffix.begin(), suffix.size());
 							}
-							if (p1 >= uncommittedNextKey)
-								recoveryQueue.clear(
-								    KeyRangeRef(uncommittedNextKey, p1),
-								    &uncommittedNextKey
-								         .arena()); // FIXME: Not sure what this line is for, is it necessary?
-							recoveryQueue.set(KeyValueRef(p1, p2), &data.arena());
+							if (recoveryThreads.isValid() && p1 >= uncommittedNextKey) {
+								// Equivalent to the clear of [uncommittedNextKey, p1) and set below, since the
+								// partition replaces everything in its range.
+								if (!partition.isValid()) {
+									partition = makeReference<SnapshotPartition>(uncommittedNextKey);
+								}
+								partition->add(KeyValueRef(p1, p2));
+							} else {
+								self->sealSnapshotPartition(
+								    recoveryQueue, partition, uncommittedNextKey, recoveryThreads);
+								if (p1 >= uncommittedNextKey)
+									recoveryQueue.clear(
+									    KeyRangeRef(uncommittedNextKey, p1),
+									    &uncommittedNextKey
+									         .arena()); // FIXME: Not sure what this line is for, is it necessary?
+								recoveryQueue.set(KeyValueRef(p1, p2), &data.arena());
+							}
 							uncommittedNextKey = keyAfter(p1);
 							++dbgSnapshotItemCount;
 							lastSnapshotKey = Key(p1, data.arena());
+							if (partition.isValid() &&
+							    partition->bytes >= SERVER_KNOBS->KVS_MEMORY_RECOVERY_PARTITION_BYTES) {
+								self->sealSnapshotPartition(
+								    recoveryQueue, partition, uncommittedNextKey, recoveryThreads);
+							}
 						} else if (h.op == OpSnapshotEnd || h.op == OpSnapshotAbort) { // snapshot complete
 							TraceEvent("RecSnapshotEnd", self->id)
 							    .detail("NextKey", uncommittedNextKey)
@@ -750,11 +895,20 @@ private:
 					}
 
 					if (loggingDelay.isReady()) {
+						// The queue files also contain popped pages and page overhead, so the progress estimate is a
+						// lower bound.
+						int64_t bytesRecovered = self->log->getNextReadLocation().lo - recoveryStartLocation;
+						int64_t queueBytes = self->log->getStorageBytes().used;
 						TraceEvent("KVSMemRecoveryLogSnap", self->id)
 						    .detail("SnapshotItems", dbgSnapshotItemCount)
 						    .detail("SnapshotEnd", dbgSnapshotEndCount)
 						    .detail("Mutations", dbgMutationCount)
 						    .detail("Commits", dbgCommitCount)
+						    .detail("Partitions", self->recoveredPartitions)
+						    .detail("BytesRecovered", bytesRecovered)
+						    .detail("BytesPerSecond", bytesRecovered / std::max(now() - startt, 1e-6))
+						    .detail("EstimatedProgress",
+						            queueBytes > 0 ? std::min(1.0, (double)bytesRecovered / queueBytes) : 0.0)
 						    .detail("EndsAt", self->log->getNextReadLocation());
 						loggingDelay = delay(1.0);
 					}
@@ -785,8 +939,14 @@ private:
 				    .detail("SnapshotEnd", dbgSnapshotEndCount)
 				    .detail("Mutations", dbgMutationCount)
 				    .detail("Commits", dbgCommitCount)
+				    .detail("Partitions", self->recoveredPartitions)
+				    .detail("BytesRecovered", self->log->getNextReadLocation().lo - recoveryStartLocation)
 				    .detail("TimeTaken", now() - startt);
 
+				if (recoveryThreads.isValid()) {
+					wait(recoveryThreads->stop());
+				}
+
 				// Make sure cipher keys are ready before recovery finishes. The semiCommit below also require cipher
 				// keys.
 				if (self->enableEncryption) {
@@ -808,6 +968,7 @@ private:
 				}
 				self->data.clear();
 				self->dataSets.clear();
+				self->recoveredPartitions = 0;
 			}
 		}
 	}
@@ -1055,7 +1216,7 @@ KeyValueStoreMemory<Container>::KeyValueStoreMemory(IDiskQueue* log,
   : type(storeType), id(id), log(log), db(db), committedWriteBytes(0), overheadWriteBytes(0), currentSnapshotEnd(-1),
     previousSnapshotEnd(-1), committedDataSize(0), transactionSize(0), transactionIsLarge(false), resetSnapshot(false),
     disableSnapshot(disableSnapshot), replaceContent(replaceContent), firstCommitWithSnapshot(true), snapshotCount(0),
-    memoryLimit(memoryLimit), enableEncryption(enableEncryption) {
+    memoryLimit(memoryLimit), recoveredPartitions(0), enableEncryption(enableEncryption) {
 	// create reserved buffer for radixtree store type
 	this->reserved_buffer =
 	    (storeType == KeyValueStoreType::MEMORY) ? nullptr : new uint8_t[CLIENT_KNOBS->SYSTEM_KEY_SIZE_LIMIT];
@@ -48,6 +48,7 @@
 #endif
 #endif
 #include "fdbclient/SystemData.h"
+#include "fdbserver/CacheBudgetBroker.h"
 #include "fdbserver/CoroFlow.h"
 #include "fdbserver/FDBRocksDBVersion.h"
 #include "fdbserver/RocksDBLogForwarder.h"
@@ -105,6 +106,7 @@ public:
 	rocksdb::ColumnFamilyOptions getCfOptions() const { return this->cfOptions; }
 	rocksdb::Options getOptions() const { return rocksdb::Options(this->dbOptions, this->cfOptions); }
 	rocksdb::ReadOptions getReadOptions() { return this->readOptions; }
+	std::shared_ptr<rocksdb::Cache> getBlockCache() const { return this->blockCache; }
 
 private:
 	const UID id;
@@ -113,6 +115,8 @@ private:
 	rocksdb::ReadOptions initialReadOptions();
 
 	bool closing;
+	// Set by initialCfOptions(), so it must be declared before cfOptions
+	std::shared_ptr<rocksdb::Cache> blockCache;
 	rocksdb::DBOptions dbOptions;
 	rocksdb::ColumnFamilyOptions cfOptions;
 	rocksdb::ReadOptions readOptions;
@@ -122,6 +126,28 @@ SharedRocksDBState::SharedRocksDBState(UID id)
   : id(id), closing(false), dbOptions(initialDbOptions()), cfOptions(initialCfOptions()),
     readOptions(initialReadOptions()) {}
 
+// Lets the CacheBudgetBroker resize the block cache of one RocksDB instance
+class RocksDBBlockCacheConsumer : public ICacheBudgetConsumer {
+public:
+	RocksDBBlockCacheConsumer(UID id,
+	                          std::shared_ptr<rocksdb::Cache> cache,
+	                          std::shared_ptr<rocksdb::Statistics> statistics)
+	  : id(id), cache(cache), statistics(statistics) {}
+
+	const void* getCacheID() const override { return cache.get(); }
+	std::string getName() const override { return "RocksDB/" + id.toString(); }
+	int64_t getCapacity() const override { return cache->GetCapacity(); }
+	void setCapacity(int64_t bytes) override { cache->SetCapacity(bytes); }
+	int64_t getUsage() const override { return cache->GetUsage(); }
+	int64_t getHits() const override { return statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT); }
+	int64_t getMisses() const override { return statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS); }
+
+private:
+	UID id;
+	std::shared_ptr<rocksdb::Cache> cache;
+	std::shared_ptr<rocksdb::Statistics> statistics;
+};
+
 rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 	rocksdb::ColumnFamilyOptions options;
 	options.level_compaction_dynamic_level_bytes = SERVER_KNOBS->ROCKSDB_LEVEL_COMPACTION_DYNAMIC_LEVEL_BYTES;
@@ -204,11 +230,11 @@ rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 	}
 
 	if (SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		bbOpts.block_cache =
-		    rocksdb::NewLRUCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
-		                         -1, /* num_shard_bits, default value:-1*/
-		                         false, /* strict_capacity_limit, default value:false */
-		                         SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO /* high_pri_pool_ratio */);
+		blockCache = rocksdb::NewLRUCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
+		                                  -1, /* num_shard_bits, default value:-1*/
+		                                  false, /* strict_capacity_limit, default value:false */
+		                                  SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO /* high_pri_pool_ratio */);
+		bbOpts.block_cache = blockCache;
 		bbOpts.cache_index_and_filter_blocks = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.pin_l0_filter_and_index_blocks_in_cache = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.cache_index_and_filter_blocks_with_high_priority = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
@@ -1084,6 +1110,9 @@ ACTOR Future<Void> rocksDBMetricLogger(UID id,
 		if (sharedState->isClosing()) {
 			break;
 		}
+		if (CacheBudgetBroker::enabled()) {
+			CacheBudgetBroker::getBroker().maybeRebalance();
+		}
 		TraceEvent e("RocksDBMetrics", id);
 		e.trackLatest(rocksdbMetricsTrackingKey);
 
@@ -1906,6 +1935,11 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			               SERVER_KNOBS->ROCKSDB_HISTOGRAMS_SAMPLE_RATE > 0 ? metricPromiseStreams[i].get() : nullptr),
 			    "fdb-rocksdb-re");
 		}
+		if (CacheBudgetBroker::enabled() && sharedState->getBlockCache()) {
+			cacheBudgetConsumer = makeReference<RocksDBBlockCacheConsumer>(
+			    id, sharedState->getBlockCache(), sharedState->getDbOptions().statistics);
+			CacheBudgetBroker::getBroker().addConsumer(cacheBudgetConsumer);
+		}
 	}
 
 	ACTOR Future<Void> errorListenActor(Future<Void> collection) {
@@ -2012,6 +2046,10 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 
 	ACTOR static void doClose(RocksDBKeyValueStore* self, bool deleteOnClose) {
 		self->sharedState->setClosing();
+		if (self->cacheBudgetConsumer.isValid()) {
+			CacheBudgetBroker::getBroker().removeConsumer(self->cacheBudgetConsumer);
+			self->cacheBudgetConsumer.clear();
+		}
 
 		// The metrics future retains a reference to the DB, so stop it before we delete it.
 		self->metrics.reset();
@@ -2393,6 +2431,7 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 	Future<Void> collection;
 	PromiseStream<Future<Void>> addActor;
 	Counters counters;
+	Reference<ICacheBudgetConsumer> cacheBudgetConsumer;
 };
 
 void RocksDBKeyValueStore::Writer::action(CheckpointAction& a) {
@@ -28,6 +28,7 @@
 #endif
 #endif
 #include "fdbclient/SystemData.h"
+#include "fdbserver/CacheBudgetBroker.h"
 #include "fdbserver/CoroFlow.h"
 #include "fdbserver/FDBRocksDBVersion.h"
 #include "flow/flow.h"
@@ -289,6 +290,34 @@ struct ShardedRocksDBState {
 
 std::shared_ptr<rocksdb::Cache> rocksdb_block_cache = nullptr;
 
+std::shared_ptr<rocksdb::Cache> getBlockCache() {
+	if (rocksdb_block_cache == nullptr && SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE > 0) {
+		rocksdb_block_cache = rocksdb::NewLRUCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE);
+	}
+	return rocksdb_block_cache;
+}
+
+// Lets the CacheBudgetBroker resize the block cache shared by all ShardedRocksDB instances in the process
+class ShardedRocksDBBlockCacheConsumer : public ICacheBudgetConsumer {
+public:
+	ShardedRocksDBBlockCacheConsumer(std::shared_ptr<rocksdb::Cache> cache,
+	                                 std::shared_ptr<rocksdb::Statistics> statistics)
+	  : cache(cache), statistics(statistics) {}
+
+	const void* getCacheID() const override { return cache.get(); }
+	std::string getName() const override { return "ShardedRocksDB"; }
+	int64_t getCapacity() const override { return cache->GetCapacity(); }
+	void setCapacity(int64_t bytes) override { cache->SetCapacity(bytes); }
+	int64_t getUsage() const override { return cache->GetUsage(); }
+	// Only the statistics of the instance which registered the cache first are counted
+	int64_t getHits() const override { return statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT); }
+	int64_t getMisses() const override { return statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS); }
+
+private:
+	std::shared_ptr<rocksdb::Cache> cache;
+	std::shared_ptr<rocksdb::Statistics> statistics;
+};
+
 rocksdb::ExportImportFilesMetaData getMetaData(const CheckpointMetaData& checkpoint) {
 	rocksdb::ExportImportFilesMetaData metaData;
 	if (checkpoint.getFormat() != DataMoveRocksCF) {
@@ -564,10 +593,7 @@ rocksdb::ColumnFamilyOptions getCFOptions() {
 	options.level0_slowdown_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_SLOWDOWN_WRITES_TRIGGER;
 	options.level0_stop_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_STOP_WRITES_TRIGGER;
 
-	if (rocksdb_block_cache == nullptr && SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		rocksdb_block_cache = rocksdb::NewLRUCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE);
-	}
-	bbOpts.block_cache = rocksdb_block_cache;
+	bbOpts.block_cache = getBlockCache();
 
 	options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(bbOpts));
 
@@ -600,6 +626,80 @@ rocksdb::ColumnFamilyOptions getCFOptionsForInactiveShard() {
 	return options;
 }
 
+// Option profiles applied to active physical shards according to the load observed on them. Profiles only use mutable
+// column family options so that a shard can be switched with SetOptions while the store is open.
+enum class ShardOptionProfile { DEFAULT = 0, WRITE_HEAVY, READ_HOT, COLD, END };
+
+std::string shardOptionProfileName(ShardOptionProfile profile) {
+	switch (profile) {
+	case ShardOptionProfile::DEFAULT:
+		return "Default";
+	case ShardOptionProfile::WRITE_HEAVY:
+		return "WriteHeavy";
+	case ShardOptionProfile::READ_HOT:
+		return "ReadHot";
+	case ShardOptionProfile::COLD:
+		return "Cold";
+	default:
+		UNREACHABLE();
+	}
+}
+
+std::unordered_map<std::string, std::string> getShardProfileOptions(ShardOptionProfile profile) {
+	int64_t l0CompactionTrigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_FILENUM_COMPACTION_TRIGGER;
+	int64_t l0SlowdownTrigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_SLOWDOWN_WRITES_TRIGGER;
+	int64_t l0StopTrigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_STOP_WRITES_TRIGGER;
+	int64_t writeBufferSize = SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_BUFFER_SIZE;
+	int64_t targetFileSizeBase = SERVER_KNOBS->SHARDED_ROCKSDB_TARGET_FILE_SIZE_BASE;
+	// Matches getCFOptions(), which only enables the memtable bloom filter together with the prefix extractor.
+	double memtableBloomRatio = SERVER_KNOBS->SHARDED_ROCKSDB_PREFIX_LEN > 0 ? 0.1 : 0.0;
+	bool memtableWholeKeyFiltering = false;
+	// 4KB is the RocksDB default used by getCFOptions().
+	int blockSize = 4096;
+
+	switch (profile) {
+	case ShardOptionProfile::WRITE_HEAVY:
+		// Let more L0 files accumulate before merging them, which trades read amplification for lower write
+		// amplification the way tiered compaction does. Universal compaction itself cannot be enabled on an open
+		// column family.
+		l0CompactionTrigger *= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_L0_TRIGGER_MULTIPLIER;
+		l0SlowdownTrigger *= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_L0_TRIGGER_MULTIPLIER;
+		l0StopTrigger *= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_L0_TRIGGER_MULTIPLIER;
+		writeBufferSize *= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_WRITE_BUFFER_MULTIPLIER;
+		targetFileSizeBase *= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_WRITE_BUFFER_MULTIPLIER;
+		break;
+	case ShardOptionProfile::READ_HOT:
+		// Keep L0 shallow so that lookups probe fewer files, and filter point lookups in the memtable.
+		l0CompactionTrigger = std::max<int64_t>(1, l0CompactionTrigger / 2);
+		memtableBloomRatio = 0.1;
+		memtableWholeKeyFiltering = true;
+		if (SERVER_KNOBS->SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE > 0) {
+			blockSize = SERVER_KNOBS->SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE;
+		}
+		break;
+	case ShardOptionProfile::COLD:
+		// Idle shards do not need a full sized memtable.
+		writeBufferSize = std::max<int64_t>(writeBufferSize / 4, 1 << 20);
+		break;
+	default:
+		break;
+	}
+
+	std::unordered_map<std::string, std::string> options = {
+		{ "level0_file_num_compaction_trigger", std::to_string(l0CompactionTrigger) },
+		{ "level0_slowdown_writes_trigger", std::to_string(l0SlowdownTrigger) },
+		{ "level0_stop_writes_trigger", std::to_string(l0StopTrigger) },
+		{ "write_buffer_size", std::to_string(writeBufferSize) },
+		{ "target_file_size_base", std::to_string(targetFileSizeBase) },
+		{ "memtable_prefix_bloom_size_ratio", std::to_string(memtableBloomRatio) },
+		{ "memtable_whole_key_filtering", memtableWholeKeyFiltering ? "true" : "false" }
+	};
+	if (SERVER_KNOBS->SHARDED_ROCKSDB_READ_HOT_BLOCK_SIZE > 0) {
+		options["block_based_table_factory"] = "{block_size=" + std::to_string(blockSize) + ";}";
+	}
+	return options;
+}
+
 rocksdb::DBOptions getOptions() {
 	rocksdb::DBOptions options;
 	options.avoid_unnecessary_blocking_io = true;
@@ -965,6 +1065,15 @@ struct PhysicalShard {
 	uint64_t numRangeDeletions = 0;
 	double deleteTimeSec = 0.0;
 	double lastCompactionTime = 0.0;
+
+	// Load observed since the option profile was last evaluated. Reads are counted on the reader threads.
+	int64_t numWrites = 0;
+	int64_t bytesWritten = 0;
+	std::atomic<int64_t> numReads{ 0 };
+	ShardOptionProfile profile = ShardOptionProfile::DEFAULT;
+	// Shards added as inactive keep the bulk loading options from getCFOptionsForInactiveShard() until they are
+	// marked active.
+	bool bulkLoading = false;
 };
 
 int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, int byteLimit, RangeResult* result) {
@@ -974,6 +1083,7 @@ int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, i
 
 	int accumulatedBytes = 0;
 	rocksdb::Status s;
+	shard->numReads.fetch_add(1, std::memory_order_relaxed);
 
 	// When using a prefix extractor, ensure that keys are returned in order even if they cross
 	// a prefix boundary.
@@ -1403,6 +1513,9 @@ public:
 		auto cfOptions = active ? getCFOptions() : getCFOptionsForInactiveShard();
 		auto [it, inserted] = physicalShards.emplace(id, std::make_shared<PhysicalShard>(db, id, cfOptions));
 		std::shared_ptr<PhysicalShard>& shard = it->second;
+		if (inserted) {
+			shard->bulkLoading = !active;
+		}
 
 		activePhysicalShardIds.emplace(id);
 
@@ -1536,10 +1649,85 @@ public:
 				{ "num_levels", "-1" }
 			};
 			db->SetOptions(it.value()->physicalShard->cf, options);
+			it.value()->physicalShard->bulkLoading = false;
+			it.value()->physicalShard->profile = ShardOptionProfile::DEFAULT;
 			TraceEvent("ShardedRocksDBRangeActive", logId).detail("ShardId", it.value()->physicalShard->id);
 		}
 	}
 
+	// Picks the option profile of every active physical shard from the load observed over the last 'elapsed' seconds,
+	// applies the options of shards whose profile changed, and logs load and write amplification per profile.
+	void updateShardProfiles(double elapsed) {
+		struct ProfileStats {
+			int numShards = 0;
+			double writeBytesPerSec = 0;
+			double readsPerSec = 0;
+			double writeAmpSum = 0;
+			int writeAmpSamples = 0;
+		};
+		std::vector<ProfileStats> stats(static_cast<int>(ShardOptionProfile::END));
+		int numChanged = 0;
+
+		for (auto& [id, shard] : physicalShards) {
+			if (!shard->initialized() || shard->deletePending || shard->bulkLoading) {
+				continue;
+			}
+			const double writeBytesPerSec = shard->bytesWritten / elapsed;
+			const double writesPerSec = shard->numWrites / elapsed;
+			const double readsPerSec = shard->numReads.exchange(0) / elapsed;
+			shard->bytesWritten = 0;
+			shard->numWrites = 0;
+
+			ShardOptionProfile profile = ShardOptionProfile::DEFAULT;
+			if (writeBytesPerSec >= SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_BYTES_PER_SEC) {
+				profile = ShardOptionProfile::WRITE_HEAVY;
+			} else if (readsPerSec >= SERVER_KNOBS->SHARDED_ROCKSDB_READ_HOT_OPS_PER_SEC) {
+				profile = ShardOptionProfile::READ_HOT;
+			} else if (readsPerSec + writesPerSec < SERVER_KNOBS->SHARDED_ROCKSDB_COLD_OPS_PER_SEC) {
+				profile = ShardOptionProfile::COLD;
+			}
+
+			if (profile != shard->profile) {
+				auto s = db->SetOptions(shard->cf, getShardProfileOptions(profile));
+				TraceEvent(s.ok() ? SevInfo : SevWarn, "ShardedRocksDBShardProfileChanged", logId)
+				    .detail("ShardId", id)
+				    .detail("From", shardOptionProfileName(shard->profile))
+				    .detail("To", shardOptionProfileName(profile))
+				    .detail("WriteBytesPerSec", writeBytesPerSec)
+				    .detail("ReadsPerSec", readsPerSec)
+				    .detail("Status", s.ToString());
+				if (s.ok()) {
+					shard->profile = profile;
+					++numChanged;
+				}
+			}
+
+			ProfileStats& profileStats = stats[static_cast<int>(shard->profile)];
+			++profileStats.numShards;
+			profileStats.writeBytesPerSec += writeBytesPerSec;
+			profileStats.readsPerSec += readsPerSec;
+			std::map<std::string, std::string> cfStats;
+			if (db->GetMapProperty(shard->cf, rocksdb::DB::Properties::kCFStats, &cfStats)) {
+				auto writeAmp = cfStats.find("compaction.Sum.WriteAmp");
+				if (writeAmp != cfStats.end()) {
+					profileStats.writeAmpSum += std::atof(writeAmp->second.c_str());
+					++profileStats.writeAmpSamples;
+				}
+			}
+		}
+
+		TraceEvent e(SevInfo, "ShardedRocksDBShardProfiles", logId);
+		e.detail("Changed", numChanged);
+		for (int i = 0; i < stats.size(); ++i) {
+			const std::string name = shardOptionProfileName(static_cast<ShardOptionProfile>(i));
+			e.detail(name + "Shards", stats[i].numShards)
+			    .detail(name + "WriteBytesPerSec", stats[i].writeBytesPerSec)
+			    .detail(name + "ReadsPerSec", stats[i].readsPerSec)
+			    .detail(name + "WriteAmp",
+			            stats[i].writeAmpSamples > 0 ? stats[i].writeAmpSum / stats[i].writeAmpSamples : 0.0);
+		}
+	}
+
 	std::vector<std::shared_ptr<PhysicalShard>> getPendingDeletionShards(double cleanUpDelay) {
 		std::vector<std::shared_ptr<PhysicalShard>> emptyShards;
 		double currentTime = now();
@@ -1580,6 +1768,8 @@ public:
 		ASSERT(dirtyShards != nullptr);
 		writeBatch->Put(it.value()->physicalShard->cf, toSlice(key), toSlice(value));
 		dirtyShards->insert(it.value()->physicalShard);
+		++it.value()->physicalShard->numWrites;
+		it.value()->physicalShard->bytesWritten += key.size() + value.size();
 		TraceEvent(SevVerbose, "ShardedRocksShardManagerPutEnd", this->logId)
 		    .detail("WriteKey", key)
 		    .detail("Value", value);
@@ -1592,6 +1782,8 @@ public:
 		}
 		writeBatch->Delete(it.value()->physicalShard->cf, toSlice(key));
 		dirtyShards->insert(it.value()->physicalShard);
+		++it.value()->physicalShard->numWrites;
+		it.value()->physicalShard->bytesWritten += key.size();
 	}
 
 	void clearRange(KeyRangeRef range, std::set<Key>* keysSet) {
@@ -2407,6 +2599,9 @@ ACTOR Future<Void> rocksDBAggregatedMetricsLogger(std::shared_ptr<ShardedRocksDB
 			if (rState->closing) {
 				break;
 			}
+			if (CacheBudgetBroker::enabled()) {
+				CacheBudgetBroker::getBroker().maybeRebalance();
+			}
 			rocksDBMetrics->logStats(db, manifestDirectory);
 			rocksDBMetrics->logMemUsage(db);
 			if (SERVER_KNOBS->ROCKSDB_PERFCONTEXT_SAMPLE_RATE != 0) {
@@ -3329,6 +3524,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			}
 			double dbGetBeginTime = a.getHistograms ? timer_monotonic() : 0;
 			auto s = db->Get(options, a.shard->cf, toSlice(a.key), &value);
+			a.shard->numReads.fetch_add(1, std::memory_order_relaxed);
 
 			if (a.getHistograms) {
 				rocksDBMetrics->getReadValueGetHistogram(threadIndex)
@@ -3417,6 +3613,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 
 			double dbGetBeginTime = a.getHistograms ? timer_monotonic() : 0;
 			auto s = db->Get(options, a.shard->cf, toSlice(a.key), &value);
+			a.shard->numReads.fetch_add(1, std::memory_order_relaxed);
 
 			if (a.getHistograms) {
 				rocksDBMetrics->getReadPrefixGetHistogram(threadIndex)
@@ -3605,17 +3802,27 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		for (unsigned i = 0; i < SERVER_KNOBS->ROCKSDB_READ_PARALLELISM; ++i) {
 			readThreads->addThread(new Reader(id, i, rocksDBMetrics), "fdb-rocksdb-re");
 		}
+		if (CacheBudgetBroker::enabled() && getBlockCache()) {
+			cacheBudgetConsumer =
+			    makeReference<ShardedRocksDBBlockCacheConsumer>(getBlockCache(), dbOptions.statistics);
+			CacheBudgetBroker::getBroker().addConsumer(cacheBudgetConsumer);
+		}
 	}
 
 	Future<Void> getError() const override { return errorFuture; }
 
 	ACTOR static void doClose(ShardedRocksDBKeyValueStore* self, bool deleteOnClose) {
 		self->rState->closing = true;
+		if (self->cacheBudgetConsumer.isValid()) {
+			CacheBudgetBroker::getBroker().removeConsumer(self->cacheBudgetConsumer);
+			self->cacheBudgetConsumer.clear();
+		}
 		// The metrics future retains a reference to the DB, so stop it before we delete it.
 		self->metrics.reset();
 		self->refreshHolder.cancel();
 		self->refreshRocksDBBackgroundWorkHolder.cancel();
 		self->cleanUpJob.cancel();
+		self->shardProfileJob.cancel();
 		self->counterLogger.cancel();
 
 		try {
@@ -3679,6 +3886,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			this->refreshRocksDBBackgroundWorkHolder =
 			    refreshRocksDBBackgroundEventCounter(this->id, this->eventListener);
 			this->cleanUpJob = emptyShardCleaner(this->rState, openFuture, &shardManager, writeThread);
+			this->shardProfileJob = updateShardProfiles(this->rState, openFuture, &shardManager);
 			writeThread->post(a.release());
 			counterLogger = counters.cc.traceCounters("RocksDBCounters", id, SERVER_KNOBS->ROCKSDB_METRICS_DELAY);
 			return openFuture;
@@ -3953,6 +4161,31 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		}
 		return Void();
 	}
+	ACTOR static Future<Void> updateShardProfiles(std::shared_ptr<ShardedRocksDBState> rState,
+	                                              Future<Void> openFuture,
+	                                              ShardManager* shardManager) {
+		if (SERVER_KNOBS->SHARDED_ROCKSDB_SHARD_PROFILE_INTERVAL <= 0) {
+			return Void();
+		}
+		try {
+			wait(openFuture);
+			state double lastUpdate = now();
+			loop {
+				wait(delay(SERVER_KNOBS->SHARDED_ROCKSDB_SHARD_PROFILE_INTERVAL));
+				if (rState->closing) {
+					break;
+				}
+				shardManager->updateShardProfiles(std::max(now() - lastUpdate, 1e-3));
+				lastUpdate = now();
+			}
+		} catch (Error& e) {
+			if (e.code() != error_code_actor_cancelled) {
+				TraceEvent(SevError, "ShardedRocksDBShardProfileError").errorUnsuppressed(e);
+			}
+		}
+		return Void();
+	}
+
 	ACTOR static Future<Void> emptyShardCleaner(std::shared_ptr<ShardedRocksDBState> rState,
 	                                            Future<Void> openFuture,
 	                                            ShardManager* shardManager,
@@ -4051,7 +4284,9 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 	Future<Void> refreshHolder;
 	Future<Void> refreshRocksDBBackgroundWorkHolder;
 	Future<Void> cleanUpJob;
+	Future<Void> shardProfileJob;
 	Future<Void> counterLogger;
+	Reference<ICacheBudgetConsumer> cacheBudgetConsumer;
 };
 
 ACTOR Future<Void> testCheckpointRestore(IKeyValueStore* kvStore, std::vector<KeyRange> ranges) {
@@ -4435,6 +4670,50 @@ TEST_CASE("noSim/ShardedRocksDB/ShardOps") {
 	return Void();
 }
 
+TEST_CASE("noSim/ShardedRocksDB/ShardProfiles") {
+	state std::string rocksDBTestDir = "sharded-rocksdb-kvs-test-db";
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+
+	state ShardedRocksDBKeyValueStore* rocksdbStore =
+	    new ShardedRocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
+	state IKeyValueStore* kvStore = rocksdbStore;
+	wait(kvStore->init());
+
+	wait(kvStore->addRange(KeyRangeRef("a"_sr, "c"_sr), "shard-1"));
+	wait(kvStore->addRange(KeyRangeRef("c"_sr, "f"_sr), "shard-2"));
+	wait(kvStore->addRange(KeyRangeRef("f"_sr, "h"_sr), "shard-3"));
+
+	// shard-1 takes the writes, shard-2 the reads, and shard-3 stays idle.
+	state int i = 0;
+	state Value value = makeString(SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_HEAVY_BYTES_PER_SEC / 100);
+	for (i = 0; i < 100; ++i) {
+		kvStore->set(KeyValueRef("a"_sr.withSuffix(format("%d", i)), value));
+	}
+	kvStore->set(KeyValueRef("d"_sr, "foo"_sr));
+	wait(kvStore->commit(false));
+	for (i = 0; i < SERVER_KNOBS->SHARDED_ROCKSDB_READ_HOT_OPS_PER_SEC; ++i) {
+		Optional<Value> val = wait(kvStore->readValue("d"_sr));
+		ASSERT(val.present());
+	}
+
+	rocksdbStore->shardManager.updateShardProfiles(1.0);
+	auto* shards = rocksdbStore->shardManager.getAllShards();
+	ASSERT(shards->at("shard-1")->profile == ShardOptionProfile::WRITE_HEAVY);
+	ASSERT(shards->at("shard-2")->profile == ShardOptionProfile::READ_HOT);
+	ASSERT(shards->at("shard-3")->profile == ShardOptionProfile::COLD);
+
+	// With no further load every shard cools down.
+	rocksdbStore->shardManager.updateShardProfiles(1.0);
+	ASSERT(shards->at("shard-1")->profile == ShardOptionProfile::COLD);
+	ASSERT(shards->at("shard-2")->profile == ShardOptionProfile::COLD);
+
+	Future<Void> closed = kvStore->onClosed();
+	kvStore->dispose();
+	wait(closed);
+	ASSERT(!directoryExists(rocksDBTestDir));
+	return Void();
+}
+
 TEST_CASE("noSim/ShardedRocksDB/Metadata") {
 	state std::string rocksDBTestDir = "sharded-rocksdb-kvs-test-db";
 	state Key testSpecialKey = "\xff\xff/TestKey"_sr;
@@ -50,6 +50,8 @@
 #include "fdbserver/Knobs.h"
 #include "fdbclient/JsonBuilder.h"
 #include "fdbclient/StorageWiggleMetrics.actor.h"
+#include "fdbrpc/Stats.h"
+#include "flow/HdrHistogram.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 const char* RecoveryStatus::names[] = { "reading_coordinated_state",
@@ -758,6 +760,72 @@ struct RolesInfo {
 	}
 };
 
+// Merges the histogram logged with a LatencySample event into merged, adopting the precision of the first one
+static void mergeLatencyHistogram(Optional<HdrHistogram>& merged, EventMap const& metrics, std::string const& event) {
+	auto it = metrics.find(event);
+	std::string encoded;
+	if (it == metrics.end() || !it->second.tryGetValue("Histogram", encoded)) {
+		return;
+	}
+	try {
+		HdrHistogram histogram = HdrHistogram::fromString(encoded);
+		if (merged.present()) {
+			merged.get().merge(histogram);
+		} else {
+			merged = std::move(histogram);
+		}
+	} catch (Error& e) {
+		if (e.code() != error_code_attribute_not_found) {
+			throw;
+		}
+		TraceEvent(SevWarn, "StatusLatencyHistogramInvalid").error(e).detail("Event", event);
+	}
+}
+
+static JsonBuilderObject getLatencyStatistics(HdrHistogram const& histogram) {
+	JsonBuilderObject latencyStats;
+	latencyStats["count"] = static_cast<int64_t>(histogram.count());
+	latencyStats["min"] = histogram.min() * LatencySample::resolution;
+	latencyStats["max"] = histogram.max() * LatencySample::resolution;
+	latencyStats["median"] = histogram.percentile(0.5) * LatencySample::resolution;
+	latencyStats["mean"] = histogram.mean() * LatencySample::resolution;
+	latencyStats["p25"] = histogram.percentile(0.25) * LatencySample::resolution;
+	latencyStats["p90"] = histogram.percentile(0.9) * LatencySample::resolution;
+	latencyStats["p95"] = histogram.percentile(0.95) * LatencySample::resolution;
+	latencyStats["p99"] = histogram.percentile(0.99) * LatencySample::resolution;
+	latencyStats["p99.9"] = histogram.percentile(0.999) * LatencySample::resolution;
+	return latencyStats;
+}
+
+// Cluster wide latency statistics, from the latest latency histograms of every storage server and proxy merged together
+static JsonBuilderObject latencyStatisticsFetcher(
+    std::vector<StorageServerStatusInfo> const& storageServers,
+    std::vector<std::pair<CommitProxyInterface, EventMap>> const& commitProxies,
+    std::vector<std::pair<GrvProxyInterface, EventMap>> const& grvProxies) {
+	Optional<HdrHistogram> read, commit, grv;
+	for (auto const& ss : storageServers) {
+		mergeLatencyHistogram(read, ss.eventMap, "ReadLatencyMetrics");
+	}
+	for (auto const& [_, metrics] : commitProxies) {
+		mergeLatencyHistogram(commit, metrics, "CommitLatencyMetrics");
+	}
+	for (auto const& [_, metrics] : grvProxies) {
+		mergeLatencyHistogram(grv, metrics, "GRVLatencyMetrics");
+	}
+
+	JsonBuilderObject latencyStats;
+	if (read.present()) {
+		latencyStats["read"] = getLatencyStatistics(read.get());
+	}
+	if (commit.present()) {
+		latencyStats["commit"] = getLatencyStatistics(commit.get());
+	}
+	if (grv.present()) {
+		latencyStats["grv"] = getLatencyStatistics(grv.get());
+	}
+	return latencyStats;
+}
+
 ACTOR static Future<JsonBuilderObject> processStatusFetcher(
     Reference<AsyncVar<ServerDBInfo>> db,
     std::vector<WorkerDetails> workers,
@@ -3552,6 +3620,10 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		                              loadResult.present() ? loadResult.get().healthyZone : Optional<Key>(),
 		                              &status_incomplete_reasons));
 		statusObj["processes"] = processStatus;
+		JsonBuilderObject latencyStats = latencyStatisticsFetcher(storageServers, commitProxies, grvProxies);
+		if (latencyStats.size()) {
+			statusObj["latency_statistics"] = latencyStats;
+		}
 		statusObj["clients"] = clientStatusFetcher(clientStatus);
 
 		if (configuration.present() && configuration.get().blobGranulesEnabled) {
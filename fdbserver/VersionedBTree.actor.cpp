@@ -25,6 +25,7 @@
 #include "fdbclient/Tuple.h"
 #include "fdbrpc/DDSketch.h"
 #include "fdbrpc/simulator.h"
+#include "fdbserver/CacheBudgetBroker.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/IPager.h"
@@ -47,10 +48,13 @@
 #include "flow/serialize.h"
 #include "flow/Trace.h"
 #include "flow/UnitTest.h"
+#include "flow/xxhash.h"
 #include "fmt/format.h"
 
+#include <algorithm>
 #include <boost/intrusive/list.hpp>
 #include <cinttypes>
+#include <cmath>
 #include <limits>
 #include <map>
 #include <random>
@@ -1461,6 +1465,9 @@ struct RedwoodMetrics {
 		unsigned int pagerEvictFail;
 		unsigned int btreeLeafPreload;
 		unsigned int btreeLeafPreloadExt;
+		unsigned int btreeLeafFilterProbe;
+		unsigned int btreeLeafFilterSavedRead;
+		unsigned int btreeLeafFilterFalsePositive;
 		unsigned int readRequestDecryptTimeNS;
 	};
 
@@ -1609,6 +1616,10 @@ ACTOR Future<Void> redwoodMetricsLogger() {
 	loop {
 		wait(delay(SERVER_KNOBS->REDWOOD_METRICS_INTERVAL));
 
+		if (CacheBudgetBroker::enabled()) {
+			CacheBudgetBroker::getBroker().maybeRebalance();
+		}
+
 		TraceEvent e("RedwoodMetrics");
 		double elapsed = now() - g_redwoodMetrics.startTime;
 		e.detail("Elapsed", elapsed);
@@ -1779,6 +1790,10 @@ public:
 		int64_t reservedSize = 0;
 		int64_t sizeLimit;
 
+		// Cumulative hits and misses of all ObjectCaches using this Evictor
+		int64_t hitCount = 0;
+		int64_t missCount = 0;
+
 	private:
 		EvictionOrderT evictionOrder;
 		// Size of all entries in the eviction order or held in external eviction orders
@@ -1830,6 +1845,7 @@ public:
 			// If this access is meant to be a hit
 			if (!noHit) {
 				++entry.hits;
+				++pEvictor->hitCount;
 				// If item eviction is not prioritized, move to end of eviction order
 				if (entry.ownedByEvictor) {
 					pEvictor->moveToBack(entry);
@@ -1837,6 +1853,7 @@ public:
 			}
 		} else {
 			// Otherwise it was a cache miss
+			++pEvictor->missCount;
 
 			// Finish initializing entry
 			entry.index = index;
@@ -1942,6 +1959,26 @@ public:
 	};
 	typedef ObjectCache<LogicalPageID, PageCacheEntry> PageCacheT;
 
+	// Lets the CacheBudgetBroker resize the page cache evictor shared by all DWALPagers in the process
+	class PageCacheBudgetConsumer : public ICacheBudgetConsumer {
+	public:
+		explicit PageCacheBudgetConsumer(PageCacheT::Evictor* evictor) : evictor(evictor) {}
+
+		const void* getCacheID() const override { return evictor; }
+		std::string getName() const override { return "Redwood"; }
+		int64_t getCapacity() const override { return evictor->sizeLimit; }
+		void setCapacity(int64_t bytes) override {
+			evictor->sizeLimit = bytes;
+			evictor->trim();
+		}
+		int64_t getUsage() const override { return evictor->getSizeUsed(); }
+		int64_t getHits() const override { return evictor->hitCount; }
+		int64_t getMisses() const override { return evictor->missCount; }
+
+	private:
+		PageCacheT::Evictor* evictor;
+	};
+
 	int64_t* getPageCachePenaltySource() override { return &pageCache.evictor().reservedSize; }
 
 	constexpr static PhysicalPageID primaryHeaderPageID = 0;
@@ -2026,8 +2063,18 @@ public:
 	    filename(filename), memoryOnly(memoryOnly), remapCleanupWindowBytes(remapCleanupWindowBytes),
 	    concurrentExtentReads(new FlowLock(concurrentExtentReads)) {
 
-		// This sets the page cache size for all PageCacheT instances using the same evictor
-		pageCache.evictor().sizeLimit = pageCacheBytes;
+		// This sets the page cache size for all PageCacheT instances using the same evictor, unless the evictor's
+		// size is already managed by the CacheBudgetBroker.  Memory only pagers share the same evictor, so they are
+		// registered with the broker as well rather than overwriting the size it granted.
+		if (CacheBudgetBroker::enabled()) {
+			if (!CacheBudgetBroker::getBroker().hasConsumer(&pageCache.evictor())) {
+				pageCache.evictor().sizeLimit = pageCacheBytes;
+			}
+			cacheBudgetConsumer = makeReference<PageCacheBudgetConsumer>(&pageCache.evictor());
+			CacheBudgetBroker::getBroker().addConsumer(cacheBudgetConsumer);
+		} else {
+			pageCache.evictor().sizeLimit = pageCacheBytes;
+		}
 
 		g_redwoodMetrics.ioLock = ioLock.getPtr();
 		if (!g_redwoodMetricsActor.isValid()) {
@@ -3647,6 +3694,11 @@ public:
 		}
 		wait(delay(0));
 
+		if (self->cacheBudgetConsumer.isValid()) {
+			CacheBudgetBroker::getBroker().removeConsumer(self->cacheBudgetConsumer);
+			self->cacheBudgetConsumer.clear();
+		}
+
 		// The next section explicitly cancels all pending operations held in the pager
 		debug_printf("DWALPager(%s) shutdown kill ioLock\n", self->filename.c_str());
 		self->ioLock->halt();
@@ -3909,6 +3961,7 @@ private:
 	bool fileInitialized = false;
 
 	PageCacheT pageCache;
+	Reference<ICacheBudgetConsumer> cacheBudgetConsumer;
 
 	// The extent cache isn't a normal cache, it isn't allowed to evict things.  It is populated
 	// during recovery with remap queue extents and then cleared.
@@ -4880,6 +4933,122 @@ public:
 	}
 };
 
+// In-memory Bloom filters over the keys of leaf pages, indexed by the first logical page ID of the leaf, which is
+// what a height 2 page links to.  Point reads use them to skip reading leaves which cannot contain the key.
+//
+// Keys are only ever added to a filter, so a filter covers every key that has been in its page since the filter's
+// validFrom version and can rule out a key for a read at any version at or after that.  When a leaf is written to
+// a new page ID or the filter becomes too full, a new filter is started at the write version, and older readers
+// no longer use a filter for that page.  Filters are not persisted and can be dropped at any time.
+class LeafFilterSet {
+public:
+	explicit LeafFilterSet(int bitsPerKey = SERVER_KNOBS->REDWOOD_LEAF_FILTER_BITS_PER_KEY,
+	                       int64_t maxBytes = SERVER_KNOBS->REDWOOD_LEAF_FILTER_MAX_BYTES)
+	  : bitsPerKey(bitsPerKey), maxBytes(maxBytes), memoryUsed(0) {
+		hashCount = std::clamp((int)std::round(bitsPerKey * 0.69), 1, 8);
+	}
+
+	~LeafFilterSet() { charge(-memoryUsed); }
+
+	bool enabled() const { return bitsPerKey > 0; }
+
+	// Counter to charge filter memory usage to
+	void setMemoryCounter(int64_t* counter) { pMemoryCounter = counter; }
+
+	// Start a new filter for page at version v.  Keys must be added with add().
+	void reset(LogicalPageID page, Version v, int keyCount) {
+		Filter& f = filters[page];
+		charge(-f.bytes());
+		f.validFrom = v;
+		f.keysAdded = 0;
+		f.bits.assign(std::max(1, (keyCount * bitsPerKey + 63) / 64), 0);
+		charge(f.bytes());
+		trim();
+	}
+
+	// Prepare page's filter for adding keyCount more keys at version v, keeping its validFrom version if the
+	// filter can take them without getting too full.
+	void extend(LogicalPageID page, Version v, int keyCount) {
+		auto i = filters.find(page);
+		if (i == filters.end() ||
+		    (int64_t)(i->second.keysAdded + keyCount) * bitsPerKey > (int64_t)i->second.bits.size() * 64 * 2) {
+			reset(page, v, keyCount);
+		}
+	}
+
+	void add(LogicalPageID page, KeyRef key) {
+		auto i = filters.find(page);
+		if (i == filters.end()) {
+			return;
+		}
+		Filter& f = i->second;
+		uint64_t h = XXH3_64bits(key.begin(), key.size());
+		uint32_t h1 = h;
+		uint32_t h2 = h >> 32;
+		uint64_t nbits = f.bits.size() * 64;
+		for (int k = 0; k < hashCount; ++k) {
+			uint64_t bit = (h1 + k * h2) % nbits;
+			f.bits[bit / 64] |= (uint64_t)1 << (bit % 64);
+		}
+		++f.keysAdded;
+	}
+
+	// Returns true if page has a filter which is valid at version v and key is definitely not in it
+	bool excludes(LogicalPageID page, Version v, KeyRef key) const {
+		auto i = filters.find(page);
+		if (i == filters.end() || v < i->second.validFrom) {
+			return false;
+		}
+		const Filter& f = i->second;
+		uint64_t h = XXH3_64bits(key.begin(), key.size());
+		uint32_t h1 = h;
+		uint32_t h2 = h >> 32;
+		uint64_t nbits = f.bits.size() * 64;
+		for (int k = 0; k < hashCount; ++k) {
+			uint64_t bit = (h1 + k * h2) % nbits;
+			if ((f.bits[bit / 64] & ((uint64_t)1 << (bit % 64))) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int64_t getMemoryUsed() const { return memoryUsed; }
+
+private:
+	struct Filter {
+		Version validFrom = invalidVersion;
+		int keysAdded = 0;
+		std::vector<uint64_t> bits;
+
+		int64_t bytes() const { return sizeof(Filter) + bits.size() * sizeof(uint64_t); }
+	};
+
+	void charge(int64_t bytes) {
+		memoryUsed += bytes;
+		if (pMemoryCounter != nullptr) {
+			*pMemoryCounter += bytes;
+		}
+	}
+
+	// Drop filters until memory usage is within the limit.  Which filters are dropped does not matter for
+	// correctness, reads of their pages just can't be skipped anymore.
+	void trim() {
+		while (memoryUsed > maxBytes && !filters.empty()) {
+			auto i = filters.begin();
+			charge(-i->second.bytes());
+			filters.erase(i);
+		}
+	}
+
+	int bitsPerKey;
+	int hashCount;
+	int64_t maxBytes;
+	int64_t memoryUsed;
+	int64_t* pMemoryCounter = nullptr;
+	std::unordered_map<LogicalPageID, Filter> filters;
+};
+
 class VersionedBTree {
 public:
 	// The first possible internal record possible in the tree
@@ -5051,6 +5220,7 @@ public:
 	    m_pBuffer(nullptr), m_mutationCount(0), m_name(name), m_logID(logID),
 	    m_pBoundaryVerifier(DecodeBoundaryVerifier::getVerifier(name)) {
 		m_pDecodeCacheMemory = m_pager->getPageCachePenaltySource();
+		m_leafFilters.setMemoryCounter(m_pDecodeCacheMemory);
 		m_lazyClearActor = 0;
 		m_init = init_impl(this);
 		m_latestCommit = m_init;
@@ -5666,6 +5836,9 @@ private:
 	// Counter to update with DecodeCache memory usage
 	int64_t* m_pDecodeCacheMemory = nullptr;
 
+	// Filters over the keys of leaf pages, their memory is charged to the same counter as DecodeCaches
+	LeafFilterSet m_leafFilters;
+
 	// The mutation buffer currently being written to
 	std::unique_ptr<MutationBuffer> m_pBuffer;
 	int64_t m_mutationCount;
@@ -6212,6 +6385,18 @@ private:
 				    childPageID, v, pageLowerBound.key, pageUpperBound.key, height, p->domainId));
 			}
 
+			if (height == 1 && self->m_leafFilters.enabled()) {
+				LogicalPageID id = childPageID.front();
+				if (previousID.size() == 1 && id == previousID.front()) {
+					self->m_leafFilters.extend(id, v, p->count);
+				} else {
+					self->m_leafFilters.reset(id, v, p->count);
+				}
+				for (int e = p->startIndex; e < p->endIndex(); ++e) {
+					self->m_leafFilters.add(id, entries[e].key);
+				}
+			}
+
 			if (++sinceYield > 100) {
 				sinceYield = 0;
 				wait(yield());
@@ -6381,6 +6566,27 @@ private:
 		}
 	}
 
+	// Add the keys of the leaf page under cursor, which was updated in place at version v, to the leaf's filter
+	void updateLeafFilter(BTreeNodeLinkRef oldID,
+	                      BTreeNodeLinkRef newID,
+	                      Version v,
+	                      BTreePage::BinaryTree::Cursor cursor) {
+		if (!m_leafFilters.enabled()) {
+			return;
+		}
+		LogicalPageID id = newID.front();
+		if (id == oldID.front()) {
+			m_leafFilters.extend(id, v, cursor.tree->numItems);
+		} else {
+			m_leafFilters.reset(id, v, cursor.tree->numItems);
+		}
+		cursor.moveFirst();
+		while (cursor.valid()) {
+			m_leafFilters.add(id, cursor.get().key);
+			cursor.moveNext();
+		}
+	}
+
 	void freeBTreePage(int height, BTreeNodeLinkRef btPageID, Version v) {
 		// Free individual pages at v
 		for (LogicalPageID id : btPageID) {
@@ -7145,6 +7351,7 @@ private:
 					                                                    &update->newLinks.arena(),
 					                                                    pageCopy.castTo<ArenaPage>(),
 					                                                    batch->writeVersion));
+					self->updateLeafFilter(rootID, newID, batch->writeVersion, cursor);
 
 					debug_printf("%s Leaf node updated in-place at version %s, new contents:\n",
 					             context.c_str(),
@@ -7683,12 +7890,16 @@ public:
 		Reference<IPagerSnapshot> pager;
 		bool valid;
 		std::vector<PathEntry> path;
+		// Whether a leaf filter ruled out or passed the key of the last seek
+		bool filteredOut = false;
+		bool filterPassed = false;
 
 	public:
 		BTreeCursor() : reason(PagerEventReasons::MAXEVENTREASONS) {}
 
 		bool initialized() const { return pager.isValid(); }
 		bool isValid() const { return valid; }
+		bool leafFilterPassed() const { return filterPassed; }
 
 		// path entries at dumpHeight or below will have their entire pages printed
 		std::string toString(int dumpHeight = 0) const {
@@ -7807,9 +8018,13 @@ public:
 		//     If there is a record in the tree > query then moveNext() will move to it.
 		// If non-zero is returned then the cursor is valid and the return value is logically equivalent
 		// to query.compare(cursor.get())
-		ACTOR Future<int> seek_impl(BTreeCursor* self, RedwoodRecordRef query) {
+		// If pointSeek is true, leaf filters are consulted and the seek stops early with filteredOut set if the leaf
+		// where query would be cannot contain its key.
+		ACTOR Future<int> seek_impl(BTreeCursor* self, RedwoodRecordRef query, bool pointSeek) {
 			state RedwoodRecordRef internalPageQuery = query.withMaxPageID();
 			self->path.resize(1);
+			self->filteredOut = false;
+			self->filterPassed = false;
 			debug_printf("seek(%s) start cursor = %s\n", query.toString().c_str(), self->toString().c_str());
 
 			loop {
@@ -7829,6 +8044,21 @@ public:
 				// to and will be updated if anything is inserted into the cleared range, so if the seek fails
 				// or it finds an entry with a null child page then query does not exist in the BTree.
 				if (entry.cursor.seekLessThan(internalPageQuery) && entry.cursor.get().value.present()) {
+					// For point reads, skip reading the leaf if its filter shows that query's key is not in it
+					if (pointSeek && entry.btPage()->height == 2 && self->btree->m_leafFilters.enabled()) {
+						++g_redwoodMetrics.metric.btreeLeafFilterProbe;
+						if (self->btree->m_leafFilters.excludes(
+						        entry.cursor.get().getChildPage().front(), self->pager->getVersion(), query.key)) {
+							++g_redwoodMetrics.metric.btreeLeafFilterSavedRead;
+							self->valid = false;
+							self->filteredOut = true;
+							debug_printf("seek(%s) loop exit leaf filtered out cursor=%s\n",
+							             query.toString().c_str(),
+							             self->toString().c_str());
+							return 0;
+						}
+						self->filterPassed = true;
+					}
 					debug_printf(
 					    "seek(%s) loop seek success cursor=%s\n", query.toString().c_str(), self->toString().c_str());
 					Future<Void> f = self->pushPage(entry.cursor);
@@ -7842,7 +8072,9 @@ public:
 			}
 		}
 
-		Future<int> seek(RedwoodRecordRef query) { return path.empty() ? 0 : seek_impl(this, query); }
+		Future<int> seek(RedwoodRecordRef query, bool pointSeek = false) {
+			return path.empty() ? 0 : seek_impl(this, query, pointSeek);
+		}
 
 		ACTOR Future<Void> seekGTE_impl(BTreeCursor* self, RedwoodRecordRef query) {
 			debug_printf("seekGTE(%s) start\n", query.toString().c_str());
@@ -7855,6 +8087,19 @@ public:
 
 		Future<Void> seekGTE(RedwoodRecordRef query) { return seekGTE_impl(this, query); }
 
+		ACTOR Future<Void> seekPoint_impl(BTreeCursor* self, RedwoodRecordRef query) {
+			debug_printf("seekPoint(%s) start\n", query.toString().c_str());
+			int cmp = wait(self->seek(query, true));
+			if (!self->filteredOut && (cmp > 0 || (cmp == 0 && !self->isValid()))) {
+				wait(self->moveNext());
+			}
+			return Void();
+		}
+
+		// Like seekGTE(), but if a leaf filter shows that query's key does not exist then the cursor is left invalid
+		// without reading the leaf.  Only for finding a single key, as the cursor can't be moved afterwards.
+		Future<Void> seekPoint(RedwoodRecordRef query) { return seekPoint_impl(this, query); }
+
 		// Start fetching sibling nodes in the forward or backward direction, stopping after recordLimit or byteLimit
 		void prefetch(KeyRef rangeEnd, bool directionForward, int recordLimit, int byteLimit) {
 			// Prefetch scans level 2 so if there are less than 2 nodes in the path there is no level 2
@@ -8302,7 +8547,7 @@ public:
 		    &cur, self->m_tree->getLastCommittedVersion(), PagerEventReasons::PointRead, options));
 
 		++g_redwoodMetrics.metric.opGet;
-		wait(cur.seekGTE(key));
+		wait(cur.seekPoint(key));
 		if (cur.isValid() && cur.get().key == key) {
 			// Return a Value whose arena depends on the source page arena
 			Value v;
@@ -8312,6 +8557,9 @@ public:
 			return v;
 		}
 
+		if (cur.leafFilterPassed()) {
+			++g_redwoodMetrics.metric.btreeLeafFilterFalsePositive;
+		}
 		return Optional<Value>();
 	}
 
@@ -8858,6 +9106,11 @@ void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 	std::pair<const char*, unsigned int> metrics[] = { { "BTreePreload", metric.btreeLeafPreload },
 		                                               { "BTreePreloadExt", metric.btreeLeafPreloadExt },
 		                                               { "", 0 },
+		                                               { "BTreeFilterProbe", metric.btreeLeafFilterProbe },
+		                                               { "BTreeFilterSavedRead", metric.btreeLeafFilterSavedRead },
+		                                               { "BTreeFilterFalsePositive",
+		                                                 metric.btreeLeafFilterFalsePositive },
+		                                               { "", 0 },
 		                                               { "OpSet", metric.opSet },
 		                                               { "OpSetKeyBytes", metric.opSetKeyBytes },
 		                                               { "OpSetValueBytes", metric.opSetValueBytes },
@@ -9153,6 +9406,53 @@ TEST_CASE("/redwood/correctness/unit/RedwoodRecordRef") {
 	return Void();
 }
 
+TEST_CASE("/redwood/correctness/unit/LeafFilterSet") {
+	LeafFilterSet filters(10, 1e6);
+	ASSERT(filters.enabled());
+
+	std::vector<Key> keys;
+	for (int i = 0; i < 100; ++i) {
+		keys.push_back(Key(format("key%05d", i)));
+	}
+
+	// Page 1 is written at version 10 with the even keys
+	filters.reset(1, 10, keys.size() / 2);
+	for (int i = 0; i < keys.size(); i += 2) {
+		filters.add(1, keys[i]);
+	}
+
+	// No false negatives, and reads before the filter's version or of other pages can't use it
+	for (int i = 0; i < keys.size(); i += 2) {
+		ASSERT(!filters.excludes(1, 10, keys[i]));
+		ASSERT(!filters.excludes(1, 9, keys[i + 1]));
+		ASSERT(!filters.excludes(2, 10, keys[i + 1]));
+	}
+
+	// Most absent keys are ruled out
+	int excluded = 0;
+	for (int i = 1; i < keys.size(); i += 2) {
+		excluded += filters.excludes(1, 10, keys[i]) ? 1 : 0;
+	}
+	ASSERT_GE(excluded, 40);
+
+	// Updating page 1 in place adds the odd keys and keeps the filter valid for older versions
+	filters.extend(1, 20, keys.size() / 2);
+	for (int i = 1; i < keys.size(); i += 2) {
+		filters.add(1, keys[i]);
+	}
+	for (int i = 0; i < keys.size(); ++i) {
+		ASSERT(!filters.excludes(1, 10, keys[i]));
+	}
+
+	// A page written to a new ID starts a new filter which can't be used by older versions
+	filters.reset(1, 30, 1);
+	filters.add(1, keys[0]);
+	ASSERT(!filters.excludes(1, 20, keys[1]));
+	ASSERT(filters.getMemoryUsed() > 0);
+
+	return Void();
+}
+
 TEST_CASE("Lredwood/correctness/unit/deltaTree/RedwoodRecordRef") {
 	// Sanity check on delta tree node format
 	ASSERT(DeltaTree2<RedwoodRecordRef>::Node::headerSize(false) == 4);
@@ -0,0 +1,105 @@
+/*
+ * CacheBudgetBroker.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_CACHEBUDGETBROKER_H
+#define FDBSERVER_CACHEBUDGETBROKER_H
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "fdbserver/Knobs.h"
+#include "flow/FastRef.h"
+#include "flow/flow.h"
+
+// A storage engine cache whose capacity can be changed at runtime by the CacheBudgetBroker.
+// All methods are called on the network thread.
+class ICacheBudgetConsumer : public ReferenceCounted<ICacheBudgetConsumer> {
+public:
+	virtual ~ICacheBudgetConsumer() = default;
+
+	// Identifies the underlying cache. Consumers which return the same ID share one cache, for example all
+	// Redwood instances in a process share one page cache evictor, and are given a single share of the budget.
+	virtual const void* getCacheID() const = 0;
+
+	virtual std::string getName() const = 0;
+
+	virtual int64_t getCapacity() const = 0;
+	virtual void setCapacity(int64_t bytes) = 0;
+	virtual int64_t getUsage() const = 0;
+
+	// Cumulative lookup counts since the cache was created
+	virtual int64_t getHits() const = 0;
+	virtual int64_t getMisses() const = 0;
+};
+
+// Divides one memory budget (CACHE_BUDGET_BROKER_BYTES) among all of the storage engine caches in this process,
+// so that the total does not grow with the number of storage engine instances colocated in the process.
+//
+// When consumers are added or removed the budget is split again in proportion to the current capacities.
+// Every CACHE_BUDGET_BROKER_INTERVAL seconds, a step of the budget is moved from the cache with the lowest
+// marginal utility to the one with the highest.  The marginal utility of a cache is estimated as its misses per
+// second per byte of capacity, and is zero for caches which are not full since more capacity would not help them.
+//
+// The broker has no actor of its own; consumers call maybeRebalance() from their periodic metrics loops.
+class CacheBudgetBroker : NonCopyable {
+public:
+	// Brokers are singletons, either one per real process or one per virtual process in simulation
+	static CacheBudgetBroker& getBroker();
+
+	static bool enabled() { return SERVER_KNOBS->CACHE_BUDGET_BROKER_BYTES > 0; }
+
+	void addConsumer(Reference<ICacheBudgetConsumer> consumer);
+	void removeConsumer(Reference<ICacheBudgetConsumer> consumer);
+
+	// Rebalances the capacities if at least CACHE_BUDGET_BROKER_INTERVAL seconds passed since the last rebalance
+	void maybeRebalance();
+
+	// Rebalances the capacities using the hits and misses since the last call
+	void rebalance();
+
+	bool hasConsumer(const void* cacheID) const { return consumers.count(cacheID) > 0; }
+
+	int64_t getBudget() const { return budget; }
+	int getConsumerCount() const { return consumers.size(); }
+
+	explicit CacheBudgetBroker(int64_t budget = 0) : budget(budget), lastRebalance(0) {}
+
+private:
+	struct Consumer {
+		Reference<ICacheBudgetConsumer> consumer;
+		int refs = 0;
+		int64_t lastHits = 0;
+		int64_t lastMisses = 0;
+	};
+
+	// Gives every consumer the minimum capacity and splits the rest of the budget in proportion to their current
+	// capacities
+	void distribute();
+
+	// The smallest capacity any cache is shrunk to
+	int64_t minCapacity() const;
+
+	int64_t budget;
+	double lastRebalance;
+	std::map<const void*, Consumer> consumers;
+};
+
+#endif
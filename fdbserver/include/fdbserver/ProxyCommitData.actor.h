@@ -53,6 +53,61 @@ struct ApplyMutationsData {
 	Reference<KeyRangeMap<Version>> keyVersion;
 };
 
+// Recent changes to keyServers, kept so that they can be pushed to clients watching the shard locations they cache
+struct ShardMapChangeLog {
+	// Every change at a version > oldestVersion is in changes
+	Version oldestVersion;
+	Deque<std::pair<Version, KeyRange>> changes;
+	AsyncTrigger onChange;
+	bool notifyPending = false;
+
+	explicit ShardMapChangeLog(Version oldestVersion) : oldestVersion(oldestVersion) {}
+
+	// Versions must not decrease.  Watchers are not woken until notify() is called.
+	void add(Version version, KeyRangeRef range) {
+		changes.emplace_back(version, range);
+		while (changes.size() > SERVER_KNOBS->SHARD_MAP_CHANGE_LOG_SIZE) {
+			oldestVersion = changes.front().first;
+			changes.pop_front();
+		}
+		notifyPending = true;
+	}
+
+	// Wakes the watchers once for all of the changes added since the last call, e.g. once per commit batch
+	void notify() {
+		if (notifyPending) {
+			notifyPending = false;
+			onChange.trigger();
+		}
+	}
+
+	Version latestVersion() const { return changes.empty() ? oldestVersion : changes.back().first; }
+
+	// Appends to result the parts of ranges changed at versions in (begin, end]
+	void getChanges(Version begin,
+	                Version end,
+	                VectorRef<KeyRangeRef> ranges,
+	                Arena& arena,
+	                VectorRef<KeyRangeRef>& result) const {
+		int lo = 0, hi = changes.size();
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (changes[mid].first <= begin) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		for (int i = lo; i < changes.size() && changes[i].first <= end; ++i) {
+			for (const auto& range : ranges) {
+				if (range.intersects(changes[i].second)) {
+					result.push_back_deep(arena, range & changes[i].second);
+				}
+			}
+		}
+	}
+};
+
 struct ProxyStats {
 	CounterCollection cc;
 	Counter txnCommitIn, txnCommitVersionAssigned, txnCommitResolving, txnCommitResolved, txnCommitOut,
@@ -68,6 +123,7 @@ struct ProxyStats {
 	Counter tenantIdRequestOut;
 	Counter tenantIdRequestErrors;
 	Counter blobGranuleLocationIn, blobGranuleLocationOut, blobGranuleLocationErrors;
+	Counter shardMapWatchIn, shardMapWatchOut, shardMapWatchErrors, shardMapLocationsPushed;
 	Counter txnExpensiveClearCostEstCount;
 	Version lastCommitVersionAssigned;
 
@@ -136,7 +192,9 @@ struct ProxyStats {
 	    keyServerLocationErrors("KeyServerLocationErrors", cc), tenantIdRequestIn("TenantIdRequestIn", cc),
 	    tenantIdRequestOut("TenantIdRequestOut", cc), tenantIdRequestErrors("TenantIdRequestErrors", cc),
 	    blobGranuleLocationIn("BlobGranuleLocationIn", cc), blobGranuleLocationOut("BlobGranuleLocationOut", cc),
-	    blobGranuleLocationErrors("BlobGranuleLocationErrors", cc),
+	    blobGranuleLocationErrors("BlobGranuleLocationErrors", cc), shardMapWatchIn("ShardMapWatchIn", cc),
+	    shardMapWatchOut("ShardMapWatchOut", cc), shardMapWatchErrors("ShardMapWatchErrors", cc),
+	    shardMapLocationsPushed("ShardMapLocationsPushed", cc),
 	    txnExpensiveClearCostEstCount("ExpensiveClearCostEstCount", cc), lastCommitVersionAssigned(0),
 	    commitLatencySample("CommitLatencyMetrics",
 	                        id,
@@ -222,6 +280,7 @@ struct ProxyCommitData {
 	// only tracks normalKeys. This is used for tracking versions for systemKeys.
 	Deque<Version> systemKeyVersions;
 	KeyRangeMap<ServerCacheInfo> keyInfo; // keyrange -> all storage servers in all DCs for the keyrange
+	ShardMapChangeLog shardMapChanges; // recent changes to keyInfo, for clients watching their location caches
 	KeyRangeMap<bool> cacheInfo;
 	std::map<Key, ApplyMutationsData> uid_applyMutationsData;
 	bool firstProxy;
@@ -347,10 +406,11 @@ struct ProxyCommitData {
 	    stats(dbgid, &version, &committedVersion, &commitBatchesMemBytesCount, &tenantMap), master(master),
 	    logAdapter(nullptr), txnStateStore(nullptr), committedVersion(recoveryTransactionVersion),
 	    minKnownCommittedVersion(0), version(0), lastVersionTime(0), commitVersionRequestNumber(1),
-	    mostRecentProcessedRequestNumber(0), firstProxy(firstProxy), encryptMode(encryptMode),
-	    encryptionMonitor(makeReference<GetEncryptCipherKeysMonitor>()), provisional(provisional), lastCoalesceTime(0),
-	    locked(false), commitBatchInterval(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN),
-	    localCommitBatchesStarted(0), getConsistentReadVersion(getConsistentReadVersion), commit(commit),
+	    mostRecentProcessedRequestNumber(0), shardMapChanges(recoveryTransactionVersion), firstProxy(firstProxy),
+	    encryptMode(encryptMode), encryptionMonitor(makeReference<GetEncryptCipherKeysMonitor>()),
+	    provisional(provisional), lastCoalesceTime(0), locked(false),
+	    commitBatchInterval(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN), localCommitBatchesStarted(0),
+	    getConsistentReadVersion(getConsistentReadVersion), commit(commit),
 	    cx(openDBOnServer(db, TaskPriority::DefaultEndpoint, LockAware::True)), db(db),
 	    singleKeyMutationEvent("SingleKeyMutation"_sr), lastTxsPop(0), popRemoteTxs(false), lastStartCommit(0),
 	    lastCommitLatency(SERVER_KNOBS->REQUIRED_MIN_RECOVERY_DURATION), lastCommitTime(0), lastMasterReset(now()),
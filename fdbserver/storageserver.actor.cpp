@@ -864,6 +864,8 @@ public:
 	  : key(key), value(value), version(version), tags(tags), debugID(debugID), tenantId(tenantId) {}
 };
 
+struct MultiKeyWatch;
+
 struct BusiestWriteTagContext {
 	const std::string busiestWriteTagTrackingKey;
 	UID ratekeeperID;
@@ -1083,6 +1085,10 @@ public:
 	void deleteWatchMetadata(KeyRef key, int64_t tenantId);
 	void clearWatchMetadata();
 
+	// Notify single-key and batched watches that a key, or every key in [begin, end), may have changed
+	void triggerWatch(KeyRef key);
+	void triggerWatchRange(KeyRef begin, KeyRef end);
+
 	// tenant map operations
 	void insertTenant(TenantMapEntry const& tenant, Version version, bool persist);
 	void clearTenants(StringRef startTenant, StringRef endTenant, Version version);
@@ -1337,6 +1343,16 @@ public:
 	Key sk;
 	Reference<AsyncVar<ServerDBInfo> const> db;
 	Database cx;
+	// Keys watched through WatchValuesRequests, mapped to the batched watches waiting on them and the index of the key
+	// in each. A batched watch costs one entry here per key rather than an actor, metadata and AsyncMap entry, and the
+	// map is ordered so that clears and shard moves trigger all of the keys in a range with one lookup.
+	// Declared before actors, whose watchValuesQ actors unregister their keys when they are destroyed.
+	using MultiKeyWatchMap_t = std::map<Key, std::vector<std::pair<MultiKeyWatch*, int>>, std::less<>>;
+	MultiKeyWatchMap_t multiKeyWatches;
+
+	// Versions read with ReadOptions::retainVersion, mapped to the time of their last read. update() keeps them
+	// readable for STORAGE_SNAPSHOT_RETENTION_TIME after that read, within the bounds of the other snapshot knobs.
+	std::map<Version, double> retainedSnapshotVersions;
 	ActorCollection actors;
 
 	CoalescedKeyRangeMap<bool, int64_t, KeyBytesMetric<int64_t>> byteSampleClears;
@@ -1421,8 +1437,9 @@ public:
 	struct Counters : CommonStorageCounters {
 
 		Counter allQueries, systemKeyQueries, getKeyQueries, getValueQueries, getRangeQueries, getRangeSystemKeyQueries,
-		    getRangeStreamQueries, lowPriorityQueries, rowsQueried, watchQueries, emptyQueries, feedRowsQueried,
-		    feedBytesQueried, feedStreamQueries, rejectedFeedStreamQueries, feedVersionQueries;
+		    getRangeStreamQueries, lowPriorityQueries, rowsQueried, watchQueries, watchValuesQueries, watchValuesKeys,
+		    emptyQueries, feedRowsQueried, feedBytesQueried, feedStreamQueries, rejectedFeedStreamQueries,
+		    feedVersionQueries;
 
 		// counters related to getMappedRange queries
 		Counter getMappedRangeBytesQueried, finishedGetMappedRangeSecondaryQueries, getMappedRangeQueries,
@@ -1514,7 +1531,9 @@ public:
 		    getRangeSystemKeyQueries("GetRangeSystemKeyQueries", cc),
 		    getMappedRangeQueries("GetMappedRangeQueries", cc), getRangeStreamQueries("GetRangeStreamQueries", cc),
 		    lowPriorityQueries("LowPriorityQueries", cc), rowsQueried("RowsQueried", cc),
-		    watchQueries("WatchQueries", cc), emptyQueries("EmptyQueries", cc), feedRowsQueried("FeedRowsQueried", cc),
+		    watchQueries("WatchQueries", cc), watchValuesQueries("WatchValuesQueries", cc),
+		    watchValuesKeys("WatchValuesKeys", cc), emptyQueries("EmptyQueries", cc),
+		    feedRowsQueried("FeedRowsQueried", cc),
 		    feedBytesQueried("FeedBytesQueried", cc), feedStreamQueries("FeedStreamQueries", cc),
 		    rejectedFeedStreamQueries("RejectedFeedStreamQueries", cc), feedVersionQueries("FeedVersionQueries", cc),
 		    logicalBytesInput("LogicalBytesInput", cc), logicalBytesMoveInOverhead("LogicalBytesMoveInOverhead", cc),
@@ -1620,6 +1639,8 @@ public:
 			specialCounter(cc, "QueryQueueMax", [self]() { return self->getAndResetMaxQueryQueueSize(); });
 			specialCounter(cc, "ActiveWatches", [self]() { return self->numWatches; });
 			specialCounter(cc, "WatchBytes", [self]() { return self->watchBytes; });
+			specialCounter(cc, "BatchWatchedKeys", [self]() { return self->multiKeyWatches.size(); });
+			specialCounter(cc, "RetainedSnapshotVersions", [self]() { return self->retainedSnapshotVersions.size(); });
 			specialCounter(cc, "KvstoreSizeTotal", [self]() { return std::get<0>(self->storage.getSize()); });
 			specialCounter(cc, "KvstoreNodeTotal", [self]() { return std::get<1>(self->storage.getSize()); });
 			specialCounter(cc, "KvstoreInlineKey", [self]() { return std::get<2>(self->storage.getSize()); });
@@ -1839,6 +1860,31 @@ public:
 
 	Counter::Value queueSize() const { return counters.bytesInput.getValue() - counters.bytesDurable.getValue(); }
 
+	void retainSnapshotVersion(Version readVersion, Optional<ReadOptions> const& options) {
+		if (options.present() && options.get().retainVersion) {
+			retainedSnapshotVersions[readVersion] = now();
+		}
+	}
+
+	// Returns the oldest version which must stay readable for snapshot reads, or latestVersion if there is none or the
+	// storage queue is too large to keep holding history back
+	Version oldestRetainedSnapshotVersion() {
+		Version minVersion = version.get() - SERVER_KNOBS->STORAGE_SNAPSHOT_MAX_RETAINED_VERSIONS;
+		double expiry = now() - SERVER_KNOBS->STORAGE_SNAPSHOT_RETENTION_TIME;
+		for (auto it = retainedSnapshotVersions.begin(); it != retainedSnapshotVersions.end();) {
+			if (it->first < minVersion || it->second < expiry) {
+				it = retainedSnapshotVersions.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (retainedSnapshotVersions.empty() ||
+		    queueSize() > SERVER_KNOBS->STORAGE_SNAPSHOT_RETENTION_MAX_QUEUE_BYTES) {
+			return latestVersion;
+		}
+		return retainedSnapshotVersions.begin()->first;
+	}
+
 	// penalty used by loadBalance() to balance requests among SSes. We prefer SS with less write queue size.
 	double getPenalty() const override {
 		return std::max(std::max(1.0,
@@ -2081,6 +2127,100 @@ void StorageServer::clearWatchMetadata() {
 	watchMap.clear();
 }
 
+// The storage server side of a WatchValuesRequest. Each key is registered in StorageServer::multiKeyWatches until it
+// fires, and a mutation to a registered key queues its index in pending until the request's actor re-reads it.
+struct MultiKeyWatch : NonCopyable {
+	StorageServer* data;
+	std::vector<StorageServer::MultiKeyWatchMap_t::iterator> entries; // multiKeyWatches entry of each registered key
+	std::vector<bool> registered;
+	std::vector<bool> queued; // Whether each key is in pending
+	std::vector<int> pending;
+	AsyncTrigger onPending;
+
+	explicit MultiKeyWatch(StorageServer* data) : data(data) {}
+	~MultiKeyWatch() {
+		for (int i = 0; i < registered.size(); i++) {
+			if (registered[i]) {
+				unregisterKey(i);
+			}
+		}
+	}
+
+	// Registers every key, queueing all of them so that their current values are checked before waiting for changes
+	void registerKeys(VectorRef<WatchedValueRef> keys) {
+		entries.reserve(keys.size());
+		registered.assign(keys.size(), true);
+		queued.assign(keys.size(), true);
+		pending.reserve(keys.size());
+		for (int i = 0; i < keys.size(); i++) {
+			auto it = data->multiKeyWatches.find(keys[i].key);
+			if (it == data->multiKeyWatches.end()) {
+				it = data->multiKeyWatches.emplace(keys[i].key, std::vector<std::pair<MultiKeyWatch*, int>>()).first;
+			}
+			it->second.emplace_back(this, i);
+			entries.push_back(it);
+			pending.push_back(i);
+		}
+	}
+
+	void unregisterKey(int index) {
+		ASSERT(registered[index]);
+		auto& watchers = entries[index]->second;
+		for (int i = 0; i < watchers.size(); i++) {
+			if (watchers[i].first == this && watchers[i].second == index) {
+				watchers[i] = watchers.back();
+				watchers.pop_back();
+				break;
+			}
+		}
+		if (watchers.empty()) {
+			data->multiKeyWatches.erase(entries[index]);
+		}
+		registered[index] = false;
+	}
+
+	// Called synchronously from the mutation path, so it must not touch multiKeyWatches
+	void trigger(int index) {
+		if (!queued[index]) {
+			queued[index] = true;
+			pending.push_back(index);
+			if (pending.size() == 1) {
+				onPending.trigger();
+			}
+		}
+	}
+
+	std::vector<int> takePending() {
+		std::vector<int> result;
+		std::swap(result, pending);
+		for (int index : result) {
+			queued[index] = false;
+		}
+		return result;
+	}
+};
+
+void StorageServer::triggerWatch(KeyRef key) {
+	watches.trigger(key);
+	if (!multiKeyWatches.empty()) {
+		auto it = multiKeyWatches.find(key);
+		if (it != multiKeyWatches.end()) {
+			for (auto& [watch, index] : it->second) {
+				watch->trigger(index);
+			}
+		}
+	}
+}
+
+void StorageServer::triggerWatchRange(KeyRef begin, KeyRef end) {
+	watches.triggerRange(begin, end);
+	for (auto it = multiKeyWatches.lower_bound(begin); it != multiKeyWatches.end() && it->first < end; ++it) {
+		for (auto& [watch, index] : it->second) {
+			watch->trigger(index);
+		}
+	}
+}
+
 #ifndef __INTEL_COMPILER
 #pragma endregion
 #endif
@@ -2464,6 +2604,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		state Optional<Value> v;
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
+		data->retainSnapshotVersion(version, req.options);
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
 		if (req.options.present() && req.options.get().debugID.present())
@@ -2576,7 +2717,13 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 // Pessimistic estimate the number of overhead bytes used by each
 // watch. Watch key references are stored in an AsyncMap<Key,bool>, and actors
 // must be kept alive until the watch is finished.
-extern size_t WATCH_OVERHEAD_WATCHQ, WATCH_OVERHEAD_WATCHIMPL;
+extern size_t WATCH_OVERHEAD_WATCHQ, WATCH_OVERHEAD_WATCHIMPL, WATCH_OVERHEAD_WATCHVALUESQ;
+
+// Pessimistic estimate of the bytes used by each key of a batched watch, besides the key and value themselves: its
+// multiKeyWatches node and watcher entry, and its bookkeeping in MultiKeyWatch.
+constexpr size_t WATCH_OVERHEAD_PER_BATCHED_KEY = sizeof(StorageServer::MultiKeyWatchMap_t::value_type) +
+                                                  4 * sizeof(void*) + sizeof(std::pair<MultiKeyWatch*, int>) +
+                                                  sizeof(StorageServer::MultiKeyWatchMap_t::iterator) + sizeof(int) + 1;
 
 ACTOR Future<Version> watchWaitForValueChange(StorageServer* data, SpanContext parent, KeyRef key, int64_t tenantId) {
 	state Location spanLocation = "SS:watchWaitForValueChange"_loc;
@@ -2767,6 +2914,153 @@ ACTOR Future<Void> watchValueSendReply(StorageServer* data,
 	}
 }
 
+// Serves a WatchValuesRequest. All of its keys are registered in one MultiKeyWatch; keys triggered within
+// WATCH_VALUES_BATCH_DELAY of each other are re-read together, and the ones whose value changed are sent back in one
+// reply. The stream ends once every key has fired.
+ACTOR Future<Void> watchValuesQ(StorageServer* data, WatchValuesRequest req) {
+	state Span span("SS:watchValues"_loc, req.spanContext);
+	state MultiKeyWatch watch(data);
+	state double startTime = now();
+	state int remaining = req.keys.size();
+	state int64_t watchBytes = WATCH_OVERHEAD_WATCHVALUESQ;
+	state Future<Void> tenantChanged = Never();
+
+	req.reply.setByteLimit(SERVER_KNOBS->RANGESTREAM_LIMIT_BYTES);
+	++data->counters.watchValuesQueries;
+	data->counters.watchValuesKeys += req.keys.size();
+	++data->numWatches;
+	data->watchBytes += watchBytes;
+
+	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
+	// so we need to downgrade here
+	wait(delay(0, TaskPriority::DefaultEndpoint));
+
+	try {
+		wait(success(waitForVersionNoTooOld(data, req.version)));
+		data->checkTenantEntry(latestVersion, req.tenantInfo, false);
+		if (req.tenantInfo.hasTenant()) {
+			for (auto& watched : req.keys) {
+				watched.key = watched.key.withPrefix(req.tenantInfo.prefix.get(), req.arena);
+			}
+			tenantChanged = data->tenantWatches.onChange(req.tenantInfo.tenantId);
+		}
+
+		int64_t keyBytes = 0;
+		for (const auto& watched : req.keys) {
+			keyBytes += watched.expectedSize() + WATCH_OVERHEAD_PER_BATCHED_KEY;
+		}
+		if (data->watchBytes + keyBytes > SERVER_KNOBS->MAX_STORAGE_SERVER_WATCH_BYTES) {
+			CODE_PROBE(true, "Too many watches for a batched watch, reverting to polling");
+			throw watch_cancelled();
+		}
+		watchBytes += keyBytes;
+		data->watchBytes += keyBytes;
+		watch.registerKeys(req.keys);
+
+		loop {
+			if (watch.pending.empty()) {
+				double timeoutDelay = -1;
+				if (data->noRecentUpdates.get()) {
+					timeoutDelay = std::max(CLIENT_KNOBS->FAST_WATCH_TIMEOUT - (now() - startTime), 0.0);
+				} else if (!BUGGIFY) {
+					timeoutDelay = std::max(CLIENT_KNOBS->WATCH_TIMEOUT - (now() - startTime), 0.0);
+				}
+
+				choose {
+					when(wait(watch.onPending.onTrigger())) {}
+					when(wait(tenantChanged)) {
+						data->checkTenantEntry(latestVersion, req.tenantInfo, false);
+						tenantChanged = data->tenantWatches.onChange(req.tenantInfo.tenantId);
+					}
+					when(wait(timeoutDelay < 0 ? Never() : delay(timeoutDelay))) {
+						// The client re-registers the keys which have not fired yet
+						throw timed_out();
+					}
+					when(wait(data->noRecentUpdates.onChange())) {}
+				}
+				continue;
+			}
+
+			wait(delay(SERVER_KNOBS->WATCH_VALUES_BATCH_DELAY));
+			wait(data->version.whenAtLeast(data->data().latestVersion));
+
+			state Version latest = data->version.get();
+			state std::vector<int> checking = watch.takePending();
+			state std::vector<int> fired;
+			state int begin = 0;
+			try {
+				for (; begin < checking.size(); begin += SERVER_KNOBS->WATCH_VALUES_READ_PARALLELISM) {
+					state std::vector<GetValueRequest> reads;
+					state std::vector<Future<Void>> readers;
+					int end = std::min<int>(checking.size(), begin + SERVER_KNOBS->WATCH_VALUES_READ_PARALLELISM);
+					reads.reserve(end - begin);
+					readers.reserve(end - begin);
+					for (int i = begin; i < end; i++) {
+						reads.emplace_back(span.context,
+						                   TenantInfo(),
+						                   req.keys[checking[i]].key,
+						                   latest,
+						                   req.tags,
+						                   Optional<ReadOptions>(),
+						                   VersionVector());
+						readers.push_back(getValueQ(data, reads.back()));
+					}
+
+					state int j = 0;
+					for (; j < reads.size(); j++) {
+						GetValueReply reply = wait(reads[j].reply.getFuture());
+						if (reply.error.present()) {
+							ASSERT(reply.error.get().code() != error_code_future_version);
+							throw reply.error.get();
+						}
+						int index = checking[begin + j];
+						if (reply.value.castTo<ValueRef>() != req.keys[index].value) {
+							fired.push_back(index);
+						}
+					}
+				}
+			} catch (Error& e) {
+				if (e.code() != error_code_transaction_too_old) {
+					throw;
+				}
+				CODE_PROBE(true, "Reading batched watch keys failed with transaction_too_old");
+				for (int index : checking) {
+					watch.trigger(index);
+				}
+				continue;
+			}
+
+			if (!fired.empty()) {
+				for (int index : fired) {
+					int64_t bytes = req.keys[index].expectedSize() + WATCH_OVERHEAD_PER_BATCHED_KEY;
+					watchBytes -= bytes;
+					data->watchBytes -= bytes;
+					watch.unregisterKey(index);
+				}
+				remaining -= fired.size();
+
+				wait(req.reply.onReady());
+				req.reply.send(WatchValuesReply(std::move(fired), latest));
+				if (remaining == 0) {
+					req.reply.sendError(end_of_stream());
+					break;
+				}
+			}
+		}
+	} catch (Error& e) {
+		data->watchBytes -= watchBytes;
+		--data->numWatches;
+		if (!canReplyWith(e))
+			throw;
+		req.reply.sendError(e);
+		return Void();
+	}
+
+	data->watchBytes -= watchBytes;
+	--data->numWatches;
+	return Void();
+}
+
 // Finds a checkpoint.
 ACTOR Future<Void> getCheckpointQ(StorageServer* self, GetCheckpointRequest req) {
 	// Wait until the desired version is durable.
@@ -3973,9 +4267,12 @@ size_t WATCH_OVERHEAD_WATCHQ =
     sizeof(WatchValueSendReplyActorState<WatchValueSendReplyActor>) + sizeof(WatchValueSendReplyActor);
 size_t WATCH_OVERHEAD_WATCHIMPL =
     sizeof(WatchWaitForValueChangeActorState<WatchWaitForValueChangeActor>) + sizeof(WatchWaitForValueChangeActor);
+size_t WATCH_OVERHEAD_WATCHVALUESQ =
+    sizeof(WatchValuesQActorState<WatchValuesQActor>) + sizeof(WatchValuesQActor);
 #else
 size_t WATCH_OVERHEAD_WATCHQ = 0; // only used in IDE so value is irrelevant
 size_t WATCH_OVERHEAD_WATCHIMPL = 0;
+size_t WATCH_OVERHEAD_WATCHVALUESQ = 0;
 #endif
 
 ACTOR Future<Void> getShardState_impl(StorageServer* data, GetShardStateRequest req) {
@@ -4170,6 +4467,12 @@ ACTOR Future<GetValueReqAndResultRef> quickGetValue(StorageServer* data,
 }
 
 // If limit>=0, it returns the first rows in the range (sorted ascending), otherwise the last rows (sorted descending).
+// Learns the size of readRange() results, so that their arena starts out large enough
+static ArenaSizeHint& readRangeArenaSizeHint() {
+	static ArenaSizeHint hint("GetKeyValuesReply");
+	return hint;
+}
+
 // readRange has O(|result|) + O(log |data|) cost
 ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
                                           Version version,
@@ -4196,6 +4499,8 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	// for remembering the position in the resultCache
 	state int pos = 0;
 
+	result.arena = Arena(readRangeArenaSizeHint().reserveSize());
+
 	// Check if the desired key-range is cached
 	auto containingRange = data->cachedRangeMap.rangeContaining(range.begin);
 	if (containingRange.value() && containingRange->range().end >= range.end) {
@@ -4421,6 +4726,7 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	ASSERT(result.data.size() == 0 || *pLimitBytes + result.data.end()[-1].expectedSize() + sizeof(KeyValueRef) > 0);
 	result.more = limit == 0 || *pLimitBytes <= 0; // FIXME: Does this have to be exact?
 	result.version = version;
+	readRangeArenaSizeHint().record(result.arena);
 	return result;
 }
 
@@ -4662,6 +4968,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		data->retainSnapshotVersion(version, req.options);
 		DisabledTraceEvent("VVV", data->thisServerID)
 		    .detail("Version", version)
 		    .detail("ReqVersion", req.version)
@@ -6357,6 +6664,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 		// VERSION_VECTOR change
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		data->retainSnapshotVersion(version, req.options);
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
 		data->checkTenantEntry(
@@ -6561,6 +6869,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		data->retainSnapshotVersion(version, req.options);
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
 		if (req.tenantInfo.hasTenant()) {
@@ -6769,6 +7078,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	try {
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
+		data->retainSnapshotVersion(version, req.options);
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.map(&ReadOptions::lockAware).orDefault(false));
@@ -7153,7 +7463,7 @@ void applyMutation(StorageServer* self,
 			++self->counters.pTreeClearSplits;
 		}
 		data.insert(m.param1, ValueOrClearToRef::value(m.param2));
-		self->watches.trigger(m.param1);
+		self->triggerWatch(m.param1);
 		++self->counters.pTreeSets;
 	} else if (m.type == MutationRef::ClearRange) {
 		data.erase(m.param1, m.param2);
@@ -7162,7 +7472,7 @@ void applyMutation(StorageServer* self,
 			ASSERT(!data.isClearContaining(data.atLatest(), m.param1));
 		}
 		data.insert(m.param1, ValueOrClearToRef::clearTo(m.param2));
-		self->watches.triggerRange(m.param1, m.param2);
+		self->triggerWatchRange(m.param1, m.param2);
 		++self->counters.pTreeClears;
 	}
 }
@@ -10120,7 +10430,7 @@ void changeServerKeys(StorageServer* data,
 				removeRanges.push_back(range);
 			}
 			data->addShard(ShardInfo::newNotAssigned(range));
-			data->watches.triggerRange(range.begin, range.end);
+			data->triggerWatchRange(range.begin, range.end);
 		} else if (!dataAvailable) {
 			// SOMEDAY: Avoid restarting adding/transferred shards
 			// bypass fetchkeys; shard is known empty at initial cluster version
@@ -10332,7 +10642,7 @@ void changeServerKeysWithPhysicalShards(StorageServer* data,
 			}
 			updatedShards.push_back(StorageServerShard::notAssigned(range, cVer));
 			data->pendingRemoveRanges[cVer].push_back(range);
-			data->watches.triggerRange(range.begin, range.end);
+			data->triggerWatchRange(range.begin, range.end);
 			TraceEvent(sevDm, "SSUnassignShard", data->thisServerID)
 			    .detail("Range", range)
 			    .detail("NowAssigned", nowAssigned)
@@ -11639,6 +11949,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			if (data->primaryLocality == tagLocalitySpecial || data->tag.locality == data->primaryLocality) {
 				proposedOldestVersion = std::max(proposedOldestVersion, data->lastTLogVersion - maxVersionsInMemory);
 			}
+			proposedOldestVersion = std::min(proposedOldestVersion, data->oldestRetainedSnapshotVersion());
 			proposedOldestVersion = std::min(proposedOldestVersion, data->version.get() - 1);
 			proposedOldestVersion = std::max(proposedOldestVersion, data->oldestVersion.get());
 			proposedOldestVersion = std::max(proposedOldestVersion, data->desiredOldestVersion.get());
@@ -13600,6 +13911,14 @@ ACTOR Future<Void> serveWatchValueRequests(StorageServer* self, FutureStream<Wat
 	}
 }
 
+ACTOR Future<Void> serveWatchValuesRequests(StorageServer* self, FutureStream<WatchValuesRequest> watchValues) {
+	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::WatchValue;
+	loop {
+		WatchValuesRequest req = waitNext(watchValues);
+		self->actors.add(watchValuesQ(self, req));
+	}
+}
+
 ACTOR Future<Void> serveChangeFeedStreamRequests(StorageServer* self,
                                                  FutureStream<ChangeFeedStreamRequest> changeFeedStream) {
 	loop {
@@ -13750,6 +14069,7 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->actors.add(serveGetKeyValuesStreamRequests(self, ssi.getKeyValuesStream.getFuture()));
 	self->actors.add(serveGetKeyRequests(self, ssi.getKey.getFuture()));
 	self->actors.add(serveWatchValueRequests(self, ssi.watchValue.getFuture()));
+	self->actors.add(serveWatchValuesRequests(self, ssi.watchValues.getFuture()));
 	self->actors.add(serveChangeFeedStreamRequests(self, ssi.changeFeedStream.getFuture()));
 	self->actors.add(serveOverlappingChangeFeedsRequests(self, ssi.overlappingChangeFeeds.getFuture()));
 	self->actors.add(serveChangeFeedPopRequests(self, ssi.changeFeedPop.getFuture()));
@@ -68,6 +68,7 @@
 #include "fdbclient/MonitorLeader.h"
 #include "fdbclient/ClientWorkerInterface.h"
 #include "flow/Profiler.h"
+#include "flow/ActorSampler.h"
 #include "flow/ThreadHelper.actor.h"
 #include "flow/Trace.h"
 #include "flow/flow.h"
@@ -2180,6 +2181,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 	                               SERVER_KNOBS->DEGRADED_WARNING_RESET_DELAY,
 	                               "DegradedReset"));
 	errorForwarders.add(loadedPonger(interf.debugPing.getFuture()));
+	errorForwarders.add(runActorSampler());
 	errorForwarders.add(waitFailureServer(interf.waitFailure.getFuture()));
 	errorForwarders.add(monitorTraceLogIssues(issues));
 	errorForwarders.add(testerServerCore(interf.testerInterface, connRecord, dbInfo, locality));
@@ -2629,6 +2631,16 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					profilerReq.reply.sendError(e);
 				}
 			}
+			when(ActorProfileRequest req = waitNext(interf.clientInterface.actorProfile.getFuture())) {
+				ActorSamplerProfile profile = getActorSamplerProfile(req.reset);
+				ActorProfileReply reply;
+				reply.stacks = std::move(profile.stacks);
+				reply.samples = profile.samples;
+				reply.dropped = profile.dropped;
+				reply.duration = now() - profile.start;
+				reply.hz = FLOW_KNOBS->ACTOR_SAMPLER_HZ;
+				req.reply.send(reply);
+			}
 			when(RecruitMasterRequest req = waitNext(interf.master.getFuture())) {
 				LocalLineage _;
 				getCurrentLineage()->modify(&RoleLineage::role) = ProcessClass::ClusterRole::Master;
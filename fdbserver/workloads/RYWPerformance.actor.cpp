@@ -258,6 +258,32 @@ struct RYWPerformanceWorkload : TestWorkload {
 		}
 	}
 
+	ACTOR static Future<Void> test_large_write_set(Database cx, RYWPerformanceWorkload* self, int cacheType) {
+		state int i;
+		state ReadYourWritesTransaction tr(cx);
+
+		loop {
+			try {
+				wait(self->fillCache(&tr, self, cacheType));
+
+				state double startTime = timer();
+
+				// Writes arrive out of key order and are only read back once they have all been made
+				for (i = 0; i < self->nodes; i++) {
+					tr.set(self->keyForIndex(deterministicRandom()->randomInt(0, self->nodes)), self->keyForIndex(i));
+				}
+				wait(success(
+				    tr.getRange(KeyRangeRef(self->keyForIndex(0), self->keyForIndex(self->nodes)), self->nodes)));
+
+				fprintf(stderr, "%f", self->nodes / (timer() - startTime));
+
+				return Void();
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
 	ACTOR static Future<Void> _start(Database cx, RYWPerformanceWorkload* self) {
 		state int i;
 		fprintf(stderr, "test_get_single, ");
@@ -292,6 +318,14 @@ struct RYWPerformanceWorkload : TestWorkload {
 			else
 				fprintf(stderr, ", ");
 		}
+		fprintf(stderr, "test_large_write_set, ");
+		for (i = 0; i < 14; i++) {
+			wait(self->test_large_write_set(cx, self, i));
+			if (i == 13)
+				fprintf(stderr, "\n");
+			else
+				fprintf(stderr, ", ");
+		}
 		return Void();
 	}
 
@@ -0,0 +1,226 @@
+/*
+ * RangeReadAhead.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbserver/TesterInterface.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Scans random ranges with the range_read_ahead option set, and checks that the rows returned are in order and are
+// exactly the rows returned by the same scan without read-ahead at the same read version.
+struct RangeReadAheadWorkload : TestWorkload {
+	static constexpr auto NAME = "RangeReadAhead";
+
+	int nodeCount, maxValueSize;
+	double testDuration;
+	bool correct;
+
+	std::vector<Future<Void>> clients;
+	PerfIntCounter scans, rowsRead, retries;
+
+	RangeReadAheadWorkload(WorkloadContext const& wcx)
+	  : TestWorkload(wcx), correct(true), scans("Scans"), rowsRead("RowsRead"), retries("Retries") {
+		nodeCount = getOption(options, "nodeCount"_sr, 2000);
+		maxValueSize = getOption(options, "maxValueSize"_sr, 500);
+		testDuration = getOption(options, "testDuration"_sr, 30.0);
+	}
+
+	Future<Void> setup(Database const& cx) override { return clientId != 0 ? Void() : _setup(cx, this); }
+
+	Future<Void> start(Database const& cx) override {
+		clients.push_back(timeout(client(cx->clone(), this), testDuration, Void()));
+		return delay(testDuration);
+	}
+
+	Future<bool> check(Database const& cx) override {
+		clients.clear();
+		return correct;
+	}
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		m.push_back(scans.getMetric());
+		m.push_back(rowsRead.getMetric());
+		m.push_back(retries.getMetric());
+	}
+
+	Key keyForIndex(int index) const { return StringRef(format("rangeReadAhead/%08d", index)); }
+
+	ACTOR static Future<Void> _setup(Database cx, RangeReadAheadWorkload* self) {
+		state int index = 0;
+		state Transaction tr(cx);
+		while (index < self->nodeCount) {
+			try {
+				for (int i = index; i < std::min(index + 100, self->nodeCount); ++i) {
+					int valueSize = deterministicRandom()->randomInt(1, self->maxValueSize + 1);
+					tr.set(self->keyForIndex(i), StringRef(deterministicRandom()->randomAlphaNumeric(valueSize)));
+				}
+				wait(tr.commit());
+				tr.reset();
+				index += 100;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+		return Void();
+	}
+
+	// Reads keys with consecutive range reads the way an application iterating over them does.  Each read continues
+	// either from the selector given by the previous result or from its last key.  If interrupt is set, the scan is
+	// sometimes interrupted by a read of another range.
+	ACTOR static Future<RangeResult> scan(RangeReadAheadWorkload* self,
+	                                      Transaction* tr,
+	                                      KeyRange keys,
+	                                      GetRangeLimits limits,
+	                                      Snapshot snapshot,
+	                                      Reverse reverse,
+	                                      bool useNextSelector,
+	                                      bool interrupt) {
+		state RangeResult rows;
+		state KeySelector begin = firstGreaterOrEqual(keys.begin);
+		state KeySelector end = firstGreaterOrEqual(keys.end);
+		loop {
+			if (interrupt && deterministicRandom()->random01() < 0.05) {
+				int index = deterministicRandom()->randomInt(0, self->nodeCount);
+				wait(success(tr->getRange(KeyRangeRef(self->keyForIndex(index), self->keyForIndex(index + 10)),
+				                          deterministicRandom()->randomInt(1, 5),
+				                          snapshot)));
+			}
+
+			state RangeResult result = wait(tr->getRange(begin, end, limits, snapshot, reverse));
+			rows.append_deep(rows.arena(), result.begin(), result.size());
+			if (!result.more) {
+				return rows;
+			}
+
+			if (useNextSelector || result.empty()) {
+				if (reverse) {
+					end = KeySelector(result.nextEndKeySelector(), result.arena());
+				} else {
+					begin = KeySelector(result.nextBeginKeySelector(), result.arena());
+				}
+			} else if (reverse) {
+				end = KeySelector(firstGreaterOrEqual(result.back().key), result.arena());
+			} else {
+				begin = KeySelector(firstGreaterThan(result.back().key), result.arena());
+			}
+		}
+	}
+
+	static GetRangeLimits randomLimits() {
+		GetRangeLimits limits;
+		switch (deterministicRandom()->randomInt(0, 3)) {
+		case 0:
+			limits = GetRangeLimits(deterministicRandom()->randomInt(1, 100));
+			break;
+		case 1:
+			limits = GetRangeLimits(GetRangeLimits::ROW_LIMIT_UNLIMITED, deterministicRandom()->randomInt(1, 20000));
+			break;
+		default:
+			limits =
+			    GetRangeLimits(deterministicRandom()->randomInt(1, 100), deterministicRandom()->randomInt(1, 20000));
+			break;
+		}
+		if (limits.hasByteLimit() && deterministicRandom()->coinflip()) {
+			limits.minRows = 0;
+		}
+		return limits;
+	}
+
+	bool checkScan(RangeResult const& expected, RangeResult const& actual, KeyRange keys, Reverse reverse) {
+		for (int i = 1; i < actual.size(); ++i) {
+			if (reverse ? actual[i].key >= actual[i - 1].key : actual[i].key <= actual[i - 1].key) {
+				TraceEvent(SevError, "RangeReadAheadOutOfOrder")
+				    .detail("Range", keys)
+				    .detail("Reverse", reverse)
+				    .detail("Index", i)
+				    .detail("Previous", actual[i - 1].key)
+				    .detail("Key", actual[i].key);
+				return false;
+			}
+		}
+		for (int i = 0; i < std::min(expected.size(), actual.size()); ++i) {
+			if (!(expected[i] == actual[i])) {
+				TraceEvent(SevError, "RangeReadAheadMismatch")
+				    .detail("Range", keys)
+				    .detail("Reverse", reverse)
+				    .detail("Index", i)
+				    .detail("ExpectedKey", expected[i].key)
+				    .detail("ActualKey", actual[i].key);
+				return false;
+			}
+		}
+		if (expected.size() != actual.size()) {
+			TraceEvent(SevError, "RangeReadAheadIncomplete")
+			    .detail("Range", keys)
+			    .detail("Reverse", reverse)
+			    .detail("ExpectedRows", expected.size())
+			    .detail("ActualRows", actual.size());
+			return false;
+		}
+		return true;
+	}
+
+	ACTOR static Future<Void> client(Database cx, RangeReadAheadWorkload* self) {
+		state Transaction tr(cx);
+		state Transaction reference(cx);
+		loop {
+			state int beginIndex = deterministicRandom()->randomInt(0, self->nodeCount);
+			state KeyRange keys = KeyRangeRef(
+			    self->keyForIndex(beginIndex),
+			    self->keyForIndex(deterministicRandom()->randomInt(beginIndex + 1, self->nodeCount + 1)));
+			state GetRangeLimits limits = randomLimits();
+			state bool snapshot = deterministicRandom()->coinflip();
+			state bool reverse = deterministicRandom()->coinflip();
+			state bool useNextSelector = deterministicRandom()->coinflip();
+			state int64_t readAheadBatches = deterministicRandom()->randomInt(1, 9);
+			state int64_t noReadAhead = 0;
+
+			tr.reset();
+			reference.reset();
+			loop {
+				try {
+					tr.setOption(FDBTransactionOptions::RANGE_READ_AHEAD,
+					             StringRef((uint8_t*)&readAheadBatches, sizeof(int64_t)));
+					reference.setOption(FDBTransactionOptions::RANGE_READ_AHEAD,
+					                    StringRef((uint8_t*)&noReadAhead, sizeof(int64_t)));
+					Version version = wait(tr.getReadVersion());
+					reference.setVersion(version);
+
+					state RangeResult expected = wait(scan(
+					    self, &reference, keys, limits, Snapshot(snapshot), Reverse(reverse), useNextSelector, false));
+					RangeResult actual = wait(
+					    scan(self, &tr, keys, limits, Snapshot(snapshot), Reverse(reverse), useNextSelector, true));
+					if (!self->checkScan(expected, actual, keys, Reverse(reverse))) {
+						self->correct = false;
+					}
+					++self->scans;
+					self->rowsRead += actual.size();
+					break;
+				} catch (Error& e) {
+					++self->retries;
+					reference.reset();
+					wait(tr.onError(e));
+				}
+			}
+		}
+	}
+};
+
+WorkloadFactory<RangeReadAheadWorkload> RangeReadAheadWorkloadFactory;
@@ -19,6 +19,7 @@
  */
 
 #include "fdbrpc/DDSketch.h"
+#include "fdbclient/DatabaseContext.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbserver/TesterInterface.actor.h"
 #include "flow/DeterministicRandom.h"
@@ -29,17 +30,23 @@ struct WatchesWorkload : TestWorkload {
 	static constexpr auto NAME = "Watches";
 
 	int nodes, keyBytes, extraPerNode;
+	// Number of the never changing extra keys each watcher watches along with its watch key, to measure the cost of
+	// registering and holding watches per watched key
+	int idleWatchesPerNode;
 	double testDuration;
 	std::vector<Future<Void>> clients;
-	PerfIntCounter cycles;
+	PerfIntCounter cycles, watchedKeys;
 	DDSketch<double> cycleLatencies;
 	std::vector<int> nodeOrder;
+	int64_t batchedWatchRequests = 0, batchedWatchKeys = 0;
 
-	WatchesWorkload(WorkloadContext const& wcx) : TestWorkload(wcx), cycles("Cycles"), cycleLatencies() {
+	WatchesWorkload(WorkloadContext const& wcx)
+	  : TestWorkload(wcx), cycles("Cycles"), watchedKeys("WatchedKeys"), cycleLatencies() {
 		testDuration = getOption(options, "testDuration"_sr, 600.0);
 		nodes = getOption(options, "nodeCount"_sr, 100);
 		extraPerNode = getOption(options, "extraPerNode"_sr, 1000);
 		keyBytes = std::max(getOption(options, "keyBytes"_sr, 16), 16);
+		idleWatchesPerNode = std::min(getOption(options, "idleWatchesPerNode"_sr, 0), extraPerNode);
 
 		for (int i = 0; i < nodes + 1; i++)
 			nodeOrder.push_back(i);
@@ -61,6 +68,8 @@ struct WatchesWorkload : TestWorkload {
 			if (clients[i].isError())
 				ok = false;
 		clients.clear();
+		batchedWatchRequests = cx->transactionBatchedWatchRequests.getValue();
+		batchedWatchKeys = cx->transactionBatchedWatchKeys.getValue();
 		return ok;
 	}
 
@@ -68,7 +77,16 @@ struct WatchesWorkload : TestWorkload {
 		if (clientId == 0) {
 			m.push_back(cycles.getMetric());
 			m.emplace_back("Mean Latency (ms)", 1000 * cycleLatencies.mean() / nodes, Averaged::True);
+			// Each cycle waits for one watch per node while every node holds 1 + idleWatchesPerNode watches
+			m.emplace_back("Mean Latency per Watched Key (us)",
+			               1e6 * cycleLatencies.mean() / (nodes * (1 + idleWatchesPerNode)),
+			               Averaged::True);
 		}
+		m.push_back(watchedKeys.getMetric());
+		m.emplace_back("Batched Watch Requests", batchedWatchRequests, Averaged::False);
+		m.emplace_back("Keys per Batched Watch Request",
+		               batchedWatchRequests ? double(batchedWatchKeys) / batchedWatchRequests : 0.0,
+		               Averaged::True);
 	}
 
 	Key keyForIndex(uint64_t index) {
@@ -98,7 +116,9 @@ struct WatchesWorkload : TestWorkload {
 				self->clients.push_back(self->watcher(cx,
 				                                      self->keyForIndex(self->nodeOrder[i]),
 				                                      self->keyForIndex(self->nodeOrder[i + 1]),
-				                                      self->extraPerNode));
+				                                      self->extraPerNode,
+				                                      self->idleWatchesPerNode,
+				                                      &self->watchedKeys));
 
 		return Void();
 	}
@@ -125,7 +145,12 @@ struct WatchesWorkload : TestWorkload {
 		return Void();
 	}
 
-	ACTOR static Future<Void> watcher(Database cx, Key watchKey, Key setKey, int extraNodes) {
+	ACTOR static Future<Void> watcher(Database cx,
+	                                  Key watchKey,
+	                                  Key setKey,
+	                                  int extraNodes,
+	                                  int idleWatches,
+	                                  PerfIntCounter* watchedKeys) {
 		state Optional<Optional<Value>> lastValue;
 
 		loop {
@@ -158,7 +183,15 @@ struct WatchesWorkload : TestWorkload {
 					} else {
 						//TraceEvent("WatcherWatch").detail("Watch", printable(watchKey));
 						state Future<Void> watchFuture = tr->watch(makeReference<Watch>(watchKey, watchValue));
+						// The extra keys are never changed after setup, so these watches are held until the next cycle
+						state std::vector<Future<Void>> idleWatchFutures;
+						for (int i = 0; i < idleWatches; i++) {
+							Key extraKey = KeyRef(watchKey.toString() + format("%d", i));
+							idleWatchFutures.push_back(
+							    tr->watch(makeReference<Watch>(extraKey, Value(std::string(100, '.')))));
+						}
 						wait(tr->commit());
+						*watchedKeys += 1 + idleWatches;
 						if (BUGGIFY) {
 							// Make watch future outlive transaction
 							tr.reset();
@@ -32,6 +32,9 @@ struct WriteBandwidthWorkload : KVWorkload {
 	static constexpr auto NAME = "WriteBandwidth";
 
 	int keysPerTransaction;
+	// Keys which are set a second time in each transaction, exercising client-side mutation coalescing
+	int overwritesPerTransaction;
+	int64_t mutationBytesSent = 0;
 	double testDuration, warmingDelay, loadTime, maxInsertRate;
 	std::string valueString;
 
@@ -44,6 +47,7 @@ struct WriteBandwidthWorkload : KVWorkload {
 	    GRVLatencies() {
 		testDuration = getOption(options, "testDuration"_sr, 10.0);
 		keysPerTransaction = getOption(options, "keysPerTransaction"_sr, 100);
+		overwritesPerTransaction = keysPerTransaction * getOption(options, "overwriteFraction"_sr, 0.0);
 		valueString = std::string(maxValueBytes, '.');
 
 		warmingDelay = getOption(options, "warmingDelay"_sr, 0.0);
@@ -80,6 +84,7 @@ struct WriteBandwidthWorkload : KVWorkload {
 		m.emplace_back("Bytes written/sec",
 		               (writes * (keyBytes + (minValueBytes + maxValueBytes) * 0.5)) / duration,
 		               Averaged::False);
+		m.emplace_back("Mutation bytes sent/sec", mutationBytesSent / duration, Averaged::False);
 	}
 
 	Value randomValue() {
@@ -99,12 +104,14 @@ struct WriteBandwidthWorkload : KVWorkload {
 	}
 
 	ACTOR Future<Void> _start(Database cx, WriteBandwidthWorkload* self) {
+		state int64_t mutationBytesSent = cx->transactionCommitMutationBytesSent.getValue();
 		for (int i = 0; i < self->actorCount; i++) {
 			self->clients.push_back(self->writeClient(cx, self));
 		}
 
 		wait(timeout(waitForAll(self->clients), self->testDuration, Void()));
 		self->clients.clear();
+		self->mutationBytesSent = cx->transactionCommitMutationBytesSent.getValue() - mutationBytesSent;
 		return Void();
 	}
 
@@ -125,6 +132,11 @@ struct WriteBandwidthWorkload : KVWorkload {
 
 					for (int i = 0; i < self->keysPerTransaction; i++)
 						tr.set(self->keyForIndex(startIdx + i, false), self->randomValue(), AddConflictRange::False);
+					for (int i = 0; i < self->overwritesPerTransaction; i++) {
+						uint64_t index = startIdx + deterministicRandom()->randomInt(0, self->keysPerTransaction);
+						Key key = self->keyForIndex(index, false);
+						tr.set(key, self->randomValue(), AddConflictRange::False);
+					}
 
 					start = now();
 					wait(tr.commit());
@@ -0,0 +1,224 @@
+/*
+ * ActorSampler.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cerrno>
+
+#include "flow/ActorSampler.h"
+#include "flow/Knobs.h"
+#include "flow/UnitTest.h"
+
+#ifdef __linux__
+#include <signal.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+struct ActorSample {
+	TaskPriority priority;
+	int depth; // The depth of g_actorNameStack, of which the first ActorNameStack::maxDepth names are recorded
+	const char* names[ActorNameStack::maxDepth];
+};
+
+// Written only by sampleActors() and read only by drainActorSamples(). Both run on the network thread, but the signal
+// handler can interrupt a drain, so the indexes are atomics.
+constexpr uint32_t actorSampleRingSize = 1024;
+ActorSample actorSampleRing[actorSampleRingSize];
+std::atomic<uint32_t> actorSampleHead;
+std::atomic<uint32_t> actorSampleTail;
+std::atomic<int64_t> actorSamplesDropped;
+
+ActorSamplerProfile actorSamplerProfile;
+
+std::string foldActorSample(const ActorSample& sample) {
+	std::string stack = format("Priority%d", static_cast<int>(sample.priority));
+	if (sample.depth == 0) {
+		stack += ";[run loop]";
+	}
+	for (int i = 0; i < std::min(sample.depth, ActorNameStack::maxDepth); ++i) {
+		stack += ';';
+		stack += sample.names[i];
+	}
+	if (sample.depth > ActorNameStack::maxDepth) {
+		stack += ";...";
+	}
+	return stack;
+}
+
+void drainActorSamples() {
+	uint32_t tail = actorSampleTail.load(std::memory_order_relaxed);
+	uint32_t head = actorSampleHead.load(std::memory_order_acquire);
+	for (; tail != head; ++tail) {
+		std::string stack = foldActorSample(actorSampleRing[tail % actorSampleRingSize]);
+		auto it = actorSamplerProfile.stacks.find(stack);
+		if (it == actorSamplerProfile.stacks.end()) {
+			if (actorSamplerProfile.stacks.size() >= FLOW_KNOBS->ACTOR_SAMPLER_MAX_STACKS) {
+				stack = "[other]";
+			}
+			it = actorSamplerProfile.stacks.emplace(std::move(stack), 0).first;
+		}
+		++it->second;
+		++actorSamplerProfile.samples;
+	}
+	actorSampleTail.store(tail, std::memory_order_release);
+	actorSamplerProfile.dropped += actorSamplesDropped.exchange(0, std::memory_order_relaxed);
+}
+
+} // namespace
+
+void sampleActors() {
+	// async signal safe!
+	uint32_t head = actorSampleHead.load(std::memory_order_relaxed);
+	if (head - actorSampleTail.load(std::memory_order_acquire) >= actorSampleRingSize) {
+		actorSamplesDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ActorSample& sample = actorSampleRing[head % actorSampleRingSize];
+	const ActorNameStack& stack = g_actorNameStack;
+	sample.priority = g_network ? g_network->getCurrentTask() : TaskPriority::Zero;
+	sample.depth = stack.depth;
+	for (int i = 0; i < std::min(sample.depth, ActorNameStack::maxDepth); ++i) {
+		sample.names[i] = stack.names[i];
+	}
+	actorSampleHead.store(head + 1, std::memory_order_release);
+}
+
+ActorSamplerProfile getActorSamplerProfile(bool reset) {
+	drainActorSamples();
+	if (actorSamplerProfile.start == 0) {
+		actorSamplerProfile.start = now();
+	}
+	ActorSamplerProfile profile = actorSamplerProfile;
+	if (reset) {
+		actorSamplerProfile = ActorSamplerProfile();
+		actorSamplerProfile.start = now();
+	}
+	return profile;
+}
+
+#ifdef __linux__
+
+namespace {
+
+// A real-time signal, so that the sampler doesn't collide with the SIGPROF handlers of the slow task profiler and the
+// flow profiler, which may run at the same time.
+int actorSamplerSignal() {
+	return SIGRTMIN + 2;
+}
+
+void actorSamplerSignalHandler(int, siginfo_t*, void*) {
+	int savedErrno = errno;
+	sampleActors();
+	errno = savedErrno;
+}
+
+} // namespace
+
+ACTOR Future<Void> runActorSampler() {
+	state timer_t timer;
+
+	if (g_network->isSimulated() || FLOW_KNOBS->ACTOR_SAMPLER_HZ <= 0) {
+		return Void();
+	}
+
+	struct sigaction act;
+	act.sa_sigaction = actorSamplerSignalHandler;
+	sigemptyset(&act.sa_mask);
+	act.sa_flags = SA_SIGINFO | SA_RESTART;
+	if (sigaction(actorSamplerSignal(), &act, nullptr) != 0) {
+		TraceEvent(SevWarn, "ActorSamplerSignalFailed").GetLastError();
+		return Void();
+	}
+
+	sigevent sev;
+	memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = actorSamplerSignal();
+	sev._sigev_un._tid = syscall(__NR_gettid);
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer) != 0) {
+		TraceEvent(SevWarn, "ActorSamplerTimerFailed").GetLastError();
+		return Void();
+	}
+
+	int64_t periodNs = 1000000000 / std::min(FLOW_KNOBS->ACTOR_SAMPLER_HZ, 1000000);
+	itimerspec tv;
+	tv.it_interval.tv_sec = periodNs / 1000000000;
+	tv.it_interval.tv_nsec = periodNs % 1000000000;
+	tv.it_value = tv.it_interval;
+	if (timer_settime(timer, 0, &tv, nullptr) != 0) {
+		TraceEvent(SevWarn, "ActorSamplerTimerFailed").GetLastError();
+		timer_delete(timer);
+		return Void();
+	}
+	TraceEvent("ActorSamplerStarted").detail("Hz", FLOW_KNOBS->ACTOR_SAMPLER_HZ);
+
+	try {
+		loop {
+			wait(delay(FLOW_KNOBS->ACTOR_SAMPLER_DRAIN_INTERVAL, TaskPriority::Min));
+			drainActorSamples();
+		}
+	} catch (Error& e) {
+		timer_delete(timer);
+		throw;
+	}
+}
+
+#else
+
+Future<Void> runActorSampler() {
+	return Void();
+}
+
+#endif
+
+TEST_CASE("/flow/ActorSampler/Fold") {
+	getActorSamplerProfile(true);
+
+	pushActorName("ActorSamplerOuter");
+	pushActorName("ActorSamplerInner");
+	sampleActors();
+	sampleActors();
+	popActorName();
+	sampleActors();
+	popActorName();
+
+	ActorSamplerProfile profile = getActorSamplerProfile(true);
+	ASSERT_EQ(profile.samples, 3);
+	ASSERT_EQ(profile.dropped, 0);
+	int64_t inner = 0, outer = 0;
+	for (const auto& [stack, count] : profile.stacks) {
+		ASSERT(stack.rfind("Priority", 0) == 0);
+		if (StringRef(stack).endsWith(";ActorSamplerOuter;ActorSamplerInner"_sr)) {
+			inner += count;
+		} else if (StringRef(stack).endsWith(";ActorSamplerOuter"_sr)) {
+			outer += count;
+		}
+	}
+	ASSERT_EQ(inner, 2);
+	ASSERT_EQ(outer, 1);
+	ASSERT_EQ(getActorSamplerProfile(false).samples, 0);
+
+	return Void();
+}
@@ -25,6 +25,8 @@
 
 #include "flow/config.h"
 
+#include <mutex>
+
 // We don't align memory properly, and we need to tell lsan about that.
 extern "C" const char* __lsan_default_options(void) {
 	return "use_unaligned=1";
@@ -105,6 +107,85 @@ void makeNoAccess(void*, size_t) {}
 void makeDefined(void*, size_t) {}
 void makeUndefined(void*, size_t) {}
 #endif
+
+// Reusing blocks would hide use-after-free errors from the memory checkers
+#if defined(ADDRESS_SANITIZER) || VALGRIND
+#define ARENA_BLOCK_CACHE 0
+#else
+#define ARENA_BLOCK_CACHE 1
+#endif
+
+// Blocks of 512 to 8192 bytes are allocated with new[]. Those freed on a thread are kept on that thread, up to
+// ARENA_BLOCK_CACHE_BYTES in total, and reused by the next arenas needing a block of the same size. The cache is
+// trivially destructible so that blocks freed by the destructors of other thread locals can still look at it;
+// ArenaBlockCacheOwner empties and closes it when the thread exits.
+struct ArenaBlockCache {
+	static constexpr int kClasses = 5;
+	void* heads[kClasses];
+	int64_t bytes;
+	bool registered;
+	bool closed;
+
+	static int sizeClass(int size) {
+		int c = 0;
+		while ((512 << c) < size) {
+			++c;
+		}
+		return c;
+	}
+};
+thread_local ArenaBlockCache arenaBlockCache;
+
+struct ArenaBlockCacheOwner {
+	~ArenaBlockCacheOwner() {
+		arenaBlockCache.closed = true;
+		for (auto& head : arenaBlockCache.heads) {
+			while (head) {
+				void* next = *(void**)head;
+				delete[] static_cast<uint8_t*>(head);
+				head = next;
+			}
+		}
+		arenaBlockCache.bytes = 0;
+	}
+};
+
+void* allocateArenaBlock(int size) {
+#if ARENA_BLOCK_CACHE
+	if (!keepalive_allocator::isActive()) {
+		ArenaBlockCache& cache = arenaBlockCache;
+		void*& head = cache.heads[ArenaBlockCache::sizeClass(size)];
+		if (head) {
+			void* b = head;
+			head = *(void**)b;
+			cache.bytes -= size;
+			return b;
+		}
+		g_arenaBlockCacheMisses.fetch_add(1, std::memory_order_relaxed);
+	}
+#endif
+	return allocateAndMaybeKeepalive(size);
+}
+
+void freeArenaBlock(void* b, int size) {
+#if ARENA_BLOCK_CACHE
+	if (!keepalive_allocator::isActive()) {
+		ArenaBlockCache& cache = arenaBlockCache;
+		if (!cache.closed && FLOW_KNOBS && cache.bytes + size <= FLOW_KNOBS->ARENA_BLOCK_CACHE_BYTES) {
+			if (!cache.registered) {
+				static thread_local ArenaBlockCacheOwner owner;
+				cache.registered = true;
+			}
+			void*& head = cache.heads[ArenaBlockCache::sizeClass(size)];
+			*(void**)b = head;
+			head = b;
+			cache.bytes += size;
+			return;
+		}
+	}
+#endif
+	freeOrMaybeKeepalive(b);
+}
 } // namespace
 
 Arena::Arena() : impl(nullptr) {}
@@ -132,6 +213,67 @@ void Arena::dependsOn(const Arena& p) {
 	}
 }
 
+namespace {
+// Sizes of arenas beyond this are not worth pre-reserving for; they are rare and would hold on to the memory
+constexpr int64_t kMaxArenaSizeHint = 1 << 20;
+
+struct ArenaSizeHints {
+	std::mutex mutex;
+	std::set<ArenaSizeHint*> hints;
+};
+
+ArenaSizeHints& arenaSizeHints() {
+	static ArenaSizeHints* hints = new ArenaSizeHints();
+	return *hints;
+}
+} // namespace
+
+ArenaSizeHint::ArenaSizeHint(const char* site) : site(site), estimate(0), arenas(0), bytes(0), outgrown(0) {
+	std::lock_guard<std::mutex> lock(arenaSizeHints().mutex);
+	arenaSizeHints().hints.insert(this);
+}
+
+ArenaSizeHint::~ArenaSizeHint() {
+	std::lock_guard<std::mutex> lock(arenaSizeHints().mutex);
+	arenaSizeHints().hints.erase(this);
+}
+
+size_t ArenaSizeHint::reserveSize() const {
+	// A block reserved for n bytes also holds its header
+	return std::max<int64_t>(estimate.load(std::memory_order_relaxed) - (int64_t)sizeof(ArenaBlock), 0);
+}
+
+void ArenaSizeHint::record(const Arena& arena) {
+	// Blocks before the most recent one were full when the arena moved on from them
+	int64_t size = arena.getSize(FastInaccurateEstimate::True);
+	if (arena.impl) {
+		allowAccess(arena.impl.getPtr());
+		size -= arena.impl->unused();
+		disallowAccess(arena.impl.getPtr());
+	}
+	int64_t current = estimate.load(std::memory_order_relaxed);
+	arenas.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+	if (size > current) {
+		outgrown.fetch_add(1, std::memory_order_relaxed);
+	}
+	// Racing updates can lose one another, which only delays adapting to the next arena
+	int64_t next = size > current ? size : current - (current - size) / 16;
+	estimate.store(std::min(next, kMaxArenaSizeHint), std::memory_order_relaxed);
+}
+
+void ArenaSizeHint::traceAll() {
+	std::lock_guard<std::mutex> lock(arenaSizeHints().mutex);
+	for (ArenaSizeHint* hint : arenaSizeHints().hints) {
+		TraceEvent("ArenaSizeHint")
+		    .detail("Site", hint->site)
+		    .detail("Arenas", hint->arenas.load())
+		    .detail("Bytes", hint->bytes.load())
+		    .detail("Outgrown", hint->outgrown.load())
+		    .detail("ReserveSize", hint->reserveSize());
+	}
+}
+
 void* Arena::allocate4kAlignedBuffer(uint32_t size) {
 	return ArenaBlock::dependOn4kAlignedBuffer(impl, size);
 }
@@ -386,23 +528,23 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 				b->bigSize = 256;
 				INSTRUMENT_ALLOCATE("Arena256");
 			} else if (reqSize <= 512) {
-				b = (ArenaBlock*)allocateAndMaybeKeepalive(512);
+				b = (ArenaBlock*)allocateArenaBlock(512);
 				b->bigSize = 512;
 				INSTRUMENT_ALLOCATE("Arena512");
 			} else if (reqSize <= 1024) {
-				b = (ArenaBlock*)allocateAndMaybeKeepalive(1024);
+				b = (ArenaBlock*)allocateArenaBlock(1024);
 				b->bigSize = 1024;
 				INSTRUMENT_ALLOCATE("Arena1024");
 			} else if (reqSize <= 2048) {
-				b = (ArenaBlock*)allocateAndMaybeKeepalive(2048);
+				b = (ArenaBlock*)allocateArenaBlock(2048);
 				b->bigSize = 2048;
 				INSTRUMENT_ALLOCATE("Arena2048");
 			} else if (reqSize <= 4096) {
-				b = (ArenaBlock*)allocateAndMaybeKeepalive(4096);
+				b = (ArenaBlock*)allocateArenaBlock(4096);
 				b->bigSize = 4096;
 				INSTRUMENT_ALLOCATE("Arena4096");
 			} else {
-				b = (ArenaBlock*)allocateAndMaybeKeepalive(8192);
+				b = (ArenaBlock*)allocateArenaBlock(8192);
 				b->bigSize = 8192;
 				INSTRUMENT_ALLOCATE("Arena8192");
 			}
@@ -506,19 +648,19 @@ void ArenaBlock::destroyLeaf() {
 			FastAllocator<256>::release(this);
 			INSTRUMENT_RELEASE("Arena256");
 		} else if (bigSize <= 512) {
-			freeOrMaybeKeepalive(this);
+			freeArenaBlock(this, 512);
 			INSTRUMENT_RELEASE("Arena512");
 		} else if (bigSize <= 1024) {
-			freeOrMaybeKeepalive(this);
+			freeArenaBlock(this, 1024);
 			INSTRUMENT_RELEASE("Arena1024");
 		} else if (bigSize <= 2048) {
-			freeOrMaybeKeepalive(this);
+			freeArenaBlock(this, 2048);
 			INSTRUMENT_RELEASE("Arena2048");
 		} else if (bigSize <= 4096) {
-			freeOrMaybeKeepalive(this);
+			freeArenaBlock(this, 4096);
 			INSTRUMENT_RELEASE("Arena4096");
 		} else if (bigSize <= 8192) {
-			freeOrMaybeKeepalive(this);
+			freeArenaBlock(this, 8192);
 			INSTRUMENT_RELEASE("Arena8192");
 		} else {
 #ifdef ALLOC_INSTRUMENTATION
@@ -799,6 +941,37 @@ TEST_CASE("/flow/Arena/Size") {
 	return Void();
 }
 
+TEST_CASE("/flow/Arena/SizeHint") {
+	ArenaSizeHint hint("Test");
+	ASSERT_EQ(hint.reserveSize(), 0);
+
+	Arena a(hint.reserveSize());
+	makeString(300, a);
+	makeString(3000, a);
+	hint.record(a);
+	size_t learnedSize = hint.reserveSize();
+	ASSERT_GE(learnedSize, 3300);
+
+	// An arena with the same contents now fits in the block reserved for it
+	Arena b(hint.reserveSize());
+	size_t reservedSize = b.getSize();
+	makeString(300, b);
+	makeString(3000, b);
+	ASSERT_EQ(b.getSize(), reservedSize);
+	hint.record(b);
+	ASSERT_LE(hint.reserveSize(), learnedSize);
+
+	// Smaller arenas bring the reservation down gradually
+	for (int i = 0; i < 100; i++) {
+		Arena c(hint.reserveSize());
+		makeString(100, c);
+		hint.record(c);
+	}
+	ASSERT_LT(hint.reserveSize(), learnedSize);
+
+	return Void();
+}
+
 // Test that x.dependsOn(x) works, and is effectively a no-op.
 TEST_CASE("/flow/Arena/SelfRef") {
 	Arena a(4096);
@@ -0,0 +1,141 @@
+/*
+ * ComputePool.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flow/ComputePool.h"
+#include "flow/Knobs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ComputeTaskOrder {
+	bool operator()(const ComputeTask* lhs, const ComputeTask* rhs) const {
+		if (lhs->priority != rhs->priority) {
+			return lhs->priority < rhs->priority;
+		}
+		return lhs->sequence > rhs->sequence;
+	}
+};
+
+// Lives for the rest of the process once started; the threads are never joined.
+class ComputePool {
+public:
+	explicit ComputePool(int threadCount) {
+		for (int i = 0; i < threadCount; ++i) {
+			workers.emplace_back(std::make_unique<Worker>());
+		}
+		for (int i = 0; i < threadCount; ++i) {
+			workers[i]->pool = this;
+			workers[i]->index = i;
+			startThread(run, workers[i].get(), 0, "fdb-compute");
+		}
+	}
+
+	void post(ComputeTask* task) {
+		task->sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+		// Spread work posted by the network thread round robin; stealing takes care of uneven task lengths
+		Worker& worker = *workers[task->sequence % workers.size()];
+		{
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.tasks.push(task);
+		}
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			++queued;
+		}
+		wake.notify_one();
+	}
+
+private:
+	struct Worker {
+		ComputePool* pool;
+		int index;
+		std::mutex mutex;
+		std::priority_queue<ComputeTask*, std::vector<ComputeTask*>, ComputeTaskOrder> tasks;
+
+		ComputeTask* pop() {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tasks.empty()) {
+				return nullptr;
+			}
+			ComputeTask* task = tasks.top();
+			tasks.pop();
+			return task;
+		}
+	};
+
+	// Takes the highest priority task from the worker's own queue, or steals one from the next non-empty queue
+	ComputeTask* take(int index) {
+		for (int i = 0; i < workers.size(); ++i) {
+			if (ComputeTask* task = workers[(index + i) % workers.size()]->pop()) {
+				return task;
+			}
+		}
+		return nullptr;
+	}
+
+	THREAD_FUNC run(void* arg) {
+		Worker* self = static_cast<Worker*>(arg);
+		ComputePool* pool = self->pool;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(pool->sleepMutex);
+				pool->wake.wait(lock, [pool] { return pool->queued > 0; });
+				--pool->queued;
+			}
+			// Every unit of queued is matched by a task in some queue, but another worker may have stolen ours
+			// between the two locks, so keep looking until one turns up.
+			ComputeTask* task;
+			while (!(task = pool->take(self->index))) {
+				std::this_thread::yield();
+			}
+			(*task)();
+			delete task;
+		}
+		THREAD_RETURN;
+	}
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<uint64_t> nextSequence = 0;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	int64_t queued = 0; // Protected by sleepMutex
+};
+
+ComputePool* computePool() {
+	static ComputePool* pool = new ComputePool(FLOW_KNOBS->COMPUTE_POOL_THREADS);
+	return pool;
+}
+
+} // namespace
+
+bool postComputeTask(ComputeTask* task) {
+	if (g_network->isSimulated() || FLOW_KNOBS->COMPUTE_POOL_THREADS <= 0) {
+		return false;
+	}
+	computePool()->post(task);
+	return true;
+}
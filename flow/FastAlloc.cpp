@@ -40,7 +40,9 @@
 
 #ifdef __linux__
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <linux/mman.h>
+#include <unistd.h>
 #endif
 
 #ifdef __FreeBSD__
@@ -113,6 +115,7 @@ template <int Size>
 void* FastAllocator<Size>::freelist = nullptr;
 
 std::atomic<int64_t> g_hugeArenaMemory(0);
+std::atomic<int64_t> g_arenaBlockCacheMisses(0);
 
 double hugeArenaLastLogged = 0;
 std::map<std::string, std::pair<int, int64_t>> hugeArenaTraces;
@@ -239,18 +242,38 @@ void recordDeallocation(void* ptr) {
 #endif
 }
 
+// Threads on NUMA nodes beyond this share pools with lower numbered nodes
+static constexpr int kFastAllocMaxNumaNodes = 8;
+
+// Size of the slabs new magazines are carved from when FAST_ALLOC_HUGE_PAGE_SLABS is set
+static constexpr size_t kFastAllocSlabBytes = 2 << 20;
+
+static int currentNumaNode() {
+#ifdef __linux__
+	unsigned cpu = 0, node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+		return node % kFastAllocMaxNumaNodes;
+	}
+#endif
+	return 0;
+}
+
 template <int Size>
 struct FastAllocator<Size>::GlobalData {
-	CRITICAL_SECTION mutex;
-	std::vector<void*> magazines; // These magazines are always exactly magazine_size ("full")
-	std::vector<std::pair<int, void*>>
-	    partial_magazines; // Magazines that are not "full" and their counts.  Only created by releaseThreadMagazines().
+	// Magazines released by the threads of one NUMA node. Memory released on a node is handed out again on the same
+	// node first, keeping it in that node's caches, and threads on different nodes do not contend for the same lock.
+	struct NodePool {
+		CRITICAL_SECTION mutex;
+		std::vector<void*> magazines; // These magazines are always exactly magazine_size ("full")
+		std::vector<std::pair<int, void*>> partial_magazines; // Magazines that are not "full" and their counts. Only
+		                                                      // created by ~ThreadData().
+		long long partialMagazineUnallocatedMemory = 0;
+		NodePool() { InitializeCriticalSection(&mutex); }
+	};
+	NodePool pools[kFastAllocMaxNumaNodes];
 	std::atomic<long long> totalMemory;
-	long long partialMagazineUnallocatedMemory;
 	std::atomic<long long> activeThreads;
-	GlobalData() : totalMemory(0), partialMagazineUnallocatedMemory(0), activeThreads(0) {
-		InitializeCriticalSection(&mutex);
-	}
+	GlobalData() : totalMemory(0), activeThreads(0) {}
 };
 
 template <int Size>
@@ -261,10 +284,12 @@ long long FastAllocator<Size>::getTotalMemory() {
 // This does not include memory held by various threads that's available for allocation
 template <int Size>
 long long FastAllocator<Size>::getApproximateMemoryUnused() {
-	EnterCriticalSection(&globalData()->mutex);
-	long long unused =
-	    globalData()->magazines.size() * magazine_size * Size + globalData()->partialMagazineUnallocatedMemory;
-	LeaveCriticalSection(&globalData()->mutex);
+	long long unused = 0;
+	for (auto& pool : globalData()->pools) {
+		EnterCriticalSection(&pool.mutex);
+		unused += pool.magazines.size() * magazine_size * Size + pool.partialMagazineUnallocatedMemory;
+		LeaveCriticalSection(&pool.mutex);
+	}
 	return unused;
 }
 
@@ -525,6 +550,7 @@ FastAllocator<Size>::ThreadData::ThreadData() {
 	freelist = nullptr;
 	alternate = nullptr;
 	count = 0;
+	node = currentNumaNode();
 }
 
 template <int Size>
@@ -532,25 +558,28 @@ void FastAllocator<Size>::getMagazine() {
 	ThreadData& thr = threadData();
 	ASSERT(!thr.freelist && !thr.alternate && thr.count == 0);
 
-	EnterCriticalSection(&globalData()->mutex);
-	if (globalData()->magazines.size()) {
-		void* m = globalData()->magazines.back();
-		globalData()->magazines.pop_back();
-		LeaveCriticalSection(&globalData()->mutex);
-		thr.freelist = m;
-		thr.count = magazine_size;
-		return;
-	} else if (globalData()->partial_magazines.size()) {
-		std::pair<int, void*> p = globalData()->partial_magazines.back();
-		globalData()->partial_magazines.pop_back();
-		globalData()->partialMagazineUnallocatedMemory -= p.first * Size;
-		LeaveCriticalSection(&globalData()->mutex);
-		thr.freelist = p.second;
-		thr.count = p.first;
-		return;
+	// Prefer memory released on this thread's own NUMA node, then take it from any other node before allocating more
+	for (int i = 0; i < kFastAllocMaxNumaNodes; i++) {
+		auto& pool = globalData()->pools[(thr.node + i) % kFastAllocMaxNumaNodes];
+		EnterCriticalSection(&pool.mutex);
+		if (pool.magazines.size()) {
+			void* m = pool.magazines.back();
+			pool.magazines.pop_back();
+			LeaveCriticalSection(&pool.mutex);
+			thr.freelist = m;
+			thr.count = magazine_size;
+			return;
+		} else if (pool.partial_magazines.size()) {
+			std::pair<int, void*> p = pool.partial_magazines.back();
+			pool.partial_magazines.pop_back();
+			pool.partialMagazineUnallocatedMemory -= p.first * Size;
+			LeaveCriticalSection(&pool.mutex);
+			thr.freelist = p.second;
+			thr.count = p.first;
+			return;
+		}
+		LeaveCriticalSection(&pool.mutex);
 	}
-	globalData()->totalMemory.fetch_add(magazine_size * Size);
-	LeaveCriticalSection(&globalData()->mutex);
 
 // Allocate a new page of data from the system allocator
 #ifdef ALLOC_INSTRUMENTATION
@@ -558,6 +587,7 @@ void FastAllocator<Size>::getMagazine() {
 #endif
 
 	void** block = nullptr;
+	int magazines = 1;
 #if FAST_ALLOCATOR_DEBUG
 #ifdef WIN32
 	static int alt = 0;
@@ -576,9 +606,6 @@ void FastAllocator<Size>::getMagazine() {
 	ASSERT(block == desiredBlock);
 #endif
 #else
-	// FIXME: We should be able to allocate larger magazine sizes here if we
-	// detect that the underlying system supports hugepages.  Using hugepages
-	// with smaller-than-2MiB magazine sizes strands memory.  See issue #909.
 #if !DEBUG_DETERMINISM
 	if (FLOW_KNOBS && g_allocation_tracing_disabled == 0 &&
 	    nondeterministicRandom()->random01() < (magazine_size * Size) / FLOW_KNOBS->FAST_ALLOC_LOGGING_BYTES) {
@@ -592,9 +619,36 @@ void FastAllocator<Size>::getMagazine() {
 #else
 	const bool includeGuardPages = true;
 #endif
-	block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
+	if (FLOW_KNOBS && FLOW_KNOBS->FAST_ALLOC_HUGE_PAGE_SLABS) {
+		// A slab holds many magazines, so that it can be backed by huge pages without stranding most of each page as
+		// a magazine the size of a huge page would. The magazines not handed to this thread go to its node's pool.
+		magazines = std::max<int>(1, kFastAllocSlabBytes / (magazine_size * Size));
+		block = (void**)::allocate(kFastAllocSlabBytes, /*allowLargePages*/ true, /*includeGuardPages*/ false);
+#ifdef __linux__
+		madvise(block, kFastAllocSlabBytes, MADV_HUGEPAGE);
 #endif
+	} else {
+		block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
+	}
+#endif
+	globalData()->totalMemory.fetch_add(magazines * magazine_size * Size);
 
+	if (magazines > 1) {
+		auto& pool = globalData()->pools[thr.node];
+		EnterCriticalSection(&pool.mutex);
+		for (int i = 1; i < magazines; i++) {
+			pool.magazines.push_back(formatMagazine(block + i * magazine_size * PSize));
+		}
+		LeaveCriticalSection(&pool.mutex);
+	}
+
+	thr.freelist = formatMagazine(block);
+	thr.count = magazine_size;
+}
+
+// Links the magazine_size items of block into a freelist, returning its head
+template <int Size>
+void* FastAllocator<Size>::formatMagazine(void** block) {
 	// void** block = new void*[ magazine_size * PSize ];
 	for (int i = 0; i < magazine_size - 1; i++) {
 		block[i * PSize + 1] = block[i * PSize] = &block[(i + 1) * PSize];
@@ -603,28 +657,29 @@ void FastAllocator<Size>::getMagazine() {
 
 	block[(magazine_size - 1) * PSize + 1] = block[(magazine_size - 1) * PSize] = nullptr;
 	check(&block[(magazine_size - 1) * PSize], false);
-	thr.freelist = block;
-	thr.count = magazine_size;
+	return block;
 }
 template <int Size>
 void FastAllocator<Size>::releaseMagazine(void* mag) {
-	EnterCriticalSection(&globalData()->mutex);
-	globalData()->magazines.push_back(mag);
-	LeaveCriticalSection(&globalData()->mutex);
+	auto& pool = globalData()->pools[threadData().node];
+	EnterCriticalSection(&pool.mutex);
+	pool.magazines.push_back(mag);
+	LeaveCriticalSection(&pool.mutex);
 }
 template <int Size>
 FastAllocator<Size>::ThreadData::~ThreadData() {
-	EnterCriticalSection(&globalData()->mutex);
+	auto& pool = globalData()->pools[node];
+	EnterCriticalSection(&pool.mutex);
 	if (freelist) {
 		ASSERT_ABORT(count > 0 && count <= magazine_size);
-		globalData()->partial_magazines.emplace_back(count, freelist);
-		globalData()->partialMagazineUnallocatedMemory += count * Size;
+		pool.partial_magazines.emplace_back(count, freelist);
+		pool.partialMagazineUnallocatedMemory += count * Size;
 	}
 	if (alternate) {
-		globalData()->magazines.push_back(alternate);
+		pool.magazines.push_back(alternate);
 	}
 	globalData()->activeThreads.fetch_add(-1);
-	LeaveCriticalSection(&globalData()->mutex);
+	LeaveCriticalSection(&pool.mutex);
 
 	count = 0;
 	alternate = nullptr;
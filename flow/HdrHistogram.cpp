@@ -0,0 +1,243 @@
+/*
+ * HdrHistogram.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cinttypes>
+#include <cmath>
+
+#include "flow/HdrHistogram.h"
+#include "flow/Error.h"
+#include "flow/IRandom.h"
+#include "flow/UnitTest.h"
+
+HdrHistogram::HdrHistogram(int significantBits) : significantBits(significantBits) {
+	ASSERT(significantBits >= minSignificantBits && significantBits <= maxSignificantBits);
+	counts.resize(bucketCount(significantBits));
+	clear();
+}
+
+int HdrHistogram::significantBitsFor(double relativeAccuracy) {
+	ASSERT(relativeAccuracy > 0 && relativeAccuracy < 1);
+	int bits = static_cast<int>(std::ceil(-std::log2(relativeAccuracy)));
+	return std::clamp(bits, minSignificantBits, maxSignificantBits);
+}
+
+void HdrHistogram::record(uint64_t value, uint32_t count) {
+	if (count == 0) {
+		return;
+	}
+	counts[bucketIndex(value)] += count;
+	totalCount += count;
+	sum += value * count;
+	minValue = std::min(minValue, value);
+	maxValue = std::max(maxValue, value);
+}
+
+void HdrHistogram::merge(const HdrHistogram& other) {
+	if (other.totalCount == 0) {
+		return;
+	}
+	if (other.significantBits == significantBits) {
+		for (int i = 0; i < counts.size(); ++i) {
+			counts[i] += other.counts[i];
+		}
+	} else {
+		for (int i = 0; i < other.counts.size(); ++i) {
+			if (other.counts[i]) {
+				counts[bucketIndex(other.bucketMidpoint(i))] += other.counts[i];
+			}
+		}
+	}
+	totalCount += other.totalCount;
+	sum += other.sum;
+	minValue = std::min(minValue, other.minValue);
+	maxValue = std::max(maxValue, other.maxValue);
+}
+
+void HdrHistogram::clear() {
+	std::fill(counts.begin(), counts.end(), 0);
+	totalCount = 0;
+	sum = 0;
+	minValue = std::numeric_limits<uint64_t>::max();
+	maxValue = 0;
+}
+
+uint64_t HdrHistogram::percentile(double fraction) const {
+	ASSERT(fraction >= 0 && fraction <= 1);
+	if (totalCount == 0) {
+		return 0;
+	}
+	uint64_t rank = std::max<uint64_t>(1, std::ceil(fraction * totalCount));
+	uint64_t seen = 0;
+	for (int i = 0; i < counts.size(); ++i) {
+		seen += counts[i];
+		if (seen >= rank) {
+			return std::clamp(bucketMidpoint(i), minValue, maxValue);
+		}
+	}
+	return maxValue;
+}
+
+// The format is "significantBits;min;max;sum;" followed by a comma separated list of "index:count" for the non-empty
+// buckets, where each index after the first is relative to the previous one.
+std::string HdrHistogram::toString() const {
+	std::string result = format("%d;%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";", significantBits, min(), max(), sum);
+	int previous = 0;
+	for (int i = 0; i < counts.size(); ++i) {
+		if (counts[i]) {
+			if (result.back() != ';') {
+				result += ',';
+			}
+			result += format("%d:%u", i - previous, counts[i]);
+			previous = i;
+		}
+	}
+	return result;
+}
+
+namespace {
+
+// Parses a number followed by the terminator, which may only be missing at the end of the string if lastAllowed
+uint64_t parseUnsigned(StringRef& s, char terminator, bool lastAllowed = false) {
+	uint64_t value = 0;
+	int digits = 0;
+	while (s.size() && s[0] >= '0' && s[0] <= '9') {
+		uint64_t next = value * 10 + (s[0] - '0');
+		if (next / 10 != value) {
+			throw attribute_not_found();
+		}
+		value = next;
+		++digits;
+		s = s.substr(1);
+	}
+	if (digits == 0 || (s.size() && s[0] != terminator) || (s.empty() && !lastAllowed)) {
+		throw attribute_not_found();
+	}
+	if (s.size()) {
+		s = s.substr(1);
+	}
+	return value;
+}
+
+} // namespace
+
+HdrHistogram HdrHistogram::fromString(StringRef encoded) {
+	uint64_t significantBits = parseUnsigned(encoded, ';');
+	if (significantBits < minSignificantBits || significantBits > maxSignificantBits) {
+		throw attribute_not_found();
+	}
+	HdrHistogram h(significantBits);
+	uint64_t minValue = parseUnsigned(encoded, ';');
+	uint64_t maxValue = parseUnsigned(encoded, ';');
+	h.sum = parseUnsigned(encoded, ';');
+	uint64_t index = 0;
+	while (encoded.size()) {
+		index += parseUnsigned(encoded, ':');
+		uint64_t count = parseUnsigned(encoded, ',', true);
+		if (index >= h.counts.size() || count > std::numeric_limits<uint32_t>::max()) {
+			throw attribute_not_found();
+		}
+		h.counts[index] += count;
+		h.totalCount += count;
+	}
+	if (h.totalCount) {
+		h.minValue = minValue;
+		h.maxValue = maxValue;
+	}
+	return h;
+}
+
+TEST_CASE("/flow/HdrHistogram/Buckets") {
+	for (int bits = HdrHistogram::minSignificantBits; bits <= 10; ++bits) {
+		HdrHistogram h(bits);
+		double relativeError = std::ldexp(1.0, -bits);
+		for (int i = 0; i < 2000; ++i) {
+			uint64_t value = deterministicRandom()->randomUInt32();
+			value <<= deterministicRandom()->randomInt(0, 33);
+			if (i < 64) {
+				value = i;
+			} else if (i == 64) {
+				value = std::numeric_limits<uint64_t>::max();
+			}
+			h.clear();
+			h.record(value);
+			int buckets = 0;
+			h.forEachBucket([&](uint64_t lowest, uint64_t highest, uint32_t count) {
+				ASSERT(lowest <= value && value <= highest && count == 1);
+				// Every value in the bucket is within the relative error of its midpoint
+				ASSERT(lowest == highest || static_cast<double>(highest - lowest) < 2 * relativeError * lowest);
+				++buckets;
+			});
+			ASSERT_EQ(buckets, 1);
+		}
+	}
+	ASSERT_EQ(HdrHistogram::significantBitsFor(0.01), 7);
+	ASSERT_EQ(HdrHistogram::significantBitsFor(0.5), 1);
+	return Void();
+}
+
+TEST_CASE("/flow/HdrHistogram/Percentiles") {
+	HdrHistogram h(HdrHistogram::significantBitsFor(0.01));
+	ASSERT_EQ(h.percentile(0.99), 0);
+	for (uint64_t i = 1; i <= 10000; ++i) {
+		h.record(i * 1000);
+	}
+	ASSERT_EQ(h.count(), 10000);
+	ASSERT_EQ(h.min(), 1000);
+	ASSERT_EQ(h.max(), 10000000);
+	ASSERT(std::abs(h.mean() - 5000500.0) < 1);
+	for (double p : { 0.0, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+		double expected = std::max(1.0, std::ceil(p * 10000)) * 1000;
+		ASSERT(std::abs(h.percentile(p) - expected) <= 0.01 * expected);
+	}
+	return Void();
+}
+
+TEST_CASE("/flow/HdrHistogram/Merge") {
+	HdrHistogram a(7), b(7), c(9), all(7);
+	for (int i = 0; i < 3000; ++i) {
+		uint64_t value = deterministicRandom()->randomInt64(0, 1e9);
+		HdrHistogram& h = i % 3 == 0 ? a : i % 3 == 1 ? b : c;
+		h.record(value);
+		all.record(value);
+	}
+
+	HdrHistogram merged = HdrHistogram::fromString(a.toString());
+	merged.merge(HdrHistogram::fromString(b.toString()));
+	merged.merge(c);
+	ASSERT_EQ(merged.count(), all.count());
+	ASSERT_EQ(merged.min(), all.min());
+	ASSERT_EQ(merged.max(), all.max());
+	ASSERT_EQ(merged.getSum(), all.getSum());
+	for (double p : { 0.25, 0.5, 0.9, 0.99 }) {
+		double expected = all.percentile(p);
+		ASSERT(std::abs(merged.percentile(p) - expected) <= 0.02 * expected);
+	}
+
+	ASSERT_EQ(HdrHistogram::fromString(HdrHistogram().toString()).count(), 0);
+	for (const char* bad : { "", "7;", "7;1;2;3;4", "7;1;2;3;4:", "99;0;0;0;", "7;0;0;0;999999:1", "7;0;0;0;1:x" }) {
+		try {
+			HdrHistogram::fromString(StringRef(bad));
+			ASSERT(false);
+		} catch (Error& e) {
+			ASSERT_EQ(e.code(), error_code_attribute_not_found);
+		}
+	}
+	return Void();
+}
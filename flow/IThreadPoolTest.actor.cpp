@@ -21,6 +21,7 @@
 // Thread naming only works on Linux.
 #if defined(__linux__)
 
+#include "flow/ComputePool.h"
 #include "flow/IThreadPool.h"
 
 #include <pthread.h>
@@ -162,6 +163,38 @@ TEST_CASE("/flow/IThreadPool/ThreadReturnPromiseStream") {
 	return Void();
 }
 
+TEST_CASE("/flow/ComputePool/Run") {
+	noUnseed = true;
+
+	state std::vector<Future<int64_t>> sums;
+	for (int i = 0; i < 100; ++i) {
+		sums.push_back(runOnComputePool(
+		    [i]() {
+			    int64_t sum = 0;
+			    for (int j = 0; j <= i * 1000; ++j) {
+				    sum += j;
+			    }
+			    return sum;
+		    },
+		    i % 2 ? TaskPriority::DefaultYield : TaskPriority::Low));
+	}
+	std::vector<int64_t> results = wait(getAll(sums));
+	for (int i = 0; i < results.size(); ++i) {
+		int64_t n = i * 1000;
+		ASSERT_EQ(results[i], n * (n + 1) / 2);
+	}
+
+	state Future<Void> fails = runOnComputePool([]() { throw io_error(); });
+	try {
+		wait(fails);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_io_error);
+	}
+
+	return Void();
+}
+
 #else
 void forceLinkIThreadPoolTests() {}
 #endif
@@ -70,11 +70,16 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SATURATION_PROFILING_LOG_INTERVAL,                   0.5 ); // A value of 0 means use RUN_LOOP_PROFILING_INTERVAL
 	init( SATURATION_PROFILING_MAX_LOG_INTERVAL,               5.0 );
 	init( SATURATION_PROFILING_LOG_BACKOFF,                    2.0 );
+	init( ACTOR_SAMPLER_HZ,                                     19 ); // A value of 0 disables the actor sampler
+	init( ACTOR_SAMPLER_DRAIN_INTERVAL,                        1.0 );
+	init( ACTOR_SAMPLER_MAX_STACKS,                          10000 );
 
 	init( FAST_ALLOC_LOGGING_BYTES,                           10e6 );
 	init( FAST_ALLOC_ALLOW_GUARD_PAGES,                      false );
+	init( FAST_ALLOC_HUGE_PAGE_SLABS,                        false ); // Carve new magazines out of 2MiB slabs which can be backed by huge pages
 	init( HUGE_ARENA_LOGGING_BYTES,                          100e6 );
 	init( HUGE_ARENA_LOGGING_INTERVAL,                         5.0 );
+	init( ARENA_BLOCK_CACHE_BYTES,                          1 << 20 ); if( randomize && BUGGIFY ) ARENA_BLOCK_CACHE_BYTES = deterministicRandom()->coinflip() ? 0 : 8192; // Per thread
 	init( ABORT_ON_FAILURE,                                  false );
 
 	init( MEMORY_USAGE_CHECK_INTERVAL,                         1.0 );
@@ -97,6 +102,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( OTEL_UDP_EMISSION_ADDR,                       "127.0.0.1");
 	init( OTEL_UDP_EMISSION_PORT,                             8903 );
 	init( METRICS_EMIT_DDSKETCH,                             false ); // Determines if DDSketch buckets will get emitted
+	init( LATENCY_SAMPLE_TRACE_HISTOGRAM,                     true ); // Log the buckets of each LatencySample, which status merges across processes
 
 	//connectionMonitor
 	init( CONNECTION_MONITOR_LOOP_TIME,   isSimulated ? 0.75 : 1.0 ); if( randomize && BUGGIFY ) CONNECTION_MONITOR_LOOP_TIME = 6.0;
@@ -132,6 +138,11 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( TLS_HANDSHAKE_THREAD_STACKSIZE,                64 * 1024 );
 	init( TLS_MALLOC_ARENA_MAX,                                  6 );
 	init( TLS_HANDSHAKE_LIMIT,                                1000 );
+	init( TLS_SESSION_RESUMPTION,                             true ); // Reconnections to a TLS server resume the session of an earlier connection
+	init( TLS_SESSION_TIMEOUT,                                3600 );
+	init( TLS_SESSION_CACHE_SIZE,                            10000 ); // Servers to keep a session for
+
+	init( COMPUTE_POOL_THREADS,                                  4 ); // 0 runs runOnComputePool() work inline on the network thread
 
 	init( NETWORK_TEST_CLIENT_COUNT,                            30 );
 	init( NETWORK_TEST_REPLY_SIZE,                           600e3 );
@@ -210,6 +221,10 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	//Net2 and FlowTransport
 	init( MIN_COALESCE_DELAY,                                10e-6 ); if( randomize && BUGGIFY ) MIN_COALESCE_DELAY = 0;
 	init( MAX_COALESCE_DELAY,                                20e-6 ); if( randomize && BUGGIFY ) MAX_COALESCE_DELAY = 0;
+	init( MAX_ADAPTIVE_COALESCE_DELAY,                       50e-6 ); if( randomize && BUGGIFY ) MAX_ADAPTIVE_COALESCE_DELAY = deterministicRandom()->coinflip() ? 0 : 500e-6; // 0 disables adaptive coalescing
+	init( COALESCE_TARGET_PACKETS,                               8 ); // Packets a busy peer tries to batch into each write
+	init( COALESCE_MIN_PACKETS,                                  2 ); // Don't delay writes to a peer which wouldn't batch this many packets in MAX_ADAPTIVE_COALESCE_DELAY
+	init( COALESCE_RATE_WINDOW,                               0.01 ); // Time over which the packet rate to a peer is smoothed
 	init( SLOW_LOOP_CUTOFF,                          15.0 / 1000.0 );
 	init( SLOW_LOOP_SAMPLING_RATE,                             0.1 );
 	init( TSC_YIELD_TIME,                                  1000000 );
@@ -228,6 +243,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( FLOW_TCP_NODELAY,                                      1 );
 	init( FLOW_TCP_QUICKACK,                                     0 );
 	init( RESOLVE_PREFER_IPV4_ADDR,                          false );  // Default to prefer IPv6 addresses. Set to true to prefer IPv4 addresses.
+	init( PEER_CONNECTION_LANES,                                 1 ); // Connections per server pair; only set above 1 once every process understands lanes
+	init( BULK_ENDPOINT_PRIORITY,                             4000 ); // Endpoints with a lower priority have their packets sent over the bulk lanes
 
 	//Sim2
 	init( MIN_OPEN_TIME,                                    0.0002 );
@@ -250,6 +267,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( MAX_TRACE_SUPPRESSIONS,                              1e4 );
 	init( TRACE_DATETIME_ENABLED,                             true ); // trace time in human readable format (always real time)
 	init( TRACE_SYNC_ENABLED,                                    0 );
+	init( TRACE_WRITE_BATCH_BYTES,                         1 << 16 ); // Formatted events are written to the trace file in batches of about this size
 	init( TRACE_EVENT_METRIC_UNITS_PER_SAMPLE,                 500 );
 	init( TRACE_EVENT_THROTTLER_SAMPLE_EXPIRY,              1800.0 ); // 30 mins
 	init( TRACE_EVENT_THROTTLER_MSG_LIMIT,                   20000 );
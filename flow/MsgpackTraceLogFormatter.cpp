@@ -0,0 +1,158 @@
+/*
+ * MsgpackTraceLogFormatter.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flow/flow.h"
+#include "flow/MsgpackTraceLogFormatter.h"
+#include "flow/UnitTest.h"
+
+MsgpackTraceLogFormatter::MsgpackTraceLogFormatter() {
+	buffer.buffer_size = 8192;
+	buffer.buffer = std::make_unique<uint8_t[]>(buffer.buffer_size);
+	buffer.data_size = 0;
+}
+
+void MsgpackTraceLogFormatter::addref() {
+	ReferenceCounted<MsgpackTraceLogFormatter>::addref();
+}
+
+void MsgpackTraceLogFormatter::delref() {
+	ReferenceCounted<MsgpackTraceLogFormatter>::delref();
+}
+
+const char* MsgpackTraceLogFormatter::getExtension() const {
+	return "msgpack";
+}
+
+const char* MsgpackTraceLogFormatter::getHeader() const {
+	return "";
+}
+
+const char* MsgpackTraceLogFormatter::getFooter() const {
+	return "";
+}
+
+std::string MsgpackTraceLogFormatter::formatEvent(const TraceEventFields& fields) const {
+	buffer.reset();
+	serialize_map_header(fields.size(), buffer);
+	for (const auto& [key, value] : fields) {
+		serialize_string(key, buffer);
+		serialize_string(value, buffer);
+	}
+	return std::string(reinterpret_cast<const char*>(buffer.buffer.get()), buffer.data_size);
+}
+
+namespace {
+
+uint32_t decodeBigEndian(StringRef& data, int bytes) {
+	if (data.size() < bytes) {
+		throw file_corrupt();
+	}
+	uint32_t value = 0;
+	for (int i = 0; i < bytes; ++i) {
+		value = (value << 8) | data[i];
+	}
+	data = data.substr(bytes);
+	return value;
+}
+
+std::string decodeString(StringRef& data) {
+	uint8_t type = decodeBigEndian(data, 1);
+	uint32_t length;
+	if ((type & 0b11100000) == 0b10100000) {
+		length = type & 0b00011111;
+	} else if (type == 0xd9) {
+		length = decodeBigEndian(data, 1);
+	} else if (type == 0xda) {
+		length = decodeBigEndian(data, 2);
+	} else if (type == 0xdb) {
+		length = decodeBigEndian(data, 4);
+	} else {
+		throw file_corrupt();
+	}
+	if (data.size() < length) {
+		throw file_corrupt();
+	}
+	std::string s = data.substr(0, length).toString();
+	data = data.substr(length);
+	return s;
+}
+
+} // namespace
+
+bool decodeMsgpackTraceEvent(StringRef& data, TraceEventFields& fields) {
+	if (data.empty()) {
+		return false;
+	}
+	uint8_t type = decodeBigEndian(data, 1);
+	uint32_t size;
+	if ((type & 0b11110000) == 0b10000000) {
+		size = type & 0b00001111;
+	} else if (type == 0xde) {
+		size = decodeBigEndian(data, 2);
+	} else if (type == 0xdf) {
+		size = decodeBigEndian(data, 4);
+	} else {
+		throw file_corrupt();
+	}
+	fields = TraceEventFields();
+	for (uint32_t i = 0; i < size; ++i) {
+		std::string key = decodeString(data);
+		fields.addField(std::move(key), decodeString(data));
+	}
+	return true;
+}
+
+TEST_CASE("/flow/Trace/MsgpackFormatter") {
+	MsgpackTraceLogFormatter formatter;
+	std::vector<TraceEventFields> events(3);
+	events[0].addField("Type", "Short");
+	for (int i = 0; i < 40; ++i) {
+		events[1].addField(format("Field%d", i), std::string(i * 10, 'x'));
+	}
+	events[2].addField("Long", std::string(100000, 'y'));
+	events[2].addField("Empty", "");
+	events[2].addField("Binary", std::string("\0\r\n\"<>&", 7));
+
+	std::string file;
+	for (const auto& event : events) {
+		file += formatter.formatEvent(event);
+	}
+	StringRef data(file);
+	TraceEventFields decoded;
+	for (const auto& event : events) {
+		ASSERT(decodeMsgpackTraceEvent(data, decoded));
+		ASSERT(decoded.size() == event.size());
+		for (int i = 0; i < event.size(); ++i) {
+			ASSERT(decoded[i] == event[i]);
+		}
+	}
+	ASSERT(!decodeMsgpackTraceEvent(data, decoded));
+
+	StringRef truncated = StringRef(file).substr(0, file.size() - 1);
+	try {
+		while (decodeMsgpackTraceEvent(truncated, decoded)) {
+		}
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_file_corrupt);
+	}
+
+	return Void();
+}
@@ -28,7 +28,9 @@
 #include "flow/swift_concurrency_hooks.h"
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <unordered_map>
 #ifndef BOOST_SYSTEM_NO_LIB
 #define BOOST_SYSTEM_NO_LIB
 #endif
@@ -123,6 +125,53 @@ class Connection;
 // Outlives main
 Net2* g_net2 = nullptr;
 
+// The sessions of recent client connections to each TLS server, so that reconnecting to it can resume the session
+// rather than repeat the public key operations of a full handshake. Sessions are added by OpenSSL's new session
+// callback, which can run on an SSL handshaker thread.
+class TLSSessionCache : NonCopyable {
+public:
+	TLSSessionCache() = default;
+	~TLSSessionCache() { clear(); }
+
+	// Returns a new reference to the session for addr, or nullptr if there isn't one
+	SSL_SESSION* get(NetworkAddress const& addr) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = sessions.find(addr);
+		if (it == sessions.end()) {
+			return nullptr;
+		}
+		SSL_SESSION_up_ref(it->second);
+		return it->second;
+	}
+
+	// Takes ownership of the reference to session
+	void set(NetworkAddress const& addr, SSL_SESSION* session) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto [it, inserted] = sessions.try_emplace(addr, session);
+		if (!inserted) {
+			SSL_SESSION_free(it->second);
+			it->second = session;
+		} else if (sessions.size() > FLOW_KNOBS->TLS_SESSION_CACHE_SIZE) {
+			auto evicted = sessions.begin() != it ? sessions.begin() : std::next(sessions.begin());
+			SSL_SESSION_free(evicted->second);
+			sessions.erase(evicted);
+		}
+	}
+
+	// Sessions can only be resumed with the context which created them
+	void clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& [addr, session] : sessions) {
+			SSL_SESSION_free(session);
+		}
+		sessions.clear();
+	}
+
+private:
+	std::mutex mutex;
+	std::unordered_map<NetworkAddress, SSL_SESSION*> sessions;
+};
+
 thread_local INetwork* thread_network = nullptr;
 
 class Net2 final : public INetwork, public INetworkConnections {
@@ -227,6 +276,7 @@ public:
 
 	ASIOReactor reactor;
 	AsyncVar<Reference<ReferencedObject<boost::asio::ssl::context>>> sslContextVar;
+	TLSSessionCache tlsSessions;
 	Reference<IThreadPool> sslHandshakerPool;
 	int sslHandshakerThreadsStarted;
 	int sslPoolHandshakesInProgress;
@@ -316,6 +366,10 @@ public:
 	Int64MetricHandle countASIOEvents;
 	Int64MetricHandle countRunLoopProfilingSignals;
 	Int64MetricHandle countTLSPolicyFailures;
+	Int64MetricHandle countTLSHandshakes;
+	Int64MetricHandle countTLSResumedHandshakes;
+	Int64MetricHandle tlsBytesEncrypted;
+	Int64MetricHandle tlsBytesDecrypted;
 	Int64MetricHandle priorityMetric;
 	DoubleMetricHandle countLaunchTime;
 	DoubleMetricHandle countReactTime;
@@ -949,6 +1003,7 @@ public:
 				self->ssl_sock.async_handshake(boost::asio::ssl::stream_base::server, std::move(p));
 			}
 			wait(onHandshook);
+			self->onHandshakeDone();
 			wait(delay(0, TaskPriority::Handshake));
 			connected.send(Void());
 		} catch (...) {
@@ -1013,6 +1068,14 @@ public:
 
 		try {
 			Future<Void> onHandshook;
+			SSL* ssl = self->ssl_sock.native_handle();
+			SSL_set_ex_data(ssl, connectionIndex(), self.getPtr());
+			if (FLOW_KNOBS->TLS_SESSION_RESUMPTION) {
+				if (SSL_SESSION* session = N2::g_net2->tlsSessions.get(self->peer_address)) {
+					SSL_set_session(ssl, session);
+					SSL_SESSION_free(session);
+				}
+			}
 			ConfigureSSLStream(N2::g_net2->activeTlsPolicy, self->ssl_sock, [conn = self.getPtr()](bool verifyOk) {
 				conn->has_trusted_peer = verifyOk;
 			});
@@ -1032,6 +1095,7 @@ public:
 				self->ssl_sock.async_handshake(boost::asio::ssl::stream_base::client, std::move(p));
 			}
 			wait(onHandshook);
+			self->onHandshakeDone();
 			wait(delay(0, TaskPriority::Handshake));
 			connected.send(Void());
 		} catch (...) {
@@ -1100,6 +1164,7 @@ public:
 		size_t toRead = end - begin;
 		size_t size = ssl_sock.read_some(boost::asio::mutable_buffers_1(begin, toRead), err);
 		g_net2->bytesReceived += size;
+		g_net2->tlsBytesDecrypted += size;
 		//TraceEvent("ConnRead", this->id).detail("Bytes", size);
 		if (err) {
 			if (err == boost::asio::error::would_block) {
@@ -1150,6 +1215,7 @@ public:
 
 		ASSERT(sent); // Make sure data was sent, and also this check will fail if the buffer chain was empty or the
 		              // limit was not > 0.
+		g_net2->tlsBytesEncrypted += sent;
 		return sent;
 	}
 
@@ -1163,6 +1229,16 @@ public:
 
 	ssl_socket& getSSLSocket() { return ssl_sock; }
 
+	// OpenSSL's new session callback, which keeps the sessions of client connections in the TLSSessionCache
+	static int onNewSession(SSL* ssl, SSL_SESSION* session) {
+		auto conn = static_cast<SSLConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+		if (SSL_is_server(ssl) || !conn || !FLOW_KNOBS->TLS_SESSION_RESUMPTION) {
+			return 0;
+		}
+		N2::g_net2->tlsSessions.set(conn->peer_address, session);
+		return 1;
+	}
+
 private:
 	UID id;
 	tcp::socket socket;
@@ -1171,6 +1247,29 @@ private:
 	Reference<ReferencedObject<boost::asio::ssl::context>> sslContext;
 	bool has_trusted_peer;
 
+	// The index of the SSL ex_data which points to the SSLConnection of a client connection
+	static int connectionIndex() {
+		static int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+		return index;
+	}
+
+	void onHandshakeDone() {
+		SSL* ssl = ssl_sock.native_handle();
+		++g_net2->countTLSHandshakes;
+		if (SSL_session_reused(ssl)) {
+			++g_net2->countTLSResumedHandshakes;
+			// The verify callback only runs in a full handshake. The peer certificate of a resumed session was verified
+			// by the handshake which created the session, and a session can only be resumed with the same context.
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			X509* cert = SSL_get1_peer_certificate(ssl);
+#else
+			X509* cert = SSL_get_peer_certificate(ssl);
+#endif
+			has_trusted_peer = cert != nullptr;
+			X509_free(cert);
+		}
+	}
+
 	void init() {
 		// Socket settings that have to be set after connect or accept succeeds
 		socket.non_blocking(true);
@@ -1205,6 +1304,17 @@ private:
 	}
 };
 
+// Servers resume sessions from stateless session tickets, and clients keep the tickets they get in the TLSSessionCache
+static void ConfigureTLSSessions(boost::asio::ssl::context& context) {
+	SSL_CTX* ctx = context.native_handle();
+	// Servers which verify client certificates refuse to resume sessions without a session id context
+	static const unsigned char sessionIdContext[] = "fdb";
+	SSL_CTX_set_session_id_context(ctx, sessionIdContext, sizeof(sessionIdContext) - 1);
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(ctx, SSLConnection::onNewSession);
+	SSL_CTX_set_timeout(ctx, FLOW_KNOBS->TLS_SESSION_TIMEOUT);
+}
+
 class SSLListener final : public IListener, ReferenceCounted<SSLListener> {
 	boost::asio::io_context& io_service;
 	NetworkAddress listenAddress;
@@ -1296,6 +1406,7 @@ ACTOR static Future<Void> reloadCertificatesOnChange(
     TLSConfig config,
     std::function<void()> onPolicyFailure,
     AsyncVar<Reference<ReferencedObject<boost::asio::ssl::context>>>* contextVar,
+    TLSSessionCache* sessions,
     Reference<TLSPolicy>* policy) {
 	if (FLOW_KNOBS->TLS_CERT_REFRESH_DELAY_SECONDS <= 0) {
 		return Void();
@@ -1325,10 +1436,12 @@ ACTOR static Future<Void> reloadCertificatesOnChange(
 			LoadedTLSConfig loaded = wait(config.loadAsync());
 			boost::asio::ssl::context context(boost::asio::ssl::context::tls);
 			ConfigureSSLContext(loaded, context);
+			ConfigureTLSSessions(context);
 			*policy = makeReference<TLSPolicy>(loaded, onPolicyFailure);
 			TraceEvent(SevInfo, "TLSCertificateRefreshSucceeded").log();
 			mismatches = 0;
 			contextVar->set(ReferencedObject<boost::asio::ssl::context>::from(std::move(context)));
+			sessions->clear();
 		} catch (Error& e) {
 			if (e.code() == error_code_actor_cancelled) {
 				throw;
@@ -1360,13 +1473,14 @@ void Net2::initTLS(ETLSInitState targetState) {
 			    .detail("DisablePlainTextConnection", tlsConfig.getDisablePlainTextConnection());
 			auto loadedTlsConfig = tlsConfig.loadSync();
 			ConfigureSSLContext(loadedTlsConfig, newContext);
+			ConfigureTLSSessions(newContext);
 			activeTlsPolicy = makeReference<TLSPolicy>(loadedTlsConfig, onPolicyFailure);
 			sslContextVar.set(ReferencedObject<boost::asio::ssl::context>::from(std::move(newContext)));
 		} catch (Error& e) {
 			TraceEvent("Net2TLSInitError").error(e);
 		}
 		backgroundCertRefresh =
-		    reloadCertificatesOnChange(tlsConfig, onPolicyFailure, &sslContextVar, &activeTlsPolicy);
+		    reloadCertificatesOnChange(tlsConfig, onPolicyFailure, &sslContextVar, &tlsSessions, &activeTlsPolicy);
 	}
 
 	// If a TLS connection is actually going to be used then start background threads if configured
@@ -1433,6 +1547,10 @@ void Net2::initMetrics() {
 	countYieldCallsTrue.init("Net2.CountYieldCallsTrue"_sr);
 	countRunLoopProfilingSignals.init("Net2.CountRunLoopProfilingSignals"_sr);
 	countTLSPolicyFailures.init("Net2.CountTLSPolicyFailures"_sr);
+	countTLSHandshakes.init("Net2.CountTLSHandshakes"_sr);
+	countTLSResumedHandshakes.init("Net2.CountTLSResumedHandshakes"_sr);
+	tlsBytesEncrypted.init("Net2.TLSBytesEncrypted"_sr);
+	tlsBytesDecrypted.init("Net2.TLSBytesDecrypted"_sr);
 	priorityMetric.init("Net2.Priority"_sr);
 	awakeMetric.init("Net2.Awake"_sr);
 	slowTaskMetric.init("Net2.SlowTask"_sr);
@@ -3997,12 +3997,16 @@ void fdb_probe_actor_destroy(const char* name, unsigned long id) {
 }
 void fdb_probe_actor_enter(const char* name, unsigned long id, int index) {
 	FDB_TRACE_PROBE(actor_enter, name, id, index);
+	pushActorName(name);
 }
 void fdb_probe_actor_exit(const char* name, unsigned long id, int index) {
+	popActorName();
 	FDB_TRACE_PROBE(actor_exit, name, id, index);
 }
 #endif
 
+thread_local ActorNameStack g_actorNameStack;
+
 void throwExecPathError(Error e, char path[]) {
 	Severity sev = e.code() == error_code_io_error ? SevError : SevWarnAlways;
 	TraceEvent(sev, "GetPathError").error(e).detail("Path", path);
@@ -182,6 +182,16 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .detail("TLSPolicyFailures",
 			            (netData.countTLSPolicyFailures - statState->networkState.countTLSPolicyFailures) /
 			                currentStats.elapsed)
+			    .detail("TLSHandshakes",
+			            (netData.countTLSHandshakes - statState->networkState.countTLSHandshakes) /
+			                currentStats.elapsed)
+			    .detail("TLSResumedHandshakes",
+			            (netData.countTLSResumedHandshakes - statState->networkState.countTLSResumedHandshakes) /
+			                currentStats.elapsed)
+			    .detail("TLSBytesEncrypted",
+			            (netData.tlsBytesEncrypted - statState->networkState.tlsBytesEncrypted) / currentStats.elapsed)
+			    .detail("TLSBytesDecrypted",
+			            (netData.tlsBytesDecrypted - statState->networkState.tlsBytesDecrypted) / currentStats.elapsed)
 			    .trackLatest(eventName);
 
 			TraceEvent("MemoryMetrics")
@@ -198,6 +208,7 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .DETAILALLOCATORMEMUSAGE(8192)
 			    .DETAILALLOCATORMEMUSAGE(16384)
 			    .detail("HugeArenaMemory", g_hugeArenaMemory.load())
+			    .detail("ArenaBlockCacheMisses", g_arenaBlockCacheMisses.load())
 			    .detail("DCID", machineState.dcId)
 			    .detail("ZoneID", machineState.zoneId)
 			    .detail("MachineID", machineState.machineId);
@@ -236,6 +247,7 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 				    .detail("UnusedMemory", unused_memory)
 				    .detail("Utilization", format("%f%%", (total_memory - unused_memory) * 100.0 / total_memory));
 			}
+			ArenaSizeHint::traceAll();
 
 			TraceEvent n("NetworkMetrics");
 			n.detail("Elapsed", currentStats.elapsed)
@@ -24,6 +24,7 @@
 #include "flow/Knobs.h"
 #include "flow/XmlTraceLogFormatter.h"
 #include "flow/JsonTraceLogFormatter.h"
+#include "flow/MsgpackTraceLogFormatter.h"
 #include "flow/flow.h"
 #include "flow/DeterministicRandom.h"
 #include "flow/ProcessEvents.h"
@@ -260,13 +261,22 @@ public:
 		struct WriteBuffer final : TypedAction<WriterThread, WriteBuffer> {
 			std::vector<TraceEventFields> events;
 
-			WriteBuffer(std::vector<TraceEventFields> events) : events(events) {}
+			WriteBuffer(std::vector<TraceEventFields> events) : events(std::move(events)) {}
 			double getTimeEstimate() const override { return .001; }
 		};
 		void action(WriteBuffer& a) {
+			// Batch formatted events into large writes rather than making a system call for each one
+			std::string batch;
 			for (const auto& event : a.events) {
 				event.validateFormat();
-				logWriter->write(formatter->formatEvent(event));
+				batch += formatter->formatEvent(event);
+				if (batch.size() >= FLOW_KNOBS->TRACE_WRITE_BATCH_BYTES) {
+					logWriter->write(batch);
+					batch.clear();
+				}
+			}
+			if (!batch.empty()) {
+				logWriter->write(batch);
 			}
 
 			if (FLOW_KNOBS->TRACE_SYNC_ENABLED) {
@@ -403,7 +413,6 @@ public:
 
 		// FIXME: What if we are using way too much memory for buffer?
 		ASSERT(!isOpen() || fields.isAnnotated());
-		eventBuffer.push_back(fields);
 		bufferLength += fields.sizeBytes();
 
 		if (g_network && g_network->isSimulated()) {
@@ -430,6 +439,7 @@ public:
 		if (!trackLatestKey.empty()) {
 			latestEventCache.set(trackLatestKey, fields);
 		}
+		eventBuffer.push_back(std::move(fields));
 	}
 
 	void logMetrics(int severity, const char* name, UID id, uint64_t event_ts) {
@@ -693,6 +703,11 @@ bool traceFormatImpl(std::string& format) {
 			g_traceLog.formatter = Reference<ITraceLogFormatter>(new JsonTraceLogFormatter());
 		}
 		return true;
+	} else if (format == "msgpack") {
+		if (!validate) {
+			g_traceLog.formatter = Reference<ITraceLogFormatter>(new MsgpackTraceLogFormatter());
+		}
+		return true;
 	} else {
 		if (!validate) {
 			g_traceLog.formatter = Reference<ITraceLogFormatter>(new XmlTraceLogFormatter());
@@ -1517,21 +1532,21 @@ void TraceBatch::dump() {
 		if (g_network->isSimulated()) {
 			attachBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(attachBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(attachBatch[i].fields), "", false);
 	}
 
 	for (int i = 0; i < eventBatch.size(); i++) {
 		if (g_network->isSimulated()) {
 			eventBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(eventBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(eventBatch[i].fields), "", false);
 	}
 
 	for (int i = 0; i < buggifyBatch.size(); i++) {
 		if (g_network->isSimulated()) {
 			buggifyBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(buggifyBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(buggifyBatch[i].fields), "", false);
 	}
 
 	onMainThreadVoid([]() { g_traceLog.flush(); });
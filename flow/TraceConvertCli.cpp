@@ -0,0 +1,148 @@
+/*
+ * TraceConvertCli.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+#include "flow/Arena.h"
+#include "flow/Error.h"
+#include "flow/JsonTraceLogFormatter.h"
+#include "flow/MsgpackTraceLogFormatter.h"
+#include "flow/network.h"
+#include "flow/Platform.h"
+#include "SimpleOpt/SimpleOpt.h"
+#include "flow/TLSConfig.actor.h"
+#include "flow/Trace.h"
+#include "flow/XmlTraceLogFormatter.h"
+
+enum ETraceConvertOpt : int {
+	OPT_HELP,
+	OPT_FORMAT,
+	OPT_OUTPUT,
+};
+
+CSimpleOpt::SOption gOptions[] = { { OPT_HELP, "--help", SO_NONE },
+	                               { OPT_HELP, "-h", SO_NONE },
+	                               { OPT_FORMAT, "--format", SO_REQ_SEP },
+	                               { OPT_FORMAT, "-f", SO_REQ_SEP },
+	                               { OPT_OUTPUT, "--output", SO_REQ_SEP },
+	                               { OPT_OUTPUT, "-o", SO_REQ_SEP },
+	                               SO_END_OF_OPTIONS };
+
+void printUsage(std::string_view binary) {
+	fmt::print(stdout,
+	           "traceconvert: converts trace logs written with --trace-format msgpack to xml or json\n\n"
+	           "Usage: {} [OPTIONS...] FILE...\n\n"
+	           "  --format FORMAT, -f FORMAT (default: xml)\n"
+	           "                Format to convert to, either xml or json.\n\n"
+	           "  --output PATH, -o PATH (default: standard output)\n"
+	           "                File to write the events of all the input files to, in order.\n\n"
+	           "  --help, -h\n"
+	           "                Print this help message.\n",
+	           binary);
+}
+
+int main(int argc, char** argv) {
+	std::string format = "xml";
+	std::string outputFile;
+	auto args = CSimpleOpt(argc, argv, gOptions, SO_O_EXACT);
+	while (args.Next()) {
+		if (auto err = args.LastError()) {
+			fmt::print(stderr, "ERROR: invalid option '{}'\n", args.OptionText());
+			return FDB_EXIT_ERROR;
+		}
+		switch (args.OptionId()) {
+		case OPT_HELP:
+			printUsage(argv[0]);
+			return FDB_EXIT_SUCCESS;
+		case OPT_FORMAT:
+			format = args.OptionArg();
+			break;
+		case OPT_OUTPUT:
+			outputFile = args.OptionArg();
+			break;
+		default:
+			fmt::print(stderr, "ERROR: Unknown option {}\n", args.OptionText());
+			return FDB_EXIT_ERROR;
+		}
+	}
+	if (args.FileCount() == 0) {
+		printUsage(argv[0]);
+		return FDB_EXIT_ERROR;
+	}
+
+	Reference<ITraceLogFormatter> formatter;
+	if (format == "xml") {
+		formatter = makeReference<XmlTraceLogFormatter>();
+	} else if (format == "json") {
+		formatter = makeReference<JsonTraceLogFormatter>();
+	} else {
+		fmt::print(stderr, "ERROR: Unknown format '{}'; use xml or json\n", format);
+		return FDB_EXIT_ERROR;
+	}
+
+	FILE* out = stdout;
+	if (!outputFile.empty() && !(out = fopen(outputFile.c_str(), "wb"))) {
+		fmt::print(stderr, "ERROR: Could not open '{}' for writing\n", outputFile);
+		return FDB_EXIT_ERROR;
+	}
+
+	// Formatters may log through TraceEvent, which needs flow
+	platformInit();
+	Error::init();
+	g_network = newNet2(TLSConfig());
+
+	fputs(formatter->getHeader(), out);
+	for (int i = 0; i < args.FileCount(); ++i) {
+		std::ifstream in(args.File(i), std::ios::binary);
+		if (!in) {
+			fmt::print(stderr, "ERROR: Could not open '{}'\n", args.File(i));
+			return FDB_EXIT_ERROR;
+		}
+		std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		StringRef data(contents);
+		TraceEventFields fields;
+		int events = 0;
+		try {
+			while (decodeMsgpackTraceEvent(data, fields)) {
+				fputs(formatter->formatEvent(fields).c_str(), out);
+				++events;
+			}
+		} catch (Error& e) {
+			// The last event of a file that is still being written may be incomplete
+			fmt::print(stderr,
+			           "WARNING: '{}' is corrupt after {} events and {} bytes\n",
+			           args.File(i),
+			           events,
+			           contents.size() - data.size());
+		}
+	}
+	fputs(formatter->getFooter(), out);
+
+	if (out != stdout && fclose(out) != 0) {
+		fmt::print(stderr, "ERROR: Could not write '{}'\n", outputFile);
+		return FDB_EXIT_ERROR;
+	}
+	return FDB_EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/*
+ * ActorSampler.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_ACTORSAMPLER_H
+#define FLOW_ACTORSAMPLER_H
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "flow/flow.h"
+
+// The actor sampler is a low frequency, always-on CPU profiler for the network thread. A timer on the thread's CPU
+// clock interrupts it ACTOR_SAMPLER_HZ times per second, and the signal handler records the priority of the running
+// task and the names of the actors on g_actorNameStack. The samples are folded into stacks in the format flame graph
+// tools read, so where a process spends its time can be seen without attaching a profiler or restarting it.
+
+struct ActorSamplerProfile {
+	// "Priority<N>;<outermost actor>;...;<innermost actor>" -> number of samples
+	std::map<std::string, int64_t> stacks;
+	int64_t samples = 0;
+	int64_t dropped = 0; // Samples lost because they weren't folded before the buffer filled up
+	double start = 0; // now() when collection started or was last reset
+};
+
+// Samples the calling thread, which must be the network thread, until the returned future is cancelled. Does nothing
+// in simulation, off Linux, or when ACTOR_SAMPLER_HZ is 0.
+Future<Void> runActorSampler();
+
+// Returns everything sampled since the last reset, and starts over if reset is set
+ActorSamplerProfile getActorSamplerProfile(bool reset);
+
+// Records a sample of the calling thread the same way the signal handler does. Exposed for tests.
+void sampleActors();
+
+#endif
@@ -135,9 +135,34 @@ public:
 	bool sameArena(const Arena& other) const { return impl.getPtr() == other.impl.getPtr(); }
 
 private:
+	friend class ArenaSizeHint;
 	Reference<struct ArenaBlock> impl;
 };
 
+// Learns the size that arenas created at one call site end up with, so that later arenas there can reserve it up front
+// instead of growing through a chain of ever larger blocks. Declare one as a function-level static per site, create the
+// site's arenas with Arena(hint.reserveSize()) and record() each arena once it holds everything it will. Every hint
+// traces its counters in an ArenaSizeHint event with the process's memory metrics.
+class ArenaSizeHint : NonCopyable {
+public:
+	explicit ArenaSizeHint(const char* site);
+	~ArenaSizeHint();
+
+	// The size to reserve for the next arena, which follows the space used by recent arenas quickly on the way up and
+	// slowly on the way down so that most arenas fit in their first block. 0 until the first arena has been recorded.
+	size_t reserveSize() const;
+	void record(const Arena& arena);
+
+	static void traceAll();
+
+private:
+	const char* site;
+	std::atomic<int64_t> estimate; // Space used by recent arenas, including block headers
+	std::atomic<int64_t> arenas; // Arenas recorded
+	std::atomic<int64_t> bytes; // Total space used by the recorded arenas
+	std::atomic<int64_t> outgrown; // Recorded arenas which used more than the reservation at the time
+};
+
 template <>
 struct scalar_traits<Arena> : std::true_type {
 	constexpr static size_t size = 0;
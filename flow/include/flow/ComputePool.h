@@ -0,0 +1,95 @@
+/*
+ * ComputePool.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_COMPUTEPOOL_H
+#define FLOW_COMPUTEPOOL_H
+#pragma once
+
+#include <type_traits>
+
+#include "flow/flow.h"
+#include "flow/IThreadPool.h"
+
+// The compute pool is a process-wide set of threads for CPU-bound work that doesn't touch network state, such as
+// encryption, compression and decoding files. Unlike an IThreadPool there is no receiver to write: any callable can be
+// passed to runOnComputePool(). Each pool thread has its own queue, and idle threads steal from the others, so a burst
+// of work posted by the network thread spreads over all of them.
+
+struct ComputeTask {
+	explicit ComputeTask(TaskPriority priority) : priority(priority) {}
+	virtual ~ComputeTask() {}
+	virtual void operator()() = 0; // Runs on a pool thread, which deletes the task afterwards
+
+	TaskPriority priority;
+	uint64_t sequence = 0; // Breaks ties between tasks of the same priority in FIFO order
+};
+
+// Returns false, and leaves task with the caller, if work should run inline instead
+bool postComputeTask(ComputeTask* task);
+
+template <class T, class F>
+class TypedComputeTask final : public ComputeTask {
+public:
+	TypedComputeTask(F&& f, TaskPriority priority) : ComputeTask(priority), f(std::forward<F>(f)) {}
+
+	void operator()() override {
+		try {
+			if constexpr (std::is_void_v<std::invoke_result_t<F&>>) {
+				f();
+				result.send(Void());
+			} else {
+				result.send(f());
+			}
+		} catch (Error& e) {
+			result.sendError(e);
+		} catch (...) {
+			result.sendError(unknown_error());
+		}
+	}
+
+	ThreadReturnPromise<T> result;
+
+private:
+	std::decay_t<F> f;
+};
+
+// Must be called on the network thread. f() runs on a pool thread and its result (or the Error it throws) is
+// delivered back to the network thread. f must not use flow primitives (futures, actors, g_network) or anything the
+// network thread may be changing concurrently, so capture inputs by value: Standalone<>, Arena, and
+// ThreadSafeReferenceCounted types are safe to share. Queued work with a higher priority runs first.
+//
+// In simulation, or when COMPUTE_POOL_THREADS is 0, f() runs inline so that execution stays deterministic.
+template <class F>
+auto runOnComputePool(F&& f, TaskPriority priority = TaskPriority::DefaultYield) {
+	using R = std::invoke_result_t<F&>;
+	using T = std::conditional_t<std::is_void_v<R>, Void, std::decay_t<R>>;
+	ASSERT(g_network->isOnMainThread());
+
+	auto task = std::make_unique<TypedComputeTask<T, F>>(std::forward<F>(f), priority);
+	Future<T> result = task->result.getFuture();
+	if (postComputeTask(task.get())) {
+		task.release();
+	} else {
+		(*task)();
+	}
+	return result;
+}
+
+#endif
@@ -133,6 +133,7 @@ private:
 		void* freelist;
 		int count; // there are count items on freelist
 		void* alternate; // alternate is either a full magazine, or an empty one
+		int node; // NUMA node of the thread when it first allocated, whose global pool it exchanges magazines with
 		ThreadData();
 		~ThreadData();
 	};
@@ -169,9 +170,11 @@ private:
 
 	static void getMagazine();
 	static void releaseMagazine(void*);
+	static void* formatMagazine(void** block);
 };
 
 extern std::atomic<int64_t> g_hugeArenaMemory;
+extern std::atomic<int64_t> g_arenaBlockCacheMisses; // Arena blocks of 512 to 8192 bytes not found in the block cache
 void hugeArenaSample(int size);
 void releaseAllThreadMagazines();
 int64_t getTotalUnusedAllocatedMemory();
@@ -0,0 +1,128 @@
+/*
+ * HdrHistogram.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_HDR_HISTOGRAM_H
+#define FLOW_HDR_HISTOGRAM_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "flow/Arena.h"
+#include "flow/Platform.h"
+
+/*
+ * A histogram of unsigned 64 bit values with log-linear buckets, in the style of HdrHistogram
+ * (http://hdrhistogram.org). Each power of two is split into 2^(significantBits - 1) equal buckets, so the value
+ * reported for a bucket is within a relative error of 2^-significantBits of every value recorded in it.
+ *
+ * The bucket array is sized once in the constructor, and finding a value's bucket is a count of leading zeros and two
+ * shifts, so record() is cheap enough for hot paths. A histogram has no locks or atomics; each thread records into its
+ * own and they are combined with merge(). Histograms with the same precision merge exactly, so the histograms of many
+ * processes can be combined into one with toString() and fromString().
+ */
+class HdrHistogram {
+public:
+	static constexpr int minSignificantBits = 1;
+	static constexpr int maxSignificantBits = 12;
+
+	explicit HdrHistogram(int significantBits = 7);
+
+	// The fewest significant bits which keep the relative error of reported values within relativeAccuracy
+	static int significantBitsFor(double relativeAccuracy);
+
+	void record(uint64_t value) {
+		++counts[bucketIndex(value)];
+		++totalCount;
+		sum += value;
+		minValue = std::min(minValue, value);
+		maxValue = std::max(maxValue, value);
+	}
+
+	void record(uint64_t value, uint32_t count);
+
+	// Adds the values recorded by other to this histogram. If the precisions differ, each bucket of other is recorded
+	// as its midpoint.
+	void merge(const HdrHistogram& other);
+
+	void clear();
+
+	int getSignificantBits() const { return significantBits; }
+	uint64_t count() const { return totalCount; }
+	uint64_t min() const { return totalCount ? minValue : 0; }
+	uint64_t max() const { return maxValue; }
+	uint64_t getSum() const { return sum; }
+	double mean() const { return totalCount ? static_cast<double>(sum) / totalCount : 0; }
+
+	// The value below which the given fraction of the recorded values fall, or 0 if nothing has been recorded
+	uint64_t percentile(double fraction) const;
+
+	// Calls f(lowest, highest, count) for each non-empty bucket, in increasing order
+	template <class F>
+	void forEachBucket(F&& f) const {
+		for (int i = 0; i < counts.size(); ++i) {
+			if (counts[i]) {
+				f(bucketLowest(i), bucketHighest(i), counts[i]);
+			}
+		}
+	}
+
+	// A compact encoding of the histogram, holding only its non-empty buckets
+	std::string toString() const;
+
+	// Decodes the output of toString(), throwing an error if it is malformed
+	static HdrHistogram fromString(StringRef encoded);
+
+private:
+	int significantBits;
+	// The counts are 32 bits to halve the size of the array. Histograms are cleared each time they are logged, so a
+	// bucket would need billions of values between logs to overflow.
+	std::vector<uint32_t> counts;
+	uint64_t totalCount;
+	uint64_t sum;
+	uint64_t minValue;
+	uint64_t maxValue;
+
+	static int bucketCount(int significantBits) { return (66 - significantBits) << (significantBits - 1); }
+
+	int bucketIndex(uint64_t value) const {
+		// Values below 2^significantBits have a bucket each, and larger values drop one low bit per power of two.
+		// Or'ing in the mask keeps clzll() defined for zero and makes the shift zero for small values.
+		int shift = 63 - clzll(value | ((uint64_t(1) << significantBits) - 1)) - (significantBits - 1);
+		return (shift << (significantBits - 1)) + static_cast<int>(value >> shift);
+	}
+
+	int bucketShift(int index) const { return std::max((index >> (significantBits - 1)) - 1, 0); }
+	uint64_t bucketLowest(int index) const {
+		int shift = bucketShift(index);
+		return static_cast<uint64_t>(index - (shift << (significantBits - 1))) << shift;
+	}
+	uint64_t bucketHighest(int index) const {
+		return bucketLowest(index) + ((uint64_t(1) << bucketShift(index)) - 1);
+	}
+	uint64_t bucketMidpoint(int index) const {
+		return bucketLowest(index) + ((uint64_t(1) << bucketShift(index)) >> 1);
+	}
+};
+
+#endif // FLOW_HDR_HISTOGRAM_H
@@ -131,8 +131,10 @@ public:
 
 	double FAST_ALLOC_LOGGING_BYTES;
 	bool FAST_ALLOC_ALLOW_GUARD_PAGES;
+	bool FAST_ALLOC_HUGE_PAGE_SLABS;
 	double HUGE_ARENA_LOGGING_BYTES;
 	double HUGE_ARENA_LOGGING_INTERVAL;
+	int64_t ARENA_BLOCK_CACHE_BYTES;
 	// This setting allows to let the fdbserver abort instead of exit to generate coredumps
 	// in case of a failure.
 	bool ABORT_ON_FAILURE;
@@ -156,6 +158,7 @@ public:
 	int STATSD_UDP_EMISSION_PORT;
 	int OTEL_UDP_EMISSION_PORT;
 	bool METRICS_EMIT_DDSKETCH;
+	bool LATENCY_SAMPLE_TRACE_HISTOGRAM;
 
 	// run loop profiling
 	double RUN_LOOP_PROFILING_INTERVAL;
@@ -166,6 +169,9 @@ public:
 	double SATURATION_PROFILING_LOG_INTERVAL;
 	double SATURATION_PROFILING_MAX_LOG_INTERVAL;
 	double SATURATION_PROFILING_LOG_BACKOFF;
+	int ACTOR_SAMPLER_HZ;
+	double ACTOR_SAMPLER_DRAIN_INTERVAL;
+	int ACTOR_SAMPLER_MAX_STACKS;
 
 	// connectionMonitor
 	double CONNECTION_MONITOR_LOOP_TIME;
@@ -198,6 +204,11 @@ public:
 	int TLS_HANDSHAKE_THREAD_STACKSIZE;
 	int TLS_MALLOC_ARENA_MAX;
 	int TLS_HANDSHAKE_LIMIT;
+	bool TLS_SESSION_RESUMPTION;
+	int TLS_SESSION_TIMEOUT;
+	int TLS_SESSION_CACHE_SIZE;
+
+	int COMPUTE_POOL_THREADS;
 
 	int NETWORK_TEST_CLIENT_COUNT;
 	int NETWORK_TEST_REPLY_SIZE;
@@ -275,6 +286,10 @@ public:
 	// Net2
 	double MIN_COALESCE_DELAY;
 	double MAX_COALESCE_DELAY;
+	double MAX_ADAPTIVE_COALESCE_DELAY;
+	int COALESCE_TARGET_PACKETS;
+	int COALESCE_MIN_PACKETS;
+	double COALESCE_RATE_WINDOW;
 	double SLOW_LOOP_CUTOFF;
 	double SLOW_LOOP_SAMPLING_RATE;
 	int64_t TSC_YIELD_TIME;
@@ -294,6 +309,8 @@ public:
 	int FLOW_TCP_NODELAY;
 	int FLOW_TCP_QUICKACK;
 	bool RESOLVE_PREFER_IPV4_ADDR;
+	int PEER_CONNECTION_LANES;
+	int BULK_ENDPOINT_PRIORITY;
 
 	// Sim2
 	// FIMXE: more parameters could be factored out
@@ -319,6 +336,7 @@ public:
 	int MAX_TRACE_SUPPRESSIONS;
 	bool TRACE_DATETIME_ENABLED;
 	int TRACE_SYNC_ENABLED;
+	int TRACE_WRITE_BATCH_BYTES;
 	int TRACE_EVENT_METRIC_UNITS_PER_SAMPLE;
 	int TRACE_EVENT_THROTTLER_SAMPLE_EXPIRY;
 	int TRACE_EVENT_THROTTLER_MSG_LIMIT;
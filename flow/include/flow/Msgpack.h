@@ -102,8 +102,11 @@ inline void serialize_string(const uint8_t* c, int length, MsgpackBuffer& buf) {
 		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[1]);
 		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[0]);
 	} else {
-		TraceEvent(SevWarn, "MsgpackSerializeString").detail("Failed to MessagePack encode very large string", length);
-		ASSERT_WE_THINK(false);
+		buf.write_byte(0xdb);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[3]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[2]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[1]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&length)[0]);
 	}
 
 	buf.write_bytes(c, length);
@@ -138,16 +141,29 @@ inline void serialize_vector(const std::vector<T>& vec, MsgpackBuffer& buf, F f)
 	}
 }
 
-template <class Map>
-inline void serialize_map(const Map& map, MsgpackBuffer& buf) {
-	int size = map.size();
-
+// Writes the header of a map with size key-value pairs, which the caller must write next
+inline void serialize_map_header(size_t size, MsgpackBuffer& buf) {
 	if (size <= 15) {
 		buf.write_byte(static_cast<uint8_t>(size) | 0b10000000);
+	} else if (size <= 65535) {
+		buf.write_byte(0xde);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[1]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[0]);
+	} else if (size <= std::numeric_limits<uint32_t>::max()) {
+		buf.write_byte(0xdf);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[3]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[2]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[1]);
+		buf.write_byte(reinterpret_cast<const uint8_t*>(&size)[0]);
 	} else {
 		TraceEvent(SevWarn, "MsgPackSerializeMap").detail("Failed to MessagePack encode large map", size);
 		ASSERT_WE_THINK(false);
 	}
+}
+
+template <class Map>
+inline void serialize_map(const Map& map, MsgpackBuffer& buf) {
+	serialize_map_header(map.size(), buf);
 
 	for (const auto& [key, value] : map) {
 		serialize_string(key.begin(), key.size(), buf);
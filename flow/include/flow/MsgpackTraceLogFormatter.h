@@ -0,0 +1,52 @@
+/*
+ * MsgpackTraceLogFormatter.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_MSGPACK_TRACE_LOG_FORMATTER_H
+#define FLOW_MSGPACK_TRACE_LOG_FORMATTER_H
+#pragma once
+
+#include "flow/FastRef.h"
+#include "flow/Msgpack.h"
+#include "flow/Trace.h"
+
+// Writes each event as a msgpack map from field name to value, with no header or footer, so a file is just a sequence
+// of maps. This is more compact than XML or JSON and needs no escaping, which keeps the trace log writer thread ahead
+// of a storm of events. Use traceconvert to turn the files back into XML or JSON.
+struct MsgpackTraceLogFormatter final : public ITraceLogFormatter, ReferenceCounted<MsgpackTraceLogFormatter> {
+	MsgpackTraceLogFormatter();
+
+	const char* getExtension() const override;
+	const char* getHeader() const override; // Called when starting a new file
+	const char* getFooter() const override; // Called when ending a file
+	std::string formatEvent(const TraceEventFields&) const override; // Called for each event
+
+	void addref() override;
+	void delref() override;
+
+private:
+	// Events are only formatted by the trace log writer thread, so one buffer is reused for all of them
+	mutable MsgpackBuffer buffer;
+};
+
+// Decodes the event at the start of data written by MsgpackTraceLogFormatter and advances data past it. Returns false
+// if data is empty, and throws file_corrupt if the event is malformed or truncated.
+bool decodeMsgpackTraceEvent(StringRef& data, TraceEventFields& fields);
+
+#endif
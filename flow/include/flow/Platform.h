@@ -840,6 +840,40 @@ EXTERNC void setProfilingEnabled(int enabled);
 #error Clean builds must define NDEBUG, and not define various debug macros
 #endif
 
+#ifdef __cplusplus
+#include <atomic>
+
+// The names of the actors whose code is running on this thread, outermost first. It is maintained by the actor probes
+// below and read by the actor sampler (flow/ActorSampler.h) from a signal handler, which may interrupt a push or pop.
+struct ActorNameStack {
+	static constexpr int maxDepth = 16;
+	const char* names[maxDepth];
+	int depth; // May exceed maxDepth, in which case only the outermost maxDepth names are kept
+};
+extern thread_local ActorNameStack g_actorNameStack;
+
+inline void pushActorName(const char* name) {
+	ActorNameStack& stack = g_actorNameStack;
+	if (stack.depth < ActorNameStack::maxDepth) {
+		stack.names[stack.depth] = name;
+	}
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	++stack.depth;
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline void popActorName() {
+	ActorNameStack& stack = g_actorNameStack;
+	if (stack.depth > 0) {
+		--stack.depth;
+	}
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+#else
+#define pushActorName(name)
+#define popActorName()
+#endif
+
 // DTrace probing
 #if defined(DTRACE_PROBES)
 #include <sys/sdt.h>
@@ -873,8 +907,12 @@ extern void fdb_probe_actor_exit(const char* name, unsigned long, int index);
 #define FDB_TRACE_PROBE(...)
 inline void fdb_probe_actor_create(const char* name, unsigned long id) {}
 inline void fdb_probe_actor_destroy(const char* name, unsigned long id) {}
-inline void fdb_probe_actor_enter(const char* name, unsigned long id, int index) {}
-inline void fdb_probe_actor_exit(const char* name, unsigned long id, int index) {}
+inline void fdb_probe_actor_enter(const char* name, unsigned long id, int index) {
+	pushActorName(name);
+}
+inline void fdb_probe_actor_exit(const char* name, unsigned long id, int index) {
+	popActorName();
+}
 #endif
 
 #if defined(__aarch64__)
@@ -93,6 +93,10 @@ struct NetworkData {
 	int64_t countConnClosedWithError;
 	int64_t countConnClosedWithoutError;
 	int64_t countTLSPolicyFailures;
+	int64_t countTLSHandshakes;
+	int64_t countTLSResumedHandshakes;
+	int64_t tlsBytesEncrypted;
+	int64_t tlsBytesDecrypted;
 	double countLaunchTime;
 	double countReactTime;
 
@@ -121,6 +125,10 @@ struct NetworkData {
 		countConnClosedWithError = Int64Metric::getValueOrDefault("Net2.CountConnClosedWithError"_sr);
 		countConnClosedWithoutError = Int64Metric::getValueOrDefault("Net2.CountConnClosedWithoutError"_sr);
 		countTLSPolicyFailures = Int64Metric::getValueOrDefault("Net2.CountTLSPolicyFailures"_sr);
+		countTLSHandshakes = Int64Metric::getValueOrDefault("Net2.CountTLSHandshakes"_sr);
+		countTLSResumedHandshakes = Int64Metric::getValueOrDefault("Net2.CountTLSResumedHandshakes"_sr);
+		tlsBytesEncrypted = Int64Metric::getValueOrDefault("Net2.TLSBytesEncrypted"_sr);
+		tlsBytesDecrypted = Int64Metric::getValueOrDefault("Net2.TLSBytesDecrypted"_sr);
 		countLaunchTime = DoubleMetric::getValueOrDefault("Net2.CountLaunchTime"_sr);
 		countReactTime = DoubleMetric::getValueOrDefault("Net2.CountReactTime"_sr);
 		countFileLogicalWrites = Int64Metric::getValueOrDefault("AsyncFile.CountLogicalWrites"_sr);
@@ -401,7 +401,18 @@ constexpr bool expect_serialize_member =
 template <class T>
 constexpr bool use_indirection = !(is_scalar<T> || is_struct_like<T>);
 
-using VTable = std::vector<uint16_t>;
+// A view of a vtable laid out at compile time by generate_vtable. The backing
+// storage is a constexpr array shared by every message type with the same
+// member sizes and alignments.
+struct VTable {
+	const uint16_t* data;
+	size_t length;
+
+	constexpr const uint16_t* begin() const { return data; }
+	constexpr const uint16_t* end() const { return data + length; }
+	constexpr size_t size() const { return length; }
+	constexpr const uint16_t& operator[](size_t i) const { return data[i]; }
+};
 
 template <class T>
 constexpr int fb_scalar_size = is_scalar<T> ? scalar_traits<T>::size : sizeof(RelativeOffset);
@@ -489,6 +500,27 @@ template <class T>
 constexpr int fb_align =
     is_struct_like<T> ? align_helper(typename struct_like_traits<T>::types{}) : AlignToPowerOfTwo(fb_scalar_size<T>);
 
+// True if saving a T writes nothing outside of the slot in its parent, i.e. T
+// is a scalar or a struct made only of such members.
+template <class T>
+constexpr bool is_inline_only();
+
+template <class... Ts>
+constexpr bool is_inline_only_pack(pack<Ts...>) {
+	return (is_inline_only<Ts>() && ...);
+}
+
+template <class T>
+constexpr bool is_inline_only() {
+	if constexpr (is_scalar<T>) {
+		return true;
+	} else if constexpr (is_struct_like<T>) {
+		return is_inline_only_pack(typename struct_like_traits<T>::types{});
+	} else {
+		return false;
+	}
+}
+
 template <class T>
 struct _SizeOf {
 	static constexpr unsigned int size = fb_size<T>;
@@ -500,6 +532,7 @@ void swapWithThreadLocalGlobal(std::vector<int>& writeToOffsets);
 
 template <class Context>
 struct PrecomputeSize : Context {
+	static constexpr bool isPrecomputeSize = true;
 	PrecomputeSize(const Context& context) : Context(context) {
 		swapWithThreadLocalGlobal(writeToOffsets);
 		writeToOffsets.clear();
@@ -564,6 +597,7 @@ struct is_array<std::array<T, size>> : std::true_type {};
 
 template <class Context>
 struct WriteToBuffer : Context {
+	static constexpr bool isPrecomputeSize = false;
 	// |offset| is measured from the end of the buffer. Precondition: len <=
 	// offset.
 	void write(const void* src, int offset, int len) {
@@ -659,24 +693,63 @@ using Fields = decltype(fields_helper<Member>());
 // It's important that get_vtable always returns the same VTable pointer
 // so that we can decide equality by comparing the pointers.
 
-// First |numMembers| elements of sizesAndAlignments are sizes, the second
-// |numMembers| elements are alignments.
-extern VTable generate_vtable(size_t numMembers, const std::vector<unsigned>& sizesAndAlignments);
+// First |NumMembers| elements of sizesAndAlignments are sizes, the second
+// |NumMembers| elements are alignments. Members are placed in order of
+// decreasing size (ties keep declaration order), and zero sized members get no
+// slot.
+template <size_t NumMembers>
+constexpr std::array<uint16_t, NumMembers + 2> generate_vtable(
+    const std::array<unsigned, 2 * NumMembers>& sizesAndAlignments) {
+	// Indexes of the members with a nonzero size, stable sorted by size
+	std::array<unsigned, NumMembers> indexed{};
+	size_t numIndexed = 0;
+	for (unsigned i = 0; i < NumMembers; ++i) {
+		if (sizesAndAlignments[i] > 0) {
+			size_t j = numIndexed++;
+			for (; j > 0 && sizesAndAlignments[indexed[j - 1]] < sizesAndAlignments[i]; --j) {
+				indexed[j] = indexed[j - 1];
+			}
+			indexed[j] = i;
+		}
+	}
+	std::array<uint16_t, NumMembers + 2> result{};
+	// size of the vtable is
+	// - 2 bytes per member +
+	// - 2 bytes for the size entry +
+	// - 2 bytes for the size of the object
+	result[0] = static_cast<uint16_t>(2 * NumMembers + 4);
+	unsigned offset = 0;
+	for (size_t k = 0; k < numIndexed; ++k) {
+		unsigned i = indexed[k];
+		unsigned align = sizesAndAlignments[NumMembers + i];
+		unsigned res = offset % align == 0 ? offset : ((offset / align) + 1) * align;
+		offset = res + sizesAndAlignments[i];
+		result[i + 2] = static_cast<uint16_t>(res + 4);
+	}
+	result[1] = static_cast<uint16_t>(offset + 4);
+	return result;
+}
+
+template <unsigned... MembersAndAlignments>
+struct VTableFor {
+	static constexpr size_t numMembers = sizeof...(MembersAndAlignments) / 2;
+	static constexpr std::array<uint16_t, numMembers + 2> table =
+	    generate_vtable<numMembers>(std::array<unsigned, 2 * numMembers>{ MembersAndAlignments... });
+	static constexpr VTable vtable{ table.data(), table.size() };
+};
 
 template <unsigned... MembersAndAlignments>
-const VTable* gen_vtable3() {
-	static thread_local VTable table =
-	    generate_vtable(sizeof...(MembersAndAlignments) / 2, std::vector<unsigned>{ MembersAndAlignments... });
-	return &table;
+constexpr const VTable* gen_vtable3() {
+	return &VTableFor<MembersAndAlignments...>::vtable;
 }
 
 template <class... Members>
-const VTable* gen_vtable2(pack<Members...> p) {
+constexpr const VTable* gen_vtable2(pack<Members...> p) {
 	return gen_vtable3<_SizeOf<Members>::size..., _SizeOf<Members>::align...>();
 }
 
 template <class... Members>
-const VTable* get_vtable() {
+constexpr const VTable* get_vtable() {
 	return gen_vtable2(concat_t<Fields<Members>...>{});
 }
 
@@ -762,7 +835,7 @@ struct InsertVTableLambda : Context {
 
 template <class T>
 int vec_bytes(const T& begin, const T& end) {
-	return sizeof(typename T::value_type) * (end - begin);
+	return sizeof(typename std::iterator_traits<T>::value_type) * (end - begin);
 }
 
 template <class Root, class Context>
@@ -1214,11 +1287,15 @@ struct LoadSaveHelper : Context {
 		}
 		uint32_t len = num_entries * size;
 		auto self = writer.getMessageWriter(len);
-		auto iter = VectorTraits::begin(members, this->context());
-		for (uint32_t i = 0; i < num_entries; ++i) {
-			auto result = save_helper(*iter, writer, vtables, this->context());
-			self.write(&result, i * size, size);
-			++iter;
+		// Elements stored entirely inline don't move the end of the buffer, so
+		// the size pass doesn't need to visit them.
+		if constexpr (!(Writer::isPrecomputeSize && is_inline_only<T>())) {
+			auto iter = VectorTraits::begin(members, this->context());
+			for (uint32_t i = 0; i < num_entries; ++i) {
+				auto result = save_helper(*iter, writer, vtables, this->context());
+				self.write(&result, i * size, size);
+				++iter;
+			}
 		}
 		int padding = 0;
 		int start =
@@ -0,0 +1,99 @@
+/*
+ * BenchLocationCache.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/FlatKeyRangeMap.h"
+#include "fdbclient/KeyRangeMap.h"
+
+// Compares the map used for the client's location cache (FlatKeyRangeMap) with CoalescedKeyRangeMap, which it
+// replaced, on the operations the client performs: lookups on every read, and inserts and invalidations when
+// locations are fetched or found to be stale.
+
+static Key shardKey(int i) {
+	return Key(format("%010d", i));
+}
+
+// Builds a cache with one range per shard and a different value for each, so that no ranges are coalesced
+template <class Map>
+static void populate(Map& map, int shards) {
+	for (int i = 0; i < shards; ++i) {
+		map.insert(KeyRangeRef(shardKey(i), shardKey(i + 1)), i + 1);
+	}
+}
+
+template <class Map>
+static void bench_location_cache_lookup(benchmark::State& state) {
+	int shards = state.range(0);
+	Map map(0, allKeys.end);
+	populate(map, shards);
+
+	std::vector<Key> keys;
+	for (int i = 0; i < 1000; ++i) {
+		keys.push_back(shardKey(deterministicRandom()->randomInt(0, shards)).withSuffix("/key"_sr));
+	}
+
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.rangeContaining(keys[i++ % keys.size()]).value());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Invalidates the location of one shard and then caches it again, as happens when a shard moves
+template <class Map>
+static void bench_location_cache_update(benchmark::State& state) {
+	int shards = state.range(0);
+	Map map(0, allKeys.end);
+	populate(map, shards);
+
+	for (auto _ : state) {
+		int shard = deterministicRandom()->randomInt(0, shards);
+		KeyRange keys = KeyRangeRef(shardKey(shard), shardKey(shard + 1));
+		map.insert(keys, 0);
+		map.insert(keys, shard + 1);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_location_cache_populate_flat(benchmark::State& state) {
+	for (auto _ : state) {
+		FlatKeyRangeMap<int> map(0, allKeys.end);
+		populate(map, state.range(0));
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.range(0) * static_cast<long>(state.iterations()));
+}
+
+static void bench_location_cache_populate_coalesced(benchmark::State& state) {
+	for (auto _ : state) {
+		CoalescedKeyRangeMap<int> map(0, allKeys.end);
+		populate(map, state.range(0));
+		benchmark::DoNotOptimize(map.size());
+	}
+	state.SetItemsProcessed(state.range(0) * static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_location_cache_lookup, FlatKeyRangeMap<int>)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK_TEMPLATE(bench_location_cache_lookup, CoalescedKeyRangeMap<int>)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK_TEMPLATE(bench_location_cache_update, FlatKeyRangeMap<int>)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK_TEMPLATE(bench_location_cache_update, CoalescedKeyRangeMap<int>)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK(bench_location_cache_populate_flat)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_location_cache_populate_coalesced)->Arg(1000000)->Unit(benchmark::kMillisecond);
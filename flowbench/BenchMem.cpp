@@ -19,9 +19,13 @@
  */
 
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "benchmark/benchmark.h"
+#include "flow/FastAlloc.h"
 
 static void bench_memcmp(benchmark::State& state) {
 	constexpr int kLength = 10000;
@@ -47,5 +51,70 @@ static void bench_memcpy(benchmark::State& state) {
 	}
 }
 
+// Allocates and frees on the same thread, which never leaves the thread's own magazines
+template <int Size>
+static void bench_fast_alloc(benchmark::State& state) {
+	constexpr int kBatch = 1024;
+	std::vector<void*> batch;
+	batch.reserve(kBatch);
+
+	for (auto _ : state) {
+		for (int i = 0; i < kBatch; i++) {
+			batch.push_back(FastAllocator<Size>::allocate());
+		}
+		for (void* p : batch) {
+			FastAllocator<Size>::release(p);
+		}
+		batch.clear();
+	}
+	state.SetItemsProcessed(kBatch * state.iterations());
+}
+
+// Each thread allocates batches and frees batches allocated by the other threads, so that memory keeps moving between
+// threads through the global magazine pools, as it does between the network thread and client or KAIO threads.
+template <int Size>
+static void bench_fast_alloc_cross_thread(benchmark::State& state) {
+	constexpr int kBatch = 1024;
+	static std::mutex mutex;
+	static std::deque<std::vector<void*>> exchange;
+
+	auto drain = [](std::vector<void*>& batch) {
+		for (void* p : batch) {
+			FastAllocator<Size>::release(p);
+		}
+	};
+
+	for (auto _ : state) {
+		std::vector<void*> batch;
+		batch.reserve(kBatch);
+		for (int i = 0; i < kBatch; i++) {
+			batch.push_back(FastAllocator<Size>::allocate());
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			exchange.push_back(std::move(batch));
+			// The batch pushed before this one, which with more than one thread was usually allocated by another
+			batch = std::move(exchange.front());
+			exchange.pop_front();
+			if (exchange.empty()) {
+				exchange.push_back(std::move(batch));
+				batch.clear();
+			}
+		}
+		drain(batch);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& batch : exchange) {
+		drain(batch);
+	}
+	exchange.clear();
+	state.SetItemsProcessed(kBatch * state.iterations());
+}
+
 BENCHMARK(bench_memcmp);
 BENCHMARK(bench_memcpy);
+BENCHMARK_TEMPLATE(bench_fast_alloc, 64)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_fast_alloc, 4096)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_fast_alloc_cross_thread, 64)->ThreadRange(1, 16)->UseRealTime()->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_fast_alloc_cross_thread, 4096)->ThreadRange(1, 16)->UseRealTime()->ReportAggregatesOnly(true);
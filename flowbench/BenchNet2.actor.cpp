@@ -20,8 +20,11 @@
 
 #include "benchmark/benchmark.h"
 
+#include "fdbclient/IKnobCollection.h"
+#include "flow/IConnection.h"
 #include "flow/IRandom.h"
 #include "flow/flow.h"
+#include "flow/ActorCollection.h"
 #include "flow/DeterministicRandom.h"
 #include "flow/network.h"
 #include "flow/ThreadHelper.actor.h"
@@ -91,3 +94,122 @@ static void bench_delay(benchmark::State& benchState) {
 
 BENCHMARK_TEMPLATE(bench_delay, DELAY)->Range(0, 1 << 16)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_delay, YIELD)->Range(0, 1 << 16)->ReportAggregatesOnly(true);
+
+// The TLS benchmarks connect to a listener in the same process, over the loopback interface. flowbench configures TLS
+// with a throwaway certificate chain, which both sides present.
+
+ACTOR static Future<Void> sendAll(Reference<IConnection> conn, SendBuffer* buffer) {
+	loop {
+		buffer->bytes_sent += conn->write(buffer, buffer->bytes_unsent());
+		if (buffer->bytes_unsent() == 0) {
+			return Void();
+		}
+		wait(conn->onWritable());
+	}
+}
+
+ACTOR static Future<Void> receiveAll(Reference<IConnection> conn, int64_t bytes) {
+	state std::unique_ptr<uint8_t[]> buffer(new uint8_t[1 << 16]);
+	loop {
+		while (bytes > 0) {
+			int received = conn->read(buffer.get(), buffer.get() + std::min<int64_t>(bytes, 1 << 16));
+			if (received == 0) {
+				break;
+			}
+			bytes -= received;
+		}
+		if (bytes <= 0) {
+			return Void();
+		}
+		wait(conn->onReadable());
+	}
+}
+
+// Completes the handshake, sends one byte, and then discards everything it receives until the connection is closed
+ACTOR static Future<Void> tlsSink(Reference<IConnection> conn) {
+	state PacketBuffer* hello = PacketBuffer::create();
+	try {
+		wait(conn->acceptHandshake());
+		hello->bytes_written = 1;
+		wait(sendAll(conn, hello));
+		wait(receiveAll(conn, std::numeric_limits<int64_t>::max()));
+	} catch (Error& e) {
+		hello->delref();
+		conn->close();
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+	}
+	return Void();
+}
+
+ACTOR static Future<Void> tlsAcceptor(Reference<IListener> listener) {
+	state ActorCollection sinks(false);
+	loop {
+		Reference<IConnection> conn = wait(listener->accept());
+		sinks.add(tlsSink(conn));
+	}
+}
+
+// Opens a TLS connection to the listener and waits for the byte it sends. Reading also processes the session tickets
+// which TLS 1.3 servers send after the handshake.
+ACTOR static Future<Reference<IConnection>> tlsConnect(NetworkAddress address) {
+	state Reference<IConnection> conn = wait(INetworkConnections::net()->connect(address));
+	wait(conn->connectHandshake());
+	wait(receiveAll(conn, 1));
+	return conn;
+}
+
+static NetworkAddress tlsListenAddress() {
+	return NetworkAddress(IPAddress(0x7f000001), 0, true, true);
+}
+
+ACTOR template <bool resume>
+static Future<Void> benchTLSHandshake(benchmark::State* benchState) {
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("tls_session_resumption",
+	                                                          KnobValueRef::create(bool{ resume }));
+	state Reference<IListener> listener = INetworkConnections::net()->listen(tlsListenAddress());
+	state Future<Void> acceptor = tlsAcceptor(listener);
+	while (benchState->KeepRunning()) {
+		Reference<IConnection> conn = wait(tlsConnect(listener->getListenAddress()));
+		conn->close();
+	}
+	benchState->SetItemsProcessed(static_cast<long>(benchState->iterations()));
+	return Void();
+}
+
+template <bool resume>
+static void bench_tls_handshake(benchmark::State& benchState) {
+	onMainThread([&benchState] { return benchTLSHandshake<resume>(&benchState); }).blockUntilReady();
+}
+
+static constexpr bool FULL_HANDSHAKE = false;
+static constexpr bool RESUMED_HANDSHAKE = true;
+
+BENCHMARK_TEMPLATE(bench_tls_handshake, FULL_HANDSHAKE)->UseRealTime()->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_tls_handshake, RESUMED_HANDSHAKE)->UseRealTime()->ReportAggregatesOnly(true);
+
+// Both ends of the connection are in this process, so each byte is encrypted and decrypted once per iteration
+ACTOR static Future<Void> benchTLSStream(benchmark::State* benchState) {
+	state int64_t size = benchState->range(0);
+	state Reference<IListener> listener = INetworkConnections::net()->listen(tlsListenAddress());
+	state Future<Void> acceptor = tlsAcceptor(listener);
+	state Reference<IConnection> conn = wait(tlsConnect(listener->getListenAddress()));
+	state PacketBuffer* buffer = PacketBuffer::create(size);
+	memset(buffer->data(), 0, size);
+	buffer->bytes_written = size;
+	while (benchState->KeepRunning()) {
+		buffer->bytes_sent = 0;
+		wait(sendAll(conn, buffer));
+	}
+	buffer->delref();
+	conn->close();
+	benchState->SetBytesProcessed(size * static_cast<long>(benchState->iterations()));
+	return Void();
+}
+
+static void bench_tls_stream(benchmark::State& benchState) {
+	onMainThread([&benchState] { return benchTLSStream(&benchState); }).blockUntilReady();
+}
+
+BENCHMARK(bench_tls_stream)->Range(1 << 10, 1 << 20)->UseRealTime()->ReportAggregatesOnly(true);
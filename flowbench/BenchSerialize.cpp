@@ -0,0 +1,144 @@
+/*
+ * BenchSerialize.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/StorageServerInterface.h"
+#include "flow/Arena.h"
+#include "flow/ObjectSerializer.h"
+#include "flow/ProtocolVersion.h"
+
+// Flatbuffers round trips of the messages that dominate serialization time in a loaded cluster. Each benchmark takes
+// the number of entries (mutations, key-value pairs, or 16 byte messages) as its argument.
+
+namespace {
+
+// The body of a CommitTransactionRequest. The request itself also carries a ReplyPromise, which can only be serialized
+// on the network thread.
+struct CommitBody {
+	constexpr static FileIdentifier file_identifier = 2393187;
+	Arena arena;
+	SpanContext spanContext;
+	CommitTransactionRef transaction;
+	uint32_t flags = 0;
+	Optional<UID> debugID;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, transaction, flags, debugID, spanContext, arena);
+	}
+};
+
+// Same members as TLogPeekReply (fdbserver/TLogInterface.h), which flowbench doesn't link against.
+struct PeekReply {
+	constexpr static FileIdentifier file_identifier = 11365690;
+	Arena arena;
+	StringRef messages;
+	Version end;
+	Optional<Version> popped;
+	Version maxKnownVersion;
+	Version minKnownCommittedVersion;
+	Optional<Version> begin;
+	bool onlySpilled = false;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, messages, end, popped, maxKnownVersion, minKnownCommittedVersion, begin, onlySpilled, arena);
+	}
+};
+
+KeyRef benchKey(Arena& arena, int i) {
+	return StringRef(arena, format("/bench/serialize/%08d", i));
+}
+
+CommitBody makeCommit(int mutations) {
+	CommitBody req;
+	req.spanContext = SpanContext(deterministicRandom()->randomUniqueID(), deterministicRandom()->randomUInt64());
+	auto& tr = req.transaction;
+	tr.read_snapshot = 100000;
+	for (int i = 0; i < mutations; ++i) {
+		KeyRef key = benchKey(req.arena, i);
+		ValueRef value = makeString(100, req.arena);
+		tr.mutations.push_back(req.arena, MutationRef(MutationRef::SetValue, key, value));
+		tr.write_conflict_ranges.push_back(req.arena, singleKeyRange(key, req.arena));
+		if (i % 4 == 0) {
+			tr.read_conflict_ranges.push_back(req.arena, singleKeyRange(key, req.arena));
+		}
+	}
+	return req;
+}
+
+GetKeyValuesReply makeGetRange(int rows) {
+	GetKeyValuesReply reply;
+	reply.version = 100000;
+	reply.more = true;
+	for (int i = 0; i < rows; ++i) {
+		reply.data.push_back(reply.arena, KeyValueRef(benchKey(reply.arena, i), makeString(100, reply.arena)));
+	}
+	return reply;
+}
+
+PeekReply makePeek(int messages) {
+	PeekReply reply;
+	reply.messages = makeString(messages * 16, reply.arena);
+	reply.end = 100000 + messages;
+	reply.popped = 100000;
+	reply.maxKnownVersion = reply.end;
+	reply.minKnownCommittedVersion = 100000;
+	reply.begin = 100000;
+	return reply;
+}
+
+template <class T, T (*Make)(int)>
+void bench_serialize(benchmark::State& state) {
+	T message = Make(state.range(0));
+	size_t size = 0;
+	for (auto _ : state) {
+		ObjectWriter writer(IncludeVersion());
+		writer.serialize(message);
+		size = writer.toStringRef().size();
+		benchmark::DoNotOptimize(writer.toStringRef().begin());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(static_cast<long>(state.iterations() * size));
+}
+
+template <class T, T (*Make)(int)>
+void bench_deserialize(benchmark::State& state) {
+	Standalone<StringRef> buffer = ObjectWriter::toValue(Make(state.range(0)), IncludeVersion());
+	for (auto _ : state) {
+		T message;
+		ArenaObjectReader reader(buffer.arena(), buffer, IncludeVersion());
+		reader.deserialize(message);
+		benchmark::DoNotOptimize(message);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(static_cast<long>(state.iterations() * buffer.size()));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bench_serialize, CommitBody, makeCommit)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize, CommitBody, makeCommit)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize, GetKeyValuesReply, makeGetRange)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize, GetKeyValuesReply, makeGetRange)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize, PeekReply, makePeek)->Range(1, 1 << 14)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize, PeekReply, makePeek)->Range(1, 1 << 14)->ReportAggregatesOnly(true);
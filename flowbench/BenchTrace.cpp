@@ -0,0 +1,84 @@
+/*
+ * BenchTrace.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "flow/Arena.h"
+#include "flow/JsonTraceLogFormatter.h"
+#include "flow/MsgpackTraceLogFormatter.h"
+#include "flow/Trace.h"
+#include "flow/XmlTraceLogFormatter.h"
+
+namespace {
+
+// Roughly the size and shape of the events a storage server logs while it is falling behind
+TraceEventFields makeEvent() {
+	TraceEventFields fields;
+	fields.addField("Severity", "20");
+	fields.addField("Time", "1700000000.123456");
+	fields.addField("DateTime", "2023-11-14T22:13:20Z");
+	fields.addField("Type", "StorageServerUpdateLag");
+	fields.addField("ID", "0123456789abcdef");
+	fields.addField("Version", "123456789012");
+	fields.addField("DurableVersion", "123456700000");
+	fields.addField("Key", "/bench/trace/\\x00\\x01<key>&\"quoted\"");
+	fields.addField("Elapsed", "0.523000");
+	fields.addField("ThreadID", "1234567890123456789");
+	fields.addField("Machine", "10.0.0.1:4500");
+	fields.addField("LogGroup", "default");
+	fields.addField("Roles", "SS");
+	return fields;
+}
+
+} // namespace
+
+// The work done by the trace log writer thread for each event
+template <class Formatter>
+static void bench_trace_format(benchmark::State& state) {
+	Formatter formatter;
+	TraceEventFields event = makeEvent();
+	size_t bytes = 0;
+	for (auto _ : state) {
+		std::string formatted = formatter.formatEvent(event);
+		bytes += formatted.size();
+		benchmark::DoNotOptimize(formatted);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(static_cast<long>(bytes));
+}
+
+// The work done by the thread which logs an event. The trace log isn't open in flowbench, so once the pre-open buffer
+// is full this is everything up to handing the event to the writer.
+static void bench_trace_event(benchmark::State& state) {
+	int64_t version = 123456789012;
+	for (auto _ : state) {
+		TraceEvent("BenchTraceEvent")
+		    .detail("Version", ++version)
+		    .detail("DurableVersion", version - 1000000)
+		    .detail("Key", "/bench/trace/key"_sr)
+		    .detail("Elapsed", 0.523);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_trace_format, XmlTraceLogFormatter)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_trace_format, JsonTraceLogFormatter)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_trace_format, MsgpackTraceLogFormatter)->ReportAggregatesOnly(true);
+BENCHMARK(bench_trace_event)->ReportAggregatesOnly(true);
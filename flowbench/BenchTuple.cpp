@@ -0,0 +1,106 @@
+/*
+ * BenchTuple.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/Tuple.h"
+#include "flowbench/GlobalData.h"
+
+// Keys of the shape (prefix, id, name), where one in eight names contains a zero byte that needs escaping
+static InputGenerator<std::pair<Standalone<StringRef>, int64_t>> getTupleInputs(int stringSize) {
+	return InputGenerator<std::pair<Standalone<StringRef>, int64_t>>(1000, [stringSize]() {
+		Standalone<StringRef> str = makeString(stringSize);
+		deterministicRandom()->randomBytes(mutateString(str), stringSize);
+		for (int i = 0; i < stringSize; i++) {
+			if (mutateString(str)[i] == 0) {
+				mutateString(str)[i] = 1;
+			}
+		}
+		if (stringSize > 0 && deterministicRandom()->randomInt(0, 8) == 0) {
+			mutateString(str)[deterministicRandom()->randomInt(0, stringSize)] = 0;
+		}
+		return std::make_pair(str, deterministicRandom()->randomInt64(0, std::numeric_limits<int64_t>::max()));
+	});
+}
+
+using KeySchema = TupleSchema<StringRef, int64_t, StringRef>;
+
+static void bench_tuple_pack(benchmark::State& state) {
+	auto inputs = getTupleInputs(state.range(0));
+	for (auto _ : state) {
+		auto const& [str, id] = inputs.next();
+		Tuple t = Tuple::makeTuple("prefix"_sr, id, str);
+		benchmark::DoNotOptimize(t.pack());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_tuple_schema_pack(benchmark::State& state) {
+	auto inputs = getTupleInputs(state.range(0));
+	for (auto _ : state) {
+		auto const& [str, id] = inputs.next();
+		benchmark::DoNotOptimize(KeySchema::pack("prefix"_sr, id, str));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_tuple_schema_pack_buffer(benchmark::State& state) {
+	auto inputs = getTupleInputs(state.range(0));
+	std::vector<uint8_t> buffer;
+	for (auto _ : state) {
+		auto const& [str, id] = inputs.next();
+		buffer.resize(std::max(buffer.size(), KeySchema::packedSize("prefix"_sr, id, str)));
+		benchmark::DoNotOptimize(KeySchema::pack(buffer.data(), "prefix"_sr, id, str));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static InputGenerator<Standalone<StringRef>> getPackedInputs(int stringSize) {
+	auto inputs = getTupleInputs(stringSize);
+	return InputGenerator<Standalone<StringRef>>(1000, [&inputs]() {
+		auto const& [str, id] = inputs.next();
+		return KeySchema::pack("prefix"_sr, id, str);
+	});
+}
+
+static void bench_tuple_unpack(benchmark::State& state) {
+	auto inputs = getPackedInputs(state.range(0));
+	for (auto _ : state) {
+		Tuple t = Tuple::unpack(inputs.next());
+		benchmark::DoNotOptimize(t.getInt(1));
+		benchmark::DoNotOptimize(t.getString(2));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_tuple_schema_unpack(benchmark::State& state) {
+	auto inputs = getPackedInputs(state.range(0));
+	for (auto _ : state) {
+		Arena arena;
+		benchmark::DoNotOptimize(KeySchema::unpack(inputs.next(), arena));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_tuple_pack)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_schema_pack)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_schema_pack_buffer)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_unpack)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_schema_unpack)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
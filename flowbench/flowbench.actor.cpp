@@ -21,6 +21,7 @@
 #include "benchmark/benchmark.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/ThreadSafeTransaction.h"
+#include "flow/MkCert.h"
 #include "flow/ThreadHelper.actor.h"
 #include <thread>
 
@@ -41,6 +42,12 @@ int main(int argc, char** argv) {
 	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
 		return 1;
 	}
+	// The TLS benchmarks connect to themselves, so one certificate chain serves both sides
+	Arena arena;
+	auto chain = mkcert::makeCertChain(arena, 2, mkcert::ESide::Server);
+	setNetworkOption(FDBNetworkOptions::TLS_CERT_BYTES, chain[0].certPem);
+	setNetworkOption(FDBNetworkOptions::TLS_KEY_BYTES, chain[0].privateKeyPem);
+	setNetworkOption(FDBNetworkOptions::TLS_CA_BYTES, chain.back().certPem);
 	setupNetwork();
 	Promise<Void> benchmarksDone;
 	std::thread benchmarkThread([&]() {